@@ -4,13 +4,33 @@
 
 #include "autopark.h"
 #include "pd_control.h"
+#include "pd_autotune.h"
+#include "pd_bench.h"
+#include "plan_bench.h"
+#include "wall_estimator.h"
+#include "gap_detector.h"
+#include "occupancy_profile.h"
+#include "path_planner.h"
+#include "path_tracker.h"
  
 #include "asclin0.h"
 #include "bluetooth.h"
+#include "log.h"
 #include "ultrasonic.h"
 #include "motor.h"
+#include "odometry.h"
+#include "overlay.h"
+#include "param_store.h"
+#include "recorder.h"
+#include "stm0.h"
+#include "systeminit.h"
+#include "trace.h"
 #include "util.h"
 
+#include "IfxScuCcu.h"
+#include "IfxStm.h"
+
+#include <stddef.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -20,8 +40,17 @@
 /*********************************************************************************************************************/
 
 #define MOTOR_STOP_DELAY 500
+#define FIND_SPACE_STOP_DELAY 50
+#define MANEUVER_TIMEOUT 30000      // 경로 끝에 도달하지 못해도 멈추는 시간 [ms]
+#define SPEED_TEST_DRIVE 2000       // 속도 시험 주행의 전진, 후진 시간 [ms]
+#define TRACK_LOOKAHEAD 80.0f       // pure pursuit 목표점 거리 [mm]
+#define REAR_STOP_SAMPLES 2         // 뒤쪽 거리가 연속으로 이만큼 가까워야 멈춘다 (튀는 echo 무시)
+#define AUTOTUNE_RELAY 60.0f        // 릴레이 실험의 MV 크기
+#define STEP_PERIOD_MS (CONTROL_PERIOD_US / 1000)     // autoparkStep 주기
+
+#define AUTOPARK_STOP_COMMAND 's'
 
-#define DEBUG_PRINTF(...) myPrintf(__VA_ARGS__)
+#define DEBUG_PRINTF(...) LOG_PRINTF(__VA_ARGS__)
 
 
 /*********************************************************************************************************************/
@@ -32,153 +61,481 @@
 /*--------------------------------------------Private Variables/Constants--------------------------------------------*/
 /*********************************************************************************************************************/
 
-static int g_parkingDistance = 200000;
-static int g_parkingSpeedForward = 300;
-static int g_parkingSpeedBackward = 300;
-static volatile int g_parkingFoundTick = 30;
-static int g_goForwardDelay = 0;
-static int g_rotateDelay = 480;
-static int g_stopDistance = 1000;
+/* 튜닝 변수를 모은 보정 페이지. 기본값은 플래시의 .calib 에 있고, autoparkInit() 이 CPU0 DSPR 의 작업 페이지로
+ * 복사한 뒤 data overlay 로 플래시 페이지를 덮는다. 읽기는 g_cal (플래시 주소, overlay 가 작업 페이지로 돌린다),
+ * 쓰기는 g_calWork 로 한다. 쓴 값은 다음 읽기부터 보이므로 주행 중에도 다시 초기화할 것이 없다.
+ * 상태 진입 때 읽는 값 (공간 크기, 열림 깊이, 경로) 은 다음 진입부터 쓰인다 */
+typedef struct
+{
+    int gapMinLength;       // 받아들일 공간의 최소 길이 (벽 방향) [mm], 차 폭 + 여유
+    int gapMinDepth;        // 받아들일 공간의 최소 깊이 (벽 안쪽으로) [mm]
+    int gapOpenDepth;       // 벽보다 이만큼 멀리 보이면 열린 곳으로 본다 [mm]
+    int scanLength;         // 첫 공간을 찾은 뒤 후보를 더 보며 따라갈 거리 [mm], 0 이면 첫 공간으로
+    int speedForward;
+    int speedBackward;
+    int parkMode;
+    int turnRadius;         // 경로의 최소 회전 반경 [mm]
+    int parkDepth;          // 직각 주차 시 차 가운데가 벽 선을 넘어 들어갈 거리 [mm]
+    int stopDistance;       // 뒤쪽 안전 정지 거리, 초음파 echo 폭 (10ns 단위) 약 5cm
+    float32 kp;             // PD 게인. 바뀌면 autoparkStep() 이 PD 에 옮긴다
+    float32 kd;
+} AutoparkCal;
+
+static const volatile AutoparkCal g_calFlash OVERLAY_FLASH_PAGE = {
+    .gapMinLength = 300,
+    .gapMinDepth = 300,
+    .gapOpenDepth = 100,
+    .scanLength = 1000,
+    .speedForward = 300,
+    .speedBackward = 300,
+    .parkMode = PARK_PERPENDICULAR,
+    .turnRadius = 150,
+    .parkDepth = 200,
+    .stopDistance = 30000,
+    .kp = PD_DEFAULT_KP,
+    .kd = PD_DEFAULT_KD,
+};
+static AutoparkCal g_calWork OVERLAY_RAM_PAGE;
+static const volatile AutoparkCal *g_cal = &g_calFlash;
+
+/* 이름으로 바꿀 수 있는 튜닝 변수 (autoparkSetParam). 보정 페이지 안 위치와 형, 받아들이는 범위.
+ * 범위 밖 (NaN 포함) 은 쓰지 않는다. 주행 중 패치와 플래시에서 읽은 값이 모두 여기를 지난다 */
+typedef struct
+{
+    const char *name;
+    uint32 offset;
+    boolean isFloat;
+    float32 min;
+    float32 max;
+} AutoparkParam;
+
+#define CAL_INT(name, field, min, max) { name, offsetof(AutoparkCal, field), FALSE, (min), (max) }
+#define CAL_FLOAT(name, field, min, max) { name, offsetof(AutoparkCal, field), TRUE, (min), (max) }
+
+static const AutoparkParam g_params[] = {
+    CAL_INT("gap_min_length", gapMinLength, 100, 5000),
+    CAL_INT("gap_min_depth", gapMinDepth, 100, 5000),
+    CAL_INT("gap_open_depth", gapOpenDepth, 10, 2000),
+    CAL_INT("scan_length", scanLength, 0, 10000),
+    CAL_INT("speed_forward", speedForward, 1, PWM_PERIOD),
+    CAL_INT("speed_backward", speedBackward, 1, PWM_PERIOD),
+    CAL_INT("park_mode", parkMode, PARK_PERPENDICULAR, PARK_PARALLEL),
+    CAL_INT("turn_radius", turnRadius, 50, 2000),
+    CAL_INT("park_depth", parkDepth, 0, 1000),
+    CAL_INT("stop_distance", stopDistance, 0, 600000),     // 약 1m
+    CAL_FLOAT("kp", kp, 0.0f, 10.0f),
+    CAL_FLOAT("kd", kd, 0.0f, 10.0f),
+};
+
+#define AUTOPARK_PARAM_NUM (sizeof(g_params) / sizeof(g_params[0]))
+
+// 데이터 플래시에 저장하는 블록은 g_params 순서대로의 float32 값 배열.
+// 항목을 더하거나 순서를 바꾸면 올린다 (이전 블록은 무시되고 기본값으로 시작)
+#define AUTOPARK_PARAM_VERSION 1
 
 static char buf[64];
 
+// 상태 머신
+static volatile AutoparkState g_state = AUTOPARK_IDLE;
+static AutoparkState g_firstState = AUTOPARK_IDLE;
+static AutoparkState g_lastState = AUTOPARK_IDLE;
+static uint64 g_stateStart = 0;
+static OdometryPose g_statePose;    // 상태 진입 시점의 pose
+static uint32 g_rearNear = 0;       // 연속으로 g_cal->stopDistance 이하였던 뒤쪽 샘플 수
+
+// findSpace 단계 변수
+static WallEstimator g_wallEst;     // 벽 거리/heading 추정 (FIND_SPACE 진입 시 초기화)
+static GapDetector g_gapDet;        // 측면 거리 프로파일의 edge 탐지 (FIND_SPACE 진입 시 초기화)
+static OccupancyProfile g_occ;      // 탐색 중 측면 거리 프로파일 (FIND_SPACE 진입 시 초기화)
+static boolean g_scanFound = FALSE; // 받아들일 만한 공간을 하나 이상 지났는지
+static float32 g_scanStop = 0;      // 이 이동 거리에서 탐색을 끝내고 후보 중에서 고른다 [mm]
+static GapInfo g_gap;               // 고른 공간. MANEUVER 가 여기로 경로를 만든다
+
+// 주차 경로
+static Path g_path;
+static PathTracker g_tracker;
+
+// PD 자동 튜닝
+static PdAutotune g_autotune;
+
 /*********************************************************************************************************************/
 /*------------------------------------------------Function Prototypes------------------------------------------------*/
 /*********************************************************************************************************************/
 
-static void findSpace(void);
-static void rotate(void);
-static void goBackWard(void);
+static boolean findSpaceStep(void);
+static boolean rearReached(void);
+static boolean planManeuver(void);
+static boolean maneuverStep(void);
+static boolean autotuneStep(void);
+static void enterState(AutoparkState state);
+static uint32 stateDurationMs(AutoparkState state);
+static void nextState(void);
+static void runStates(AutoparkState first, AutoparkState last);
+static void stepStates(void);
+static void runUntilIdle(void);
+static void tuneReadLine(void);
 
-static void tuneParkingDistance(void);
+static void tuneGapSize(void);
 static void tuneParkingSpeed(void);
-static void tuneParkingFoundTick(void);
-static void tuneRotate(void);
-static void tuneStopDistance(void);
+static void tuneGapOpenDepth(void);
+static void tuneManeuver(void);
+static void tuneParkDepth(void);
+static void tunePdAutotune(void);
+static void tunePdBench(void);
+static void tunePlanBench(void);
+static float32 getParam(const AutoparkParam *param);
+static boolean setParam(const AutoparkParam *param, float32 value);
+static void syncPdGains(void);
+static void saveParams(void);
 
 /*********************************************************************************************************************/
 /*--------------------------------------Core Parking Functions (Combined)--------------------------------------------*/
 /*********************************************************************************************************************/
 
-static void findSpace(void)
+/* 한 주기분의 벽 따라가기. 주차 공간을 찾으면 TRUE */
+static boolean findSpaceStep(void)
 {
-    int curTick = 0;
-    int stabilized = 0;
-
-    // 1. PID 및 필터 초기화
-    pd_init(LEVEL_LEFT); 
-    DEBUG_PRINTF("[findSpace] PID Initialized. Start wall following.\n");
+    // 1. 엔코더 이동량으로 벽 거리/heading 예측 (echo 가 없는 주기에도)
+    OdometryPose pose = odometryGetPose();
+    wallEstPredict(&g_wallEst, &pose);
 
-    while (1) // 주차 공간을 찾을 때까지 무한 루프
+    // 2. 스케줄러가 넣어 둔 측면 측정값 (기다리지 않음). 왼쪽은 먼저 공간 탐지와 프로파일에 넣고, 벽 샘플만 추정기에 넣는다
+    UltSample sample;
+    while (ultrasonicPop(ULT_LEFT, &sample))
     {
-        // 2. 유효한 좌측 거리 측정
-        int ultDis = getDistanceByUltra(ULT_LEFT);
-        if(ultDis < 0)
+        if (sample.distance < 0)
         {
-            ultDis = getDistanceByUltra(ULT_LEFT);
+            continue;
         }
+        pd_seed(LEVEL_LEFT, sample.distance);   // 첫 몇 샘플로 목표 거리를 잡는다 (잡힌 뒤에는 무시)
 
-        // 3. 주차 공간 탐지 (튜닝된 변수 사용)
-        if (ultDis >= g_parkingDistance)
+        float32 range = (float32)sample.distance * ULT_MM_PER_TICK;
+        float32 wall = wallEstIsValid(&g_wallEst, ULT_LEFT) ? wallEstGetDistance(&g_wallEst, ULT_LEFT) : range;
+        GapEvent event = gapUpdate(&g_gapDet, pose.distance, range, wall);
+        const GapInfo *gap = gapGetInfo(&g_gapDet);
+
+        occAdd(&g_occ, pose.distance, range - wall);
+        if (event == GAP_ACCEPTED && g_scanFound == FALSE)
         {
-            curTick++;
-            DEBUG_PRINTF("[findSpace] Tick #%d (Dist: %d)\n", curTick, ultDis);
-            if (curTick >= g_parkingFoundTick)
-            {
-                DEBUG_PRINTF("[findSpace] Parking Spot Found!\n");
-                break; // 공간 찾음! 루프 탈출
-            }
+            g_scanFound = TRUE;
+            g_scanStop = pose.distance + (float32)g_cal->scanLength;
+            g_gap = *gap;
+            DEBUG_PRINTF("[findSpace] Parking Spot Found! start %d depth %d mm\n", (int)gap->start, (int)gap->depth);
         }
-        else
+        else if (event == GAP_REJECTED)
         {
-            // 공간이 아니면 틱 초기화
-            if(curTick > 0)
-            {
-                DEBUG_PRINTF("[findSpace] Spot lost, resetting tick.\n");
-            }
-            curTick = 0;
+            DEBUG_PRINTF("[findSpace] Gap rejected: start %d length %d depth %d mm\n",
+                (int)gap->start, (int)gap->length, (int)gap->depth);
         }
 
-        // 4. PID 조향 값 계산
-        int mv = pd_calculateSteeringMv(ultDis, LEVEL_LEFT);
+        // 열린 구간 안에서 가깝게 튄 샘플과 edge 근처에서 빔이 퍼져 깊어지는 샘플은 벽으로 넣지 않는다.
+        // 넣으면 추정 거리와 heading 이 한 번에 튀고, 게인이 크면 그 주기에 실제로 크게 꺾는다
+        if (gapIsOpen(&g_gapDet) == FALSE && range - wall < (float32)g_cal->gapOpenDepth * 0.5f)
+        {
+            wallEstUpdate(&g_wallEst, ULT_LEFT, sample.distance);
+        }
+    }
+    UltSample right;
+    while (ultrasonicPop(ULT_RIGHT, &right))
+    {
+        wallEstUpdate(&g_wallEst, ULT_RIGHT, right.distance);
+    }
+
+    // 3. 탐색 거리를 다 보면 프로파일에서 가장 좋은 후보를 고른다 (못 고르면 처음 찾은 공간)
+    if (g_scanFound && pose.distance >= g_scanStop)
+    {
+        uint32 candidates = occFindBest(&g_occ, (float32)g_cal->gapMinLength, (float32)g_cal->gapMinDepth, &g_gap);
+        DEBUG_PRINTF("[findSpace] %d candidates, chose start %d length %d depth %d mm\n",
+            (int)candidates, (int)g_gap.start, (int)g_gap.length, (int)g_gap.depth);
+        return TRUE;
+    }
+
+    // 4. 추정한 거리와 변화량으로 조향 값 계산 (매 주기)
+    int mv = pd_steerByEstimate(&g_wallEst, LEVEL_LEFT);
+
+    // 5. 모터 제어 (튜닝된 변수 사용)
+    motorMovPwm(g_cal->speedForward + mv, 1, g_cal->speedForward - mv, 1);
+    pd_sendTrace(g_cal->speedForward + mv, g_cal->speedForward - mv);
+    return FALSE;
+}
+
+/* 뒤쪽 거리가 REAR_STOP_SAMPLES 번 연속 g_cal->stopDistance 이하면 TRUE (안전 정지). 상태 시작 전에 잰 값은 무시 */
+static boolean rearReached(void)
+{
+    UltSample sample;
 
-        if(stabilized >= 5)
+    while (ultrasonicPop(ULT_REAR, &sample))
+    {
+        if (sample.time > g_stateStart && sample.distance >= 0)
         {
-            mv = 0;
+            g_rearNear = (sample.distance <= g_cal->stopDistance) ? g_rearNear + 1 : 0;
         }
-        else
+    }
+    return g_rearNear >= REAR_STOP_SAMPLES;
+}
+
+/* 찾은 공간과 벽 추정값으로 지금 pose 에서 주차 경로를 만든다. 공간 위치는 이동 거리이고
+ * 벽을 따라 거의 곧게 왔으므로 지금 이동 거리와의 차이를 벽 방향 거리로 본다 */
+static boolean planManeuver(void)
+{
+    PlanScene scene;
+    PlanConfig config;
+
+    wallEstPredict(&g_wallEst, &g_statePose);
+    if (wallEstIsValid(&g_wallEst, ULT_LEFT) == FALSE)
+    {
+        bluetoothPrintf("[autopark] No wall estimate, cannot plan.\n");
+        return FALSE;
+    }
+
+    scene.wallHeading = g_statePose.heading - wallEstGetHeading(&g_wallEst);
+    scene.wallOffset = wallEstGetDistance(&g_wallEst, ULT_LEFT) + PLAN_CAR_WIDTH * 0.5f;
+    scene.gapStart = g_gap.start - g_statePose.distance;
+    scene.gapEnd = g_gap.end - g_statePose.distance;
+    scene.gapDepth = g_gap.depth;
+    config.mode = (ParkMode)g_cal->parkMode;
+    config.radius = (float32)g_cal->turnRadius;
+    config.depth = (float32)g_cal->parkDepth;
+
+    PlanResult result = planPark(&g_path, &g_statePose, &scene, &config);
+    if (result != PLAN_OK)
+    {
+        bluetoothPrintf("[autopark] Planning failed (%d).\n", (int)result);
+        return FALSE;
+    }
+    DEBUG_PRINTF("[plan] %d points, radius %d mm\n", (int)g_path.count, (int)g_path.radius);
+    ptInit(&g_tracker, &g_path, TRACK_LOOKAHEAD, g_cal->speedForward, g_cal->speedBackward);
+    return TRUE;
+}
+
+/* 한 주기분의 경로 추종. 끝났으면 TRUE. 후진 중에는 뒤쪽 거리로도 멈춘다 */
+static boolean maneuverStep(void)
+{
+    OdometryPose pose = odometryGetPose();
+    int left;
+    int right;
+
+    if (rearReached() && ptGetDir(&g_tracker) < 0)
+    {
+        DEBUG_PRINTF("[maneuver] Rear distance reached.\n");
+        return TRUE;
+    }
+
+    switch (ptStep(&g_tracker, &pose, &left, &right))
+    {
+    case TRACK_DRIVE:
+        motorMovPwm(abs(left), left >= 0, abs(right), right >= 0);
+        return FALSE;
+    case TRACK_SETTLE:
+        motorStop();
+        return FALSE;
+    default:
+        DEBUG_PRINTF("[maneuver] Path end reached.\n");
+        return TRUE;
+    }
+}
+
+/* 한 주기분의 릴레이 실험. 벽 추정은 FIND_SPACE 와 같고 조향만 PD 대신 릴레이. 끝났거나 실패하면 TRUE */
+static boolean autotuneStep(void)
+{
+    OdometryPose pose = odometryGetPose();
+    UltSample sample;
+
+    wallEstPredict(&g_wallEst, &pose);
+    while (ultrasonicPop(ULT_LEFT, &sample))
+    {
+        wallEstUpdate(&g_wallEst, ULT_LEFT, sample.distance);
+    }
+    while (ultrasonicPop(ULT_RIGHT, &sample))
+    {
+        wallEstUpdate(&g_wallEst, ULT_RIGHT, sample.distance);
+    }
+
+    // 벽을 보기 전에는 곧게 간다 (릴레이 주기도 세지 않는다)
+    int mv = 0;
+    if (wallEstIsValid(&g_wallEst, ULT_LEFT))
+    {
+        int distance = (int)(wallEstGetDistance(&g_wallEst, ULT_LEFT) / ULT_MM_PER_TICK);
+        int rate = (int)(wallEstGetRate(&g_wallEst, ULT_LEFT) / ULT_MM_PER_TICK);
+
+        mv = pdTuneStep(&g_autotune, distance, rate);
+        if (pdTuneGetStage(&g_autotune) == PD_TUNE_DONE)
         {
-            if(mv < 100 && mv > -100)
-            {
-                stabilized++;
-            }
-            else
-            {
-                stabilized = 0;
-            }
+            DEBUG_PRINTF("[autotune] Kp %f Kd %f\n", logFloat(g_autotune.kp), logFloat(g_autotune.kd));
+            return TRUE;
+        }
+        if (pdTuneGetStage(&g_autotune) == PD_TUNE_FAILED)
+        {
+            DEBUG_PRINTF("[autotune] Failed.\n");
+            return TRUE;
         }
+    }
 
-        // 5. 모터 제어 (튜닝된 변수 사용)
-        motorMovChAPwm(g_parkingSpeedForward + mv, 1); 
-        motorMovChBPwm(g_parkingSpeedForward - mv, 1);
+    motorMovPwm(g_cal->speedForward + mv, 1, g_cal->speedForward - mv, 1);
+    return FALSE;
+}
+
+/* 상태 진입 시 한 번 실행되는 동작 (모터 명령) */
+static void enterState(AutoparkState state)
+{
+    AutoparkState previous = g_state;
+
+    g_state = state;
+    g_stateStart = getTime10Ns();
+    TRACE_CPU0(TRACE_STATE, state, previous);
+    g_statePose = odometryGetPose();
+    g_rearNear = 0;
+
+    switch (state)
+    {
+    case AUTOPARK_FIND_SPACE:
+        // PD 목표 거리는 findSpaceStep() 이 첫 왼쪽 샘플들로 잡는다 (여기서 센서를 기다리지 않음)
+        pd_init(LEVEL_LEFT);
+        wallEstInit(&g_wallEst, &g_statePose);
+        gapInit(&g_gapDet, (float32)g_cal->gapMinLength, (float32)g_cal->gapMinDepth, (float32)g_cal->gapOpenDepth);
+        occInit(&g_occ, (float32)g_cal->gapOpenDepth);
+        g_scanFound = FALSE;
+        DEBUG_PRINTF("[findSpace] PID Initialized. Start wall following.\n");
+        break;
+    case AUTOPARK_FIND_SPACE_STOP:
+        // 공간을 찾았으므로 정지
+        motorStop();
+        DEBUG_PRINTF("[findSpace] Motor Stopped.\n");
+        break;
+    case AUTOPARK_MANEUVER:
+        if (planManeuver() == FALSE)
+        {
+            autoparkAbort();
+            break;
+        }
+        bluetoothPrintf("[autopark] 2. Executing %s Maneuver...\n", (g_cal->parkMode == PARK_PARALLEL) ? "Parallel" : "Perpendicular");
+        break;
+    case AUTOPARK_AUTOTUNE:
+        wallEstInit(&g_wallEst, &g_statePose);
+        pdTuneInit(&g_autotune, AUTOTUNE_RELAY);
+        DEBUG_PRINTF("[autotune] Relay %d started.\n", (int)AUTOTUNE_RELAY);
+        break;
+    case AUTOPARK_SPEED_FORWARD:
+        motorMoveForward(g_cal->speedForward);
+        break;
+    case AUTOPARK_SPEED_REVERSE:
+        motorMoveReverse(g_cal->speedBackward);
+        break;
+    case AUTOPARK_SPEED_FORWARD_STOP:
+    case AUTOPARK_SPEED_REVERSE_STOP:
+        motorStop();
+        break;
+    default:
+        break;
     }
-    
-    // 6. 공간을 찾았으므로 정지
-    motorStop();
-    DEBUG_PRINTF("[findSpace] Motor Stopped.\n");
-    delayMs(50);
 }
 
-static void rotate(void)
+/* 시간으로 끝나는 상태의 유지 시간 [ms] */
+static uint32 stateDurationMs(AutoparkState state)
 {
-    motorMoveForward(g_parkingSpeedForward);
-    delayMs(g_goForwardDelay);
-    motorStop();
-    delayMs(MOTOR_STOP_DELAY);
-    motorMovChAPwm(0, 1);
-    motorMovChBPwm(1000, 0);
-    delayMs(g_rotateDelay);
-    motorStop();
+    switch (state)
+    {
+    case AUTOPARK_FIND_SPACE_STOP:
+        return FIND_SPACE_STOP_DELAY;
+    case AUTOPARK_MANEUVER:
+        return MANEUVER_TIMEOUT;
+    case AUTOPARK_SPEED_FORWARD:
+    case AUTOPARK_SPEED_REVERSE:
+        return SPEED_TEST_DRIVE;
+    case AUTOPARK_SPEED_FORWARD_STOP:
+    case AUTOPARK_SPEED_REVERSE_STOP:
+        return MOTOR_STOP_DELAY;
+    default:
+        return 0;
+    }
 }
 
-static void goBackWard(void)
+static void nextState(void)
 {
-    motorMoveReverse(g_parkingSpeedBackward);
+    if (g_state == g_lastState)
+    {
+        motorStop();
+        TRACE_CPU0(TRACE_STATE, AUTOPARK_IDLE, g_state);
+        g_state = AUTOPARK_IDLE;
+        return;
+    }
+    enterState((AutoparkState)(g_state + 1));
+}
 
-    // int rearDis = getDistanceByUltra(ULT_REAR);
-    // while (rearDis > g_stopDistance)
-    // {
-    //     rearDis = getDistanceByUltra(ULT_REAR);
-    //     delayMs(50);
-    // }
-    delayMs(g_stopDistance);
-    motorStop();
+/* first 부터 last 까지의 상태를 차례로 실행하도록 설정 */
+static void runStates(AutoparkState first, AutoparkState last)
+{
+    g_firstState = first;
+    g_lastState = last;
+    enterState(first);
+}
+
+/* 튜닝 메뉴용: 상태 머신이 끝날 때까지 주기마다 실행, 's' 입력 시 중단 */
+static void runUntilIdle(void)
+{
+    uint32 lastTick = stm0GetTickCount();
+
+    while (g_state != AUTOPARK_IDLE)
+    {
+        if (bluetoothRecvByteNonBlocked() == AUTOPARK_STOP_COMMAND)
+        {
+            autoparkAbort();
+            break;
+        }
+
+        uint32 tick = stm0GetTickCount();
+        if (tick != lastTick)
+        {
+            lastTick = tick;
+            autoparkStep();
+        }
+    }
+}
+
+/* 튜닝 입력 한 줄을 buf 에 받는다. 기다리는 동안에도 제어 주기는 계속 돈다 */
+static void tuneReadLine(void)
+{
+    uint32 lastTick = stm0GetTickCount();
+
+    while (bluetoothPollLine(buf, sizeof(buf)) == FALSE)
+    {
+        uint32 tick = stm0GetTickCount();
+        if (tick != lastTick)
+        {
+            lastTick = tick;
+            autoparkStep();
+        }
+    }
 }
 
 /*********************************************************************************************************************/
 /*----------------------------------------Tuning Functions (from autopark.c)-----------------------------------------*/
 /*********************************************************************************************************************/
 
-static void tuneParkingDistance(void)
+static void tuneGapSize(void)
 {
     while (1)
     {
-        bluetoothPrintf("주차 공간 입력 [c] - 왼쪽 초음파 거리, [y] - 확인 (현재거리: %d)\n", g_parkingDistance);
-        bluetoothScanf("%s", buf);
+        bluetoothPrintf("주차 공간 최소 크기 입력 (길이 깊이) [c] - 왼쪽 초음파 거리, [y] - 확인 (현재: %d %d mm)\n",
+            g_cal->gapMinLength, g_cal->gapMinDepth);
+        tuneReadLine();
         if (buf[0] == 'c') 
         {
             int leftDis = getDistanceByUltra(ULT_LEFT);
-            bluetoothPrintf("현재 초음파 거리: %d\n", leftDis);
+            bluetoothPrintf("현재 초음파 거리: %d mm\n", (int)((float32)leftDis * ULT_MM_PER_TICK));
         }
         else if (buf[0] == 'y')
         {
-            bluetoothPrintf("주차 공간 설정 완료: %d\n", g_parkingDistance);
+            bluetoothPrintf("주차 공간 설정 완료: %d %d mm\n", g_cal->gapMinLength, g_cal->gapMinDepth);
             break;
         }
         else
         {
-            g_parkingDistance = atoi(buf);
-            bluetoothPrintf("parkingDistance 변경 완료: %d\n", g_parkingDistance);
+            char* first = strtok((char*)buf, " ");
+            char* second = strtok(NULL, " ");
+            if (first) g_calWork.gapMinLength = atoi(first);
+            if (second) g_calWork.gapMinDepth = atoi(second);
+            bluetoothPrintf("주차 공간 변경 완료: %d %d mm\n", g_cal->gapMinLength, g_cal->gapMinDepth);
         }
     }
 }
@@ -188,115 +545,125 @@ static void tuneParkingSpeed(void)
     while (1)
     {
         bluetoothPrintf("[주차 공간 찾기] 직진 후진 속도 조절\n");
-        bluetoothPrintf("?[y] - 확인\t(현재 직진: %d, 현재 후진: %d)\n", g_parkingSpeedForward, g_parkingSpeedBackward);
+        bluetoothPrintf("?[y] - 확인\t(현재 직진: %d, 현재 후진: %d)\n", g_cal->speedForward, g_cal->speedBackward);
         
-        bluetoothScanf("%s", buf);
+        tuneReadLine();
 
         if (buf[0] == 'y')
         {
             bluetoothPrintf("속도 설정 완료\n");
-            bluetoothPrintf("직진: %d\t후진: %d\n", g_parkingSpeedForward, g_parkingSpeedBackward);
+            bluetoothPrintf("직진: %d\t후진: %d\n", g_cal->speedForward, g_cal->speedBackward);
             break;
         }
         else
         {
             char* first = strtok((char*)buf, " ");
             char* second = strtok(NULL, " ");
-            if (first) g_parkingSpeedForward = atoi(first);
-            if (second) g_parkingSpeedBackward = atoi(second);
-            bluetoothPrintf("속도 변경: %d %d\n", g_parkingSpeedForward, g_parkingSpeedBackward);
+            if (first) g_calWork.speedForward = atoi(first);
+            if (second) g_calWork.speedBackward = atoi(second);
+            bluetoothPrintf("속도 변경: %d %d\n", g_cal->speedForward, g_cal->speedBackward);
         }
 
-        motorMoveForward(g_parkingSpeedForward);
-        delayMs(2000);
-        motorStop();
-        delayMs(MOTOR_STOP_DELAY);
-        motorMoveReverse(g_parkingSpeedBackward);
-        delayMs(2000);
-        motorStop();
-        delayMs(MOTOR_STOP_DELAY);
+        // 시험 주행은 주기마다 진행하는 시간 상태로 돈다. 도는 동안에도 's' 로 멈춘다
+        runStates(AUTOPARK_SPEED_FORWARD, AUTOPARK_SPEED_REVERSE_STOP);
+        runUntilIdle();
     }
 }
 
-static void tuneParkingFoundTick(void)
+static void tuneGapOpenDepth(void)
 {
     while (1)
     {
-        bluetoothPrintf("?[주차 공간 찾기] Tick 값 설정 [y] - 확인 (현재 Tick: %d) [t] - 테스트 [i] - PID Gain 설정\n", g_parkingFoundTick);
-        bluetoothScanf("%s", buf);
+        bluetoothPrintf("?[주차 공간 찾기] 열림 판정 깊이 & 탐색 거리 설정 [y] - 확인 (현재: %d %d mm) [t] - 테스트 [i] - PID Gain 설정 [a] - PID Gain 자동 튜닝\n",
+            g_cal->gapOpenDepth, g_cal->scanLength);
+        tuneReadLine();
         
         if (buf[0] == 'y')
         {
-            bluetoothPrintf("Tick 값 설정 완료: %d\n", g_parkingFoundTick);
+            bluetoothPrintf("열림 판정 깊이 & 탐색 거리 설정 완료: %d %d mm\n", g_cal->gapOpenDepth, g_cal->scanLength);
             break;
         }
         else if(buf[0] == 't')
         {
             bluetoothPrintf("PID로 공간 탐색 테스트 시작...\n");
-            findSpace();
-            bluetoothPrintf("테스트 완료.\n");
+            runStates(AUTOPARK_FIND_SPACE, AUTOPARK_FIND_SPACE_STOP);
+            runUntilIdle();
+            bluetoothPrintf("테스트 완료. 공간 시작 %d 길이 %d 깊이 %d mm\n", (int)g_gap.start, (int)g_gap.length, (int)g_gap.depth);
         }
         else if(buf[0] == 'i')
         {
             pd_printState();
             bluetoothPrintf("PID Gain 설정 (Kp Kd) 형식으로 입력:\n");
-            bluetoothScanf("%s", buf);
+            tuneReadLine();
             char* first = strtok((char*)buf, " ");
             char* second = strtok(NULL, " ");
-            if (first) pd_setGain(0, atof(first));
-            if (second) pd_setGain(1, atof(second));
+            if (first) g_calWork.kp = (float32)atof(first);
+            if (second) g_calWork.kd = (float32)atof(second);
+            syncPdGains();
             pd_printState();
             bluetoothPrintf("PID Gain 설정 완료.\n");
         }
+        else if(buf[0] == 'a')
+        {
+            tunePdAutotune();
+        }
         else
         {
-            g_parkingFoundTick = atoi(buf);
+            char* first = strtok((char*)buf, " ");
+            char* second = strtok(NULL, " ");
+            if (first) g_calWork.gapOpenDepth = atoi(first);
+            if (second) g_calWork.scanLength = atoi(second);
         }
     }
 }
 
-static void tuneRotate(void)
+static void tuneManeuver(void)
 {
     while (1)
     {
-        bluetoothPrintf("[주차] 직진 & 회전 딜레이 조절 (현재 직진 딜레이: %d, 회전 딜레이: %d)\n", g_goForwardDelay, g_rotateDelay);
+        bluetoothPrintf("[주차] 주차 방식 (0 직각, 1 평행) & 회전 반경 조절 (현재 방식: %d, 회전 반경: %d mm)\n", g_cal->parkMode, g_cal->turnRadius);
         bluetoothPrintf("?[y] - 확인 [r] - 주차 공간 찾기 (PID로)\n");
-        bluetoothScanf("%s", buf);
+        tuneReadLine();
 
         if (buf[0] == 'y')
         {
-            bluetoothPrintf("딜레이 설정 완료 직진: %d\t회전: %d\n", g_goForwardDelay, g_rotateDelay);
+            bluetoothPrintf("설정 완료 방식: %d\t회전 반경: %d mm\n", g_cal->parkMode, g_cal->turnRadius);
             break;
         }
         else if (buf[0] == 'r')
         {
             bluetoothPrintf("PID로 공간 탐색 시작...\n");
-            findSpace();
+            runStates(AUTOPARK_FIND_SPACE, AUTOPARK_FIND_SPACE_STOP);
+            runUntilIdle();
             bluetoothPrintf("공간 탐색 완료.\n");
+            continue;
         }
         else
         {
             char* first = strtok((char*)buf, " ");
             char* second = strtok(NULL, " ");
-            if (first) g_goForwardDelay = atoi(first);
-            if (second) g_rotateDelay = atoi(second);
-            bluetoothPrintf("딜레이 변경: %d %d\n", g_goForwardDelay, g_rotateDelay);
+            if (first) g_calWork.parkMode = (atoi(first) != 0) ? PARK_PARALLEL : PARK_PERPENDICULAR;
+            if (second) g_calWork.turnRadius = atoi(second);
+            bluetoothPrintf("변경: %d %d\n", g_cal->parkMode, g_cal->turnRadius);
         }
-        rotate();
+        // 마지막으로 찾은 공간으로 경로를 만들어 따라간다
+        runStates(AUTOPARK_MANEUVER, AUTOPARK_MANEUVER);
+        runUntilIdle();
+        bluetoothPrintf("경로 %d 점 중 %d 번째에서 종료\n", (int)g_path.count, (int)g_tracker.nearest);
     }
 }
 
-static void tuneStopDistance(void)
+static void tuneParkDepth(void)
 {
     while (1)
     {
-        bluetoothPrintf("[주차] 후진 거리 조절 (현재 후진 거리: %d)\n", g_stopDistance);
+        bluetoothPrintf("[주차] 직각 주차 깊이 조절 (현재 벽 선에서 차 가운데까지: %d mm)\n", g_cal->parkDepth);
         bluetoothPrintf("?[c] - 뒤쪽 거리 출력\t[y] - 확인 \n");
-        bluetoothScanf("%s", buf);
+        tuneReadLine();
         
         if (buf[0] == 'y')
         {
-            bluetoothPrintf("후진 거리 설정 완료: %d\n", g_stopDistance);
+            bluetoothPrintf("주차 깊이 설정 완료: %d mm\n", g_cal->parkDepth);
             break;
         }
         else if (buf[0] == 'c')
@@ -306,16 +673,170 @@ static void tuneStopDistance(void)
         }
         else
         {
-            g_stopDistance = atoi(buf);
-            goBackWard();
+            g_calWork.parkDepth = atoi(buf);
+            bluetoothPrintf("주차 깊이 변경: %d mm\n", g_cal->parkDepth);
         }
     }
 }
 
+/* 벽을 따라가며 릴레이 실험을 하고, 성공하면 찾은 Kp, Kd 를 적용한다. 실패하면 게인은 그대로 */
+static void tunePdAutotune(void)
+{
+    bluetoothPrintf("PID Gain 자동 튜닝 시작 (릴레이 %d)...\n", (int)AUTOTUNE_RELAY);
+    runStates(AUTOPARK_AUTOTUNE, AUTOPARK_AUTOTUNE);
+    runUntilIdle();
+
+    const PdTuneRelay *rate = &g_autotune.rate;
+    const PdTuneRelay *distance = &g_autotune.distance;
+    bluetoothPrintf("변화량 루프: 진폭 %d 주기 %d ms Ku %f\n", (int)rate->amplitude, (int)(rate->period * STEP_PERIOD_MS), rate->gain);
+    bluetoothPrintf("거리 루프  : 진폭 %d 주기 %d ms Ku %f\n", (int)distance->amplitude, (int)(distance->period * STEP_PERIOD_MS), distance->gain);
+    if (pdTuneGetStage(&g_autotune) != PD_TUNE_DONE)
+    {
+        bluetoothPrintf("자동 튜닝 실패. Gain 은 그대로.\n");
+        return;
+    }
+    g_calWork.kp = g_autotune.kp;
+    g_calWork.kd = g_autotune.kd;
+    syncPdGains();
+    pd_printState();
+    bluetoothPrintf("자동 튜닝 완료.\n");
+}
+
+/* 벤치마크는 STM0 로 재므로 CPU0 사이클로 바꾸는 비율 (지금 클럭 설정에서 읽는다) */
+static float32 cpuCyclesPerStmTick(void)
+{
+    return IfxScuCcu_getCpuFrequency(IfxCpu_ResourceCpu_0) / IfxStm_getFrequency(&MODULE_STM0);
+}
+
+/* float / Q16 PD 스텝 시간 측정. fixed checksum 은 호스트 (tools/sil, make bench) 와 같아야 한다 */
+static void tunePdBench(void)
+{
+    PdBenchResult res;
+    float32 cyclesPerTick = cpuCyclesPerStmTick();
+
+    bluetoothPrintf("PD 벤치마크 (%d 스텝)...\n", PD_BENCH_STEPS);
+    pdBenchRun(PD_BENCH_STEPS, getTime10Ns, &res);
+    bluetoothPrintf("float: %d cycles/step checksum %08x\n",
+        (int)((float32)res.floatTicks * cyclesPerTick / (float32)res.steps), res.floatChecksum);
+    bluetoothPrintf("q16  : %d cycles/step checksum %08x\n",
+        (int)((float32)res.fixedTicks * cyclesPerTick / (float32)res.steps), res.fixedChecksum);
+}
+
+/* 경로 계획 한 번의 최악 시간. 호스트 (tools/sil, make bench) 와 같은 격자 */
+static void tunePlanBench(void)
+{
+    PlanBenchResult res;
+    int mode, gapStart, gapLength, gapDepth, wallOffset, radius;
+    float32 cyclesPerTick = cpuCyclesPerStmTick();
+
+    bluetoothPrintf("경로 계획 벤치마크...\n");
+    planBenchRun(getTime10Ns, &res);
+    planBenchDescribe(res.worstCase, &mode, &gapStart, &gapLength, &gapDepth, &wallOffset, &radius);
+    bluetoothPrintf("plan : %d plans (%d ok) mean %d worst %d cycles, %d points max checksum %08x\n",
+        (int)res.plans, (int)res.ok, (int)((float32)res.totalTicks * cyclesPerTick / (float32)res.plans),
+        (int)((float32)res.worstTicks * cyclesPerTick), (int)res.maxPoints, res.checksum);
+    bluetoothPrintf("worst: mode %d gap %d+%d depth %d wall %d radius %d\n",
+        mode, gapStart, gapLength, gapDepth, wallOffset, radius);
+}
+
+static float32 getParam(const AutoparkParam *param)
+{
+    const volatile uint8 *field = (const volatile uint8 *)g_cal + param->offset;
+
+    return param->isFloat ? *(const volatile float32 *)field : (float32)*(const volatile int *)field;
+}
+
+/* 작업 페이지에 쓴다. 정수 변수는 0 쪽으로 버림. 범위 밖이거나 NaN 이면 쓰지 않고 FALSE */
+static boolean setParam(const AutoparkParam *param, float32 value)
+{
+    uint8 *field = (uint8 *)&g_calWork + param->offset;
+
+    if (!(value >= param->min && value <= param->max))
+    {
+        return FALSE;
+    }
+
+    recorderAddFloat(RECORD_PARAM, (uint8)(param - g_params), value, 0.0f);
+    if (param->isFloat)
+    {
+        *(float32 *)field = value;
+        syncPdGains();
+    }
+    else
+    {
+        *(int *)field = (int)value;
+    }
+    return TRUE;
+}
+
+/* PD 게인의 원본은 보정 페이지. 블루투스 패치나 디버거로 페이지를 고치면 여기서 PD 에 옮긴다 */
+static void syncPdGains(void)
+{
+    if (g_cal->kp != pd_getGain(0))
+    {
+        pd_setGain(0, g_cal->kp);
+    }
+    if (g_cal->kd != pd_getGain(1))
+    {
+        pd_setGain(1, g_cal->kd);
+    }
+}
+
+/* 지금 값을 데이터 플래시에 저장. 마지막 저장과 같으면 쓰지 않는다 (섹터 지우기 횟수를 아낀다) */
+static void saveParams(void)
+{
+    float32 values[AUTOPARK_PARAM_NUM];
+    float32 stored[AUTOPARK_PARAM_NUM];
+
+    for (uint32 i = 0; i < AUTOPARK_PARAM_NUM; i++)
+    {
+        values[i] = getParam(&g_params[i]);
+    }
+    if (paramStoreLoad(AUTOPARK_PARAM_VERSION, stored, sizeof(stored)) && memcmp(stored, values, sizeof(values)) == 0)
+    {
+        return;
+    }
+    if (paramStoreSave(AUTOPARK_PARAM_VERSION, values, sizeof(values)))
+    {
+        bluetoothPrintf("설정 저장 완료 (%d 번째)\n", (int)paramStoreGetSequence());
+    }
+    else
+    {
+        bluetoothPrintf("설정 저장 실패. 다음 부팅은 이전 설정으로.\n");
+    }
+}
+
 /*********************************************************************************************************************/
 /*--------------------------------------Public Functions (Entry Points)----------------------------------------------*/
 /*********************************************************************************************************************/
 
+/* 부팅 때 systemInit() 다음에 CPU0 에서 한 번. 보정 페이지를 overlay 로 덮고,
+ * 저장된 설정이 있으면 기본값 대신 작업 페이지에 쓴다 */
+void autoparkInit(void)
+{
+    float32 values[AUTOPARK_PARAM_NUM];
+
+    g_cal = (const volatile AutoparkCal *)overlayMapPage(OVERLAY_BLOCK_AUTOPARK, &g_calFlash, &g_calWork, sizeof(g_calWork));
+
+    if (paramStoreLoad(AUTOPARK_PARAM_VERSION, values, sizeof(values)) == FALSE)
+    {
+        bluetoothPrintf("[autopark] Using default parameters.\n");
+    }
+    else
+    {
+        // CRC 는 바이트가 온전하다는 것뿐이다. 범위 밖 값은 그 변수만 기본값으로 둔다
+        for (uint32 i = 0; i < AUTOPARK_PARAM_NUM; i++)
+        {
+            if (setParam(&g_params[i], values[i]) == FALSE)
+            {
+                bluetoothPrintf("[autopark] Saved %s out of range, using the default.\n", g_params[i].name);
+            }
+        }
+        bluetoothPrintf("[autopark] Parameters loaded (save %d).\n", (int)paramStoreGetSequence());
+    }
+    syncPdGains();
+}
+
 void autoparkTune(void)
 {
     boolean isTuned = FALSE;
@@ -325,16 +846,16 @@ void autoparkTune(void)
         bluetoothPrintf("\n");
         bluetoothPrintf("\n");
         bluetoothPrintf("===========현재 값 (PID 적용됨)===========\n");
-        bluetoothPrintf("1. [주차 공간 찾기] 주차공간: %d\n", g_parkingDistance);
-        bluetoothPrintf("2. [주차 공간 찾기] 전진(PID)속도: %d\t", g_parkingSpeedForward);
-        bluetoothPrintf("후진속도: %d\n", g_parkingSpeedBackward);
-        bluetoothPrintf("3. [주차 공간 찾기] Tick: %d\n", g_parkingFoundTick);
-        bluetoothPrintf("4. [주차 90도 들어가기] 전진 딜레이: %d\t", g_goForwardDelay);
-        bluetoothPrintf("4. 회전 딜레이: %d\n", g_rotateDelay);
-        bluetoothPrintf("5. [주차] 후진 정지 거리: %d\n", g_stopDistance);
-        bluetoothPrintf("?[r] - 시험 주행\t[c]- 확인\t[#]- 재설정\n");
+        bluetoothPrintf("1. [주차 공간 찾기] 최소 공간: 길이 %d 깊이 %d mm\n", g_cal->gapMinLength, g_cal->gapMinDepth);
+        bluetoothPrintf("2. [주차 공간 찾기] 전진(PID)속도: %d\t", g_cal->speedForward);
+        bluetoothPrintf("후진속도: %d\n", g_cal->speedBackward);
+        bluetoothPrintf("3. [주차 공간 찾기] 열림 판정 깊이: %d mm\t탐색 거리: %d mm\n", g_cal->gapOpenDepth, g_cal->scanLength);
+        bluetoothPrintf("4. [주차 경로] 방식: %s\t", (g_cal->parkMode == PARK_PARALLEL) ? "평행" : "직각");
+        bluetoothPrintf("4. 회전 반경: %d mm\n", g_cal->turnRadius);
+        bluetoothPrintf("5. [주차] 벽 안쪽 깊이: %d mm\n", g_cal->parkDepth);
+        bluetoothPrintf("?[r] - 시험 주행\t[c]- 확인\t[#]- 재설정\t[b]- PD/경로 벤치마크\n");
         
-        bluetoothScanf("%s", buf);
+        tuneReadLine();
         
         switch (buf[0])
         {
@@ -342,22 +863,27 @@ void autoparkTune(void)
             autoparkExecute();
             break;
         case 'c':
+            saveParams();
             isTuned = TRUE;
             break;
+        case 'b':
+            tunePdBench();
+            tunePlanBench();
+            break;
         case '1':
-            tuneParkingDistance();
+            tuneGapSize();
             break;
         case '2':
             tuneParkingSpeed();
             break;
         case '3':
-            tuneParkingFoundTick();
+            tuneGapOpenDepth();
             break;
         case '4':
-            tuneRotate();
+            tuneManeuver();
             break;
         case '5':
-            tuneStopDistance();
+            tuneParkDepth();
             break;
         default:
             bluetoothPrintf("UNKNOWN COMMAND\n");
@@ -369,18 +895,159 @@ void autoparkTune(void)
     }
 }
 
-void autoparkExecute(void)
+void autoparkStart(void)
 {
+    // 재생에 필요한 시작 조건 (튜닝 변수, pose) 부터 남긴다
+    OdometryPose pose = odometryGetPose();
+    recorderStart();
+    for (uint32 i = 0; i < AUTOPARK_PARAM_NUM; i++)
+    {
+        recorderAddFloat(RECORD_PARAM, (uint8)i, getParam(&g_params[i]), 0.0f);
+    }
+    recorderAddFloat(RECORD_POSE, 0, pose.x, pose.y);
+    recorderAddFloat(RECORD_POSE, 1, pose.heading, pose.distance);
+    recorderAdd(RECORD_COMMAND, 'p', getTime10Ns(), 0, 0);
+
     bluetoothPrintf("[autopark] 1. Starting PID Space Finding...\n");
-    findSpace(); // PID로 벽을 따라가며 공간 탐색
-    
-    bluetoothPrintf("[autopark] 2. Executing Rotation...\n");
-    rotate();     // 90도 회전
-    
-    delayMs(MOTOR_STOP_DELAY); // 회전 후 잠시 대기
-    
-    bluetoothPrintf("[autopark] 3. Executing Backward Maneuver...\n");
-    goBackWard(); // 후진 주차
-    
-    bluetoothPrintf("[autopark] Parking Complete.\n");
-}
\ No newline at end of file
+    runStates(AUTOPARK_FIND_SPACE, AUTOPARK_MANEUVER);
+}
+
+/* 한 주기 분량. 도중에 돌아오는 곳이 있어 트레이스는 autoparkStep() 이 감싼다 */
+static void stepStates(void)
+{
+    boolean wasBusy = (g_state != AUTOPARK_IDLE);
+
+    recorderAdd(RECORD_TICK, (uint8)g_state, getTime10Ns(), 0, 0);
+    syncPdGains();
+
+    // pose 는 상태와 관계없이 매 주기 적분해야 한다
+    odometryUpdate();
+
+    if (g_state == AUTOPARK_FIND_SPACE)
+    {
+        if (findSpaceStep() == FALSE)
+        {
+            return;
+        }
+        nextState();
+    }
+    else if (g_state == AUTOPARK_MANEUVER && maneuverStep())
+    {
+        nextState();
+    }
+    else if (g_state == AUTOPARK_AUTOTUNE && autotuneStep())
+    {
+        nextState();
+    }
+
+    // 시간이 다 된 상태는 같은 주기 안에서 연속으로 넘긴다 (딜레이 0 포함)
+    while (g_state != AUTOPARK_IDLE && g_state != AUTOPARK_FIND_SPACE && g_state != AUTOPARK_AUTOTUNE &&
+           getTime10Ns() - g_stateStart >= (uint64)stateDurationMs(g_state) * 100000)
+    {
+        nextState();
+    }
+
+    if (wasBusy && g_state == AUTOPARK_IDLE && g_firstState == AUTOPARK_FIND_SPACE && g_lastState == AUTOPARK_MANEUVER)
+    {
+        bluetoothPrintf("[autopark] Parking Complete.\n");
+    }
+    if (wasBusy && g_state == AUTOPARK_IDLE)
+    {
+        recorderStop();
+    }
+}
+
+/* 주기 태스크에서 호출. 한 번에 한 주기 분량만 실행하고 바로 반환 */
+void autoparkStep(void)
+{
+    TRACE_CPU0(TRACE_ENTER, TRACE_SCOPE_STEP, 0);
+    stepStates();
+    TRACE_CPU0(TRACE_EXIT, TRACE_SCOPE_STEP, g_state);
+}
+
+void autoparkAbort(void)
+{
+    recorderAdd(RECORD_COMMAND, AUTOPARK_STOP_COMMAND, getTime10Ns(), 0, 0);
+    motorStop();
+    recorderStop();
+    if (g_state != AUTOPARK_IDLE)
+    {
+        TRACE_CPU0(TRACE_STATE, AUTOPARK_IDLE, g_state);
+        g_state = AUTOPARK_IDLE;
+        bluetoothPrintf("[autopark] Aborted.\n");
+    }
+}
+
+static const AutoparkParam *findParam(const char *name)
+{
+    for (uint32 i = 0; i < AUTOPARK_PARAM_NUM; i++)
+    {
+        if (strcmp(g_params[i].name, name) == 0)
+        {
+            return &g_params[i];
+        }
+    }
+    return NULL;
+}
+
+/* 튜닝 변수 하나를 이름으로 바꾼다 (정수 변수는 0 쪽으로 버림). 모르는 이름이거나 범위 밖이면 FALSE */
+boolean autoparkSetParam(const char *name, float32 value)
+{
+    const AutoparkParam *param = findParam(name);
+
+    if (param == NULL)
+    {
+        return FALSE;
+    }
+    return setParam(param, value);
+}
+
+/* 튜닝 변수 하나가 받아들이는 범위. 모르는 이름이면 FALSE */
+boolean autoparkGetParamRange(const char *name, float32 *min, float32 *max)
+{
+    const AutoparkParam *param = findParam(name);
+
+    if (param == NULL)
+    {
+        return FALSE;
+    }
+    *min = param->min;
+    *max = param->max;
+    return TRUE;
+}
+
+/* 튜닝 변수 하나의 지금 값. 모르는 이름이면 FALSE */
+boolean autoparkGetParam(const char *name, float32 *value)
+{
+    const AutoparkParam *param = findParam(name);
+
+    if (param == NULL)
+    {
+        return FALSE;
+    }
+    *value = getParam(param);
+    return TRUE;
+}
+
+/* index 번째 튜닝 변수의 이름. 끝을 넘으면 NULL */
+const char *autoparkGetParamName(uint32 index)
+{
+    return (index < AUTOPARK_PARAM_NUM) ? g_params[index].name : NULL;
+}
+
+AutoparkState autoparkGetState(void)
+{
+    return g_state;
+}
+
+boolean autoparkIsBusy(void)
+{
+    return g_state != AUTOPARK_IDLE;
+}
+
+/* 블로킹 실행 (튜닝 메뉴의 시험 주행용) */
+void autoparkExecute(void)
+{
+    autoparkStart();
+    runUntilIdle();
+}
@@ -5,13 +5,42 @@
 /*-----------------------------------------------------Includes------------------------------------------------------*/
 /*********************************************************************************************************************/
 
+#include "Ifx_Types.h"
+
+/*********************************************************************************************************************/
+/*-------------------------------------------------Type Definitions--------------------------------------------------*/
+/*********************************************************************************************************************/
+
+/* 실행 순서대로 나열 (autoparkStep 이 다음 상태로 +1 씩 진행) */
+typedef enum
+{
+    AUTOPARK_IDLE,
+    AUTOPARK_FIND_SPACE,        // PID 벽 따라가기로 공간 탐색
+    AUTOPARK_FIND_SPACE_STOP,   // 공간 발견 후 정지
+    AUTOPARK_MANEUVER,          // 경로 계획 후 pure pursuit 로 주차 (직각/평행)
+    AUTOPARK_AUTOTUNE,          // 벽을 따라가며 릴레이 되먹임으로 PD 게인 찾기 (튜닝 메뉴 전용)
+    AUTOPARK_SPEED_FORWARD,     // 속도 시험 주행: 직진 속도로 전진 (튜닝 메뉴 전용)
+    AUTOPARK_SPEED_FORWARD_STOP,
+    AUTOPARK_SPEED_REVERSE,     // 후진 속도로 후진
+    AUTOPARK_SPEED_REVERSE_STOP
+} AutoparkState;
 
 /*********************************************************************************************************************/
 /*-------------------------------------------Function Prototypes-----------------------------------------------------*/
 /*********************************************************************************************************************/
 
+void autoparkInit(void);
 void autoparkTune(void);
 void autoparkExecute(void);
 
+void autoparkStart(void);
+void autoparkStep(void);
+void autoparkAbort(void);
+boolean autoparkSetParam(const char *name, float32 value);
+boolean autoparkGetParam(const char *name, float32 *value);
+boolean autoparkGetParamRange(const char *name, float32 *min, float32 *max);
+const char *autoparkGetParamName(uint32 index);
+AutoparkState autoparkGetState(void);
+boolean autoparkIsBusy(void);
 
-#endif /* AUTOPARK_H_ */
\ No newline at end of file
+#endif /* AUTOPARK_H_ */
@@ -0,0 +1,109 @@
+/*********************************************************************************************************************/
+/*-----------------------------------------------------Includes------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#include "gap_detector.h"
+
+#include <math.h>
+#include <string.h>
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------Macros-------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#define GAP_EDGE_MM 10.0f       // 반대 판정이 이 거리 이상 이어져야 edge 로 확정 (튀는 echo 무시)
+
+/*********************************************************************************************************************/
+/*-------------------------------------------Public Function Implementations-----------------------------------------*/
+/*********************************************************************************************************************/
+
+/* 벽 옆에서 시작한다고 본다 */
+void gapInit(GapDetector *det, float32 minLength, float32 minDepth, float32 openDepth)
+{
+    memset(det, 0, sizeof(*det));
+    det->minLength = minLength;
+    det->minDepth = minDepth;
+    det->openDepth = openDepth;
+}
+
+/* 측면 샘플 하나. travelled 는 odometry 이동 거리, range 와 wall 은 그 쪽 echo 거리와 추정한 벽 거리 [mm].
+ * edge 위치는 마지막 같은 판정과 첫 반대 판정 사이의 가운데로 잡는다.
+ * 빔이 퍼져서 edge 근처에서는 깊이가 천천히 늘어나므로 깊이는 최소가 아니라 최대로 잰다 */
+GapEvent gapUpdate(GapDetector *det, float32 travelled, float32 range, float32 wall)
+{
+    float32 depth = range - wall;
+    float32 held = fminf(depth, det->lastDepth);
+    boolean open = (depth >= det->openDepth);
+
+    det->lastDepth = depth;
+
+    if (open == det->open)
+    {
+        det->edgePending = FALSE;
+        det->lastSame = travelled;
+        if (open == FALSE)
+        {
+            return GAP_NONE;
+        }
+
+        if (held > det->gap.depth)
+        {
+            det->gap.depth = held;
+        }
+        det->gap.end = travelled;
+        det->gap.length = travelled - det->gap.start;
+        if (det->gap.length >= det->minLength && det->gap.depth >= det->minDepth)
+        {
+            det->accepted = TRUE;
+            return GAP_ACCEPTED;
+        }
+        return GAP_NONE;
+    }
+
+    if (det->edgePending == FALSE)
+    {
+        det->edgePending = TRUE;
+        det->edgeFirst = travelled;
+        det->pendingDepth = 0.0f;
+    }
+    else if (open && held > det->pendingDepth)
+    {
+        det->pendingDepth = held;
+    }
+
+    if (travelled - det->edgeFirst < GAP_EDGE_MM)
+    {
+        return GAP_NONE;
+    }
+
+    // edge 확정
+    float32 edge = (det->lastSame + det->edgeFirst) * 0.5f;
+    det->open = open;
+    det->edgePending = FALSE;
+    det->lastSame = travelled;
+
+    if (open)
+    {
+        det->accepted = FALSE;
+        det->gap.start = edge;
+        det->gap.end = travelled;
+        det->gap.length = travelled - edge;
+        det->gap.depth = det->pendingDepth;
+        return GAP_NONE;
+    }
+
+    det->gap.end = edge;
+    det->gap.length = edge - det->gap.start;
+    return det->accepted ? GAP_CLOSED : GAP_REJECTED;
+}
+
+/* 확정된 상태. 열린 구간 안에서 한 번 가깝게 튄 샘플로는 바뀌지 않는다 */
+boolean gapIsOpen(const GapDetector *det)
+{
+    return det->open;
+}
+
+const GapInfo *gapGetInfo(const GapDetector *det)
+{
+    return &det->gap;
+}
@@ -0,0 +1,57 @@
+#ifndef GAP_DETECTOR_H_
+#define GAP_DETECTOR_H_
+
+/*********************************************************************************************************************/
+/*-----------------------------------------------------Includes------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#include "Ifx_Types.h"
+
+/*********************************************************************************************************************/
+/*-------------------------------------------------Type Definitions--------------------------------------------------*/
+/*********************************************************************************************************************/
+
+typedef enum
+{
+    GAP_NONE,
+    GAP_ACCEPTED,       // 열린 구간이 최소 길이와 깊이를 넘었다 (차는 아직 구간 안)
+    GAP_REJECTED,       // 열린 구간이 받아들여지지 않고 닫혔다
+    GAP_CLOSED          // 받아들였던 구간이 닫혔다 (gap 에 최종 길이)
+} GapEvent;
+
+/* 위치는 odometry 이동 거리 [mm], depth 는 벽보다 더 깊은 만큼 [mm] */
+typedef struct
+{
+    float32 start;
+    float32 end;        // ACCEPTED 일 때는 그 시점 위치 (구간은 더 이어질 수 있다)
+    float32 length;
+    float32 depth;      // 연속 두 샘플이 함께 넘은 가장 깊은 곳 (한 번 튄 echo 는 무시)
+} GapInfo;
+
+/* 측면 거리 프로파일의 상승/하강 edge 를 이동 거리로 잡는다. 틱 수나 속도와 무관하다 */
+typedef struct
+{
+    float32 minLength;      // 차가 들어가려면 필요한 벽 방향 길이 [mm]
+    float32 minDepth;       // 필요한 깊이 [mm]
+    float32 openDepth;      // 벽보다 이만큼 멀면 열린 것으로 본다 [mm]
+
+    boolean open;           // 확정된 상태 (벽 / 열림)
+    boolean edgePending;    // 반대 판정이 이어지는 중 (아직 edge 확정 전)
+    boolean accepted;       // 이번 열린 구간을 받아들였는지
+    float32 lastSame;       // 확정 상태와 같은 판정이었던 마지막 위치
+    float32 edgeFirst;      // 반대 판정이 처음 나온 위치
+    float32 lastDepth;      // 직전 샘플의 깊이 [mm]
+    float32 pendingDepth;   // edge 확정 전 열린 샘플로 잰 깊이
+    GapInfo gap;
+} GapDetector;
+
+/*********************************************************************************************************************/
+/*-------------------------------------------Function Prototypes-----------------------------------------------------*/
+/*********************************************************************************************************************/
+
+void gapInit(GapDetector *det, float32 minLength, float32 minDepth, float32 openDepth);
+GapEvent gapUpdate(GapDetector *det, float32 travelled, float32 range, float32 wall);
+boolean gapIsOpen(const GapDetector *det);
+const GapInfo *gapGetInfo(const GapDetector *det);
+
+#endif /* GAP_DETECTOR_H_ */
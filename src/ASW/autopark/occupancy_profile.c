@@ -0,0 +1,200 @@
+/*********************************************************************************************************************/
+/*-----------------------------------------------------Includes------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#include "occupancy_profile.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------Macros-------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#define OCC_MASK (OCC_CELLS - 1)
+#define OCC_HITS_FULL 8         // 판정이 이만큼 더 많으면 신뢰도 255
+#define OCC_DEPTH_AVG 16        // 깊이 평균에 쓰는 최대 샘플 수 (이후는 지수 평균)
+#define OCC_DEPTH_MAX 4000.0f   // [mm], 초음파 최대 거리
+#define OCC_HALF_CELLS 200      // 이만큼 (2 m) 지나온 셀은 신뢰도가 반으로
+#define OCC_MIN_CONF 32         // 후보 공간의 평균 신뢰도가 이보다 낮으면 버린다
+
+/*********************************************************************************************************************/
+/*------------------------------------------Private Function Implementations-----------------------------------------*/
+/*********************************************************************************************************************/
+
+/* 후보 하나 [start, end) 셀. 조건에 맞으면 길이 x 평균 신뢰도가 가장 큰 것을 남긴다 (같으면 나중 것) */
+static void occConsider(float32 minLength, float32 minDepth, sint32 start, sint32 end, float32 depth,
+                        uint32 confSum, uint32 cells, GapInfo *best, float32 *bestScore, uint32 *count)
+{
+    float32 length = (float32)((end - start) * OCC_CELL_MM);
+    uint32 conf = confSum / cells;
+
+    if (length < minLength || depth < minDepth || conf < OCC_MIN_CONF)
+    {
+        return;
+    }
+
+    float32 score = length * (float32)conf;
+    (*count)++;
+    if (score >= *bestScore)
+    {
+        *bestScore = score;
+        best->start = (float32)(start * OCC_CELL_MM);
+        best->end = (float32)(end * OCC_CELL_MM);
+        best->length = length;
+        best->depth = depth;
+    }
+}
+
+/*********************************************************************************************************************/
+/*-------------------------------------------Public Function Implementations-----------------------------------------*/
+/*********************************************************************************************************************/
+
+void occInit(OccupancyProfile *occ, float32 openDepth)
+{
+    memset(occ, 0, sizeof(*occ));
+    occ->empty = TRUE;
+    occ->openDepth = openDepth;
+}
+
+/* 측면 샘플 하나. travelled 는 odometry 이동 거리, depth 는 추정한 벽 너머로 더 먼 만큼 [mm].
+ * 앞으로 새 셀에 들어가면 그 사이 셀만 비우므로 샘플당 상수 시간 (주기당 한두 셀) */
+void occAdd(OccupancyProfile *occ, float32 travelled, float32 depth)
+{
+    sint32 k = (sint32)floorf(travelled / (float32)OCC_CELL_MM);
+
+    if (occ->empty)
+    {
+        occ->empty = FALSE;
+        occ->head = k;
+        occ->first = k;
+    }
+    else if (k > occ->head)
+    {
+        sint32 n = k - occ->head;
+        if (n > OCC_CELLS)
+        {
+            n = OCC_CELLS;
+        }
+        for (sint32 i = n - 1; i >= 0; i--)
+        {
+            memset(&occ->cells[(k - i) & OCC_MASK], 0, sizeof(OccupancyCell));
+        }
+        occ->head = k;
+    }
+    else if (occ->head - k >= OCC_CELLS)
+    {
+        return;             // 링에서 이미 밀려난 위치
+    }
+
+    if (k < occ->first)
+    {
+        occ->first = k;
+    }
+
+    OccupancyCell *cell = &occ->cells[k & OCC_MASK];
+    if (cell->openHits == 255 || cell->wallHits == 255)
+    {
+        cell->openHits /= 2;
+        cell->wallHits /= 2;
+    }
+
+    if (depth >= occ->openDepth)
+    {
+        float32 d = fminf(depth, OCC_DEPTH_MAX);
+        uint32 n = (cell->openHits < OCC_DEPTH_AVG) ? (uint32)cell->openHits + 1 : OCC_DEPTH_AVG;
+
+        cell->openHits++;
+        cell->depth = (uint16)((float32)cell->depth + (d - (float32)cell->depth) / (float32)n);
+    }
+    else
+    {
+        cell->wallHits++;
+    }
+}
+
+/* 0 (모름) ~ 255. 판정이 한쪽으로 많이 모였을수록 높고, head 에서 멀수록 OCC_HALF_CELLS 마다 반으로 */
+uint8 occGetConfidence(const OccupancyProfile *occ, sint32 cell)
+{
+    if (occ->empty || cell > occ->head || cell < occ->first || occ->head - cell >= OCC_CELLS)
+    {
+        return 0;
+    }
+
+    const OccupancyCell *c = &occ->cells[cell & OCC_MASK];
+    sint32 votes = abs((sint32)c->openHits - (sint32)c->wallHits);
+    sint32 age = (occ->head - cell) / OCC_HALF_CELLS;
+
+    if (votes > OCC_HITS_FULL)
+    {
+        votes = OCC_HITS_FULL;
+    }
+    return (age >= 8) ? 0 : (uint8)((votes * 255 / OCC_HITS_FULL) >> age);
+}
+
+/* 링 전체에서 minLength x minDepth 가 들어가는 열린 구간을 찾아 가장 좋은 것을 best 에. 후보 수를 돌려준다.
+ * 샘플이 없는 셀은 앞 판정을 이어 간다. 깊이는 gap_detector 와 같이 이웃 두 셀이 함께 넘은 최대 */
+uint32 occFindBest(const OccupancyProfile *occ, float32 minLength, float32 minDepth, GapInfo *best)
+{
+    uint32 count = 0;
+    float32 bestScore = 0.0f;
+    boolean inGap = FALSE;
+    sint32 start = 0;
+    sint32 lastOpen = 0;
+    float32 depth = 0.0f;
+    float32 prevDepth = 0.0f;
+    uint32 confSum = 0;
+    uint32 cells = 0;
+
+    if (occ->empty)
+    {
+        return 0;
+    }
+
+    sint32 from = occ->head - OCC_CELLS + 1;
+    if (from < occ->first)
+    {
+        from = occ->first;
+    }
+
+    for (sint32 k = from; k <= occ->head; k++)
+    {
+        const OccupancyCell *c = &occ->cells[k & OCC_MASK];
+
+        if (c->openHits == 0 && c->wallHits == 0)
+        {
+            continue;
+        }
+
+        if (c->openHits > c->wallHits)
+        {
+            float32 d = (float32)c->depth;
+            if (inGap == FALSE)
+            {
+                inGap = TRUE;
+                start = k;
+                depth = 0.0f;
+                prevDepth = 0.0f;
+                confSum = 0;
+                cells = 0;
+            }
+            depth = fmaxf(depth, fminf(d, prevDepth));
+            prevDepth = d;
+            confSum += occGetConfidence(occ, k);
+            cells++;
+            lastOpen = k;
+        }
+        else if (inGap)
+        {
+            inGap = FALSE;
+            occConsider(minLength, minDepth, start, lastOpen + 1, depth, confSum, cells, best, &bestScore, &count);
+        }
+    }
+
+    if (inGap)
+    {
+        occConsider(minLength, minDepth, start, lastOpen + 1, depth, confSum, cells, best, &bestScore, &count);
+    }
+    return count;
+}
@@ -0,0 +1,49 @@
+#ifndef OCCUPANCY_PROFILE_H_
+#define OCCUPANCY_PROFILE_H_
+
+/*********************************************************************************************************************/
+/*-----------------------------------------------------Includes------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#include "Ifx_Types.h"
+#include "gap_detector.h"
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------Macros-------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#define OCC_CELL_MM 10          // 셀 하나가 덮는 이동 거리 [mm]
+#define OCC_CELLS 512           // 2의 거듭제곱. 5.12 m, 셀 4 byte 라 2 KB (CPU0 DSPR)
+
+/*********************************************************************************************************************/
+/*-------------------------------------------------Type Definitions--------------------------------------------------*/
+/*********************************************************************************************************************/
+
+typedef struct
+{
+    uint8 openHits;         // 벽보다 openDepth 이상 멀었던 샘플 수
+    uint8 wallHits;         // 벽이었던 샘플 수
+    uint16 depth;           // 열린 샘플의 벽 너머 깊이 평균 [mm]
+} OccupancyCell;
+
+/* 측면 거리 샘플을 이동 거리로 색인한 1D 링. 주차 공간 탐색 한 번 동안 모아 두고
+ * 끝난 뒤 후보 공간 중 가장 넉넉한 곳을 고른다. 오래된 (멀리 지나온) 셀일수록 신뢰도가 낮다 */
+typedef struct
+{
+    OccupancyCell cells[OCC_CELLS];
+    sint32 head;            // 지금까지 쓴 가장 앞 셀 번호 (이동 거리 / OCC_CELL_MM)
+    sint32 first;           // 처음 쓴 셀 번호
+    boolean empty;
+    float32 openDepth;      // [mm]
+} OccupancyProfile;
+
+/*********************************************************************************************************************/
+/*-------------------------------------------Function Prototypes-----------------------------------------------------*/
+/*********************************************************************************************************************/
+
+void occInit(OccupancyProfile *occ, float32 openDepth);
+void occAdd(OccupancyProfile *occ, float32 travelled, float32 depth);
+uint8 occGetConfidence(const OccupancyProfile *occ, sint32 cell);
+uint32 occFindBest(const OccupancyProfile *occ, float32 minLength, float32 minDepth, GapInfo *best);
+
+#endif /* OCCUPANCY_PROFILE_H_ */
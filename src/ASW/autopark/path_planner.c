@@ -0,0 +1,256 @@
+/*********************************************************************************************************************/
+/*-----------------------------------------------------Includes------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#include "path_planner.h"
+
+#include <math.h>
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------Macros-------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#define PLAN_HALF_PI (IFX_PI * 0.5f)
+#define PLAN_RADIUS_TRIES 4         // 반경 x1, x1.5, x2, 그리고 0 (제자리 회전)
+#define PLAN_SPIN_STEP 0.175f       // 제자리 회전 점 간격 [rad], 약 10도
+
+/*********************************************************************************************************************/
+/*------------------------------------------Private Function Implementations-----------------------------------------*/
+/*********************************************************************************************************************/
+
+static boolean planAddPoint(Path *path, float32 x, float32 y, float32 heading, sint8 dir)
+{
+    if (path->count >= PATH_POINTS_MAX)
+    {
+        return FALSE;
+    }
+
+    PathPoint *p = &path->points[path->count++];
+    p->x = x;
+    p->y = y;
+    p->heading = heading;
+    p->dir = dir;
+    return TRUE;
+}
+
+/* 마지막 점에서 (x, y) 까지 직선. 진행 방향은 heading 기준으로 앞/뒤를 정한다 */
+static boolean planAddLine(Path *path, float32 x, float32 y, float32 heading)
+{
+    const PathPoint *from = &path->points[path->count - 1];
+    float32 dx = x - from->x;
+    float32 dy = y - from->y;
+    float32 length = sqrtf(dx * dx + dy * dy);
+    sint8 dir = (dx * cosf(heading) + dy * sinf(heading) >= 0.0f) ? 1 : -1;
+    uint32 n = (uint32)ceilf(length / PATH_STEP_MM);
+    float32 x0 = from->x;
+    float32 y0 = from->y;
+
+    for (uint32 i = 1; i <= n; i++)
+    {
+        float32 t = (float32)i / (float32)n;
+        if (planAddPoint(path, x0 + dx * t, y0 + dy * t, heading, dir) == FALSE)
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/* 마지막 점에서 heading h1 까지 반경 r 의 원호. side 1 이면 중심이 차 왼쪽, -1 이면 오른쪽 */
+static boolean planAddArc(Path *path, float32 r, sint8 side, float32 h1, sint8 dir)
+{
+    const PathPoint *from = &path->points[path->count - 1];
+    float32 h0 = from->heading;
+    float32 cx = from->x - (float32)side * r * sinf(h0);
+    float32 cy = from->y + (float32)side * r * cosf(h0);
+    uint32 n = (uint32)ceilf(r * fabsf(h1 - h0) / PATH_STEP_MM);
+
+    for (uint32 i = 1; i <= n; i++)
+    {
+        float32 h = h0 + (h1 - h0) * (float32)i / (float32)n;
+        if (planAddPoint(path, cx + (float32)side * r * sinf(h), cy - (float32)side * r * cosf(h), h, dir) == FALSE)
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/* 마지막 점에서 제자리에서 heading h1 까지 돈다. 모서리가 쓸고 지나가는 곳도 점마다 검사된다 */
+static boolean planAddSpin(Path *path, float32 h1)
+{
+    const PathPoint *from = &path->points[path->count - 1];
+    float32 h0 = from->heading;
+    float32 x = from->x;
+    float32 y = from->y;
+    uint32 n = (uint32)ceilf(fabsf(h1 - h0) / PLAN_SPIN_STEP);
+
+    for (uint32 i = 1; i <= n; i++)
+    {
+        if (planAddPoint(path, x, y, h0 + (h1 - h0) * (float32)i / (float32)n, 0) == FALSE)
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/* 반경이 0 이면 제자리 회전, 아니면 원호 */
+static boolean planAddTurn(Path *path, float32 r, sint8 side, float32 h1, sint8 dir)
+{
+    return (r > 0.0f) ? planAddArc(path, r, side, h1, dir) : planAddSpin(path, h1);
+}
+
+/* (px, py) 가 pose 의 차체 안이면 TRUE */
+static boolean planInsideCar(const PathPoint *p, float32 px, float32 py)
+{
+    float32 c = cosf(p->heading);
+    float32 s = sinf(p->heading);
+    float32 dx = px - p->x;
+    float32 dy = py - p->y;
+
+    return fabsf(dx * c + dy * s) < PLAN_CAR_LENGTH * 0.5f && fabsf(-dx * s + dy * c) < PLAN_CAR_WIDTH * 0.5f;
+}
+
+/* 벽 좌표계의 경로가 벽을 지나지 않는지. 벽 선을 넘은 모서리는 공간 안이어야 하고, 공간 모서리는 차체 밖이어야 한다 */
+static boolean planIsClear(const Path *path, const PlanScene *scene)
+{
+    static const float32 sx[4] = { 1.0f, 1.0f, -1.0f, -1.0f };
+    static const float32 sy[4] = { 1.0f, -1.0f, -1.0f, 1.0f };
+
+    for (uint32 i = 0; i < path->count; i++)
+    {
+        const PathPoint *p = &path->points[i];
+        float32 c = cosf(p->heading);
+        float32 s = sinf(p->heading);
+
+        for (int k = 0; k < 4; k++)
+        {
+            float32 lx = sx[k] * PLAN_CAR_LENGTH * 0.5f;
+            float32 ly = sy[k] * PLAN_CAR_WIDTH * 0.5f;
+            float32 x = p->x + lx * c - ly * s;
+            float32 y = p->y + lx * s + ly * c;
+
+            if (y > scene->wallOffset &&
+                (x < scene->gapStart || x > scene->gapEnd || y > scene->wallOffset + scene->gapDepth))
+            {
+                return FALSE;
+            }
+        }
+
+        if (planInsideCar(p, scene->gapStart, scene->wallOffset) || planInsideCar(p, scene->gapEnd, scene->wallOffset))
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/* 앞으로 오른쪽 90도 원호를 돌아 공간 가운데 앞에 선 뒤, 곧게 후진해 들어간다 */
+static boolean planPerpendicular(Path *path, const PlanScene *scene, const PlanConfig *config, float32 r)
+{
+    float32 xc = (scene->gapStart + scene->gapEnd) * 0.5f;
+    float32 depth = fminf(config->depth, scene->gapDepth - PLAN_CAR_LENGTH * 0.5f - PLAN_CLEARANCE);
+
+    return planAddLine(path, xc - r, 0.0f, 0.0f) &&
+           planAddTurn(path, r, -1, -PLAN_HALF_PI, 1) &&
+           planAddLine(path, xc, scene->wallOffset + depth, -PLAN_HALF_PI);
+}
+
+/* 공간을 지나친 곳에서 두 원호 (같은 반경, 반대 방향) 로 후진한다.
+ * 옆으로 옮길 거리가 2r 을 넘으면 90도까지 돌고 그 사이를 곧게 후진한다 (r = 0 이면 돌고, 옆으로 후진하고, 돈다) */
+static boolean planParallel(Path *path, const PlanScene *scene, float32 r)
+{
+    float32 xt = (scene->gapStart + scene->gapEnd) * 0.5f;
+    float32 shift = scene->wallOffset + fminf(PLAN_CAR_WIDTH * 0.5f + PLAN_CLEARANCE,
+                                              scene->gapDepth - PLAN_CAR_WIDTH * 0.5f - PLAN_CLEARANCE);
+    float32 theta = (shift >= 2.0f * r) ? PLAN_HALF_PI : acosf(1.0f - shift / (2.0f * r));
+    float32 straight = fmaxf(shift - 2.0f * r, 0.0f);
+    float32 xs = xt + 2.0f * r * sinf(theta);
+
+    if (planAddLine(path, xs, 0.0f, 0.0f) == FALSE || planAddTurn(path, r, 1, -theta, -1) == FALSE)
+    {
+        return FALSE;
+    }
+    if (straight > 0.0f)
+    {
+        const PathPoint *p = &path->points[path->count - 1];
+        if (planAddLine(path, p->x, p->y + straight, -theta) == FALSE)
+        {
+            return FALSE;
+        }
+    }
+    return planAddTurn(path, r, -1, 0.0f, -1);
+}
+
+/*********************************************************************************************************************/
+/*-------------------------------------------Public Function Implementations-----------------------------------------*/
+/*********************************************************************************************************************/
+
+/* pose 에서 공간 안 목표 자세까지 직선과 원호로 된 경로를 만든다. 원호는 추종기가 따라갈 수 있도록
+ * config->radius 이상으로 두고, 모두 벽에 걸리면 차동 구동이라 가능한 제자리 회전으로 만든다.
+ * 점 수가 PATH_POINTS_MAX 로 묶여 있어 반경 시도 수 x 점 수 만큼의 sinf/cosf 가 최악 시간이다
+ * (호스트 make bench 의 plan_bench) */
+PlanResult planPark(Path *path, const OdometryPose *pose, const PlanScene *scene, const PlanConfig *config)
+{
+    PlanResult result = PLAN_NO_ROOM;
+    float32 need = (config->mode == PARK_PARALLEL) ? PLAN_CAR_LENGTH : PLAN_CAR_WIDTH;
+    float32 needDepth = (config->mode == PARK_PARALLEL) ? PLAN_CAR_WIDTH : PLAN_CAR_LENGTH * 0.5f;
+
+    path->count = 0;
+    if (scene->gapEnd - scene->gapStart < need + 2.0f * PLAN_CLEARANCE ||
+        scene->gapDepth < needDepth + 2.0f * PLAN_CLEARANCE)
+    {
+        return PLAN_GAP_TOO_SMALL;
+    }
+
+    for (int i = 0; i < PLAN_RADIUS_TRIES; i++)
+    {
+        float32 r = (i < PLAN_RADIUS_TRIES - 1) ? config->radius * (1.0f + 0.5f * (float32)i) : 0.0f;
+        boolean built;
+
+        path->count = 0;
+        path->radius = r;
+        planAddPoint(path, 0.0f, 0.0f, 0.0f, 1);
+        built = (config->mode == PARK_PARALLEL) ? planParallel(path, scene, r)
+                                                : planPerpendicular(path, scene, config, r);
+        if (built == FALSE)
+        {
+            result = PLAN_TOO_LONG;
+            continue;
+        }
+        if (planIsClear(path, scene))
+        {
+            result = PLAN_OK;
+            break;
+        }
+        result = PLAN_NO_ROOM;
+    }
+
+    if (result != PLAN_OK)
+    {
+        path->count = 0;
+        return result;
+    }
+
+    // 첫 점의 방향은 첫 구간을 따른다
+    if (path->count > 1)
+    {
+        path->points[0].dir = path->points[1].dir;
+    }
+
+    // 벽 좌표계 -> odometry
+    float32 c = cosf(scene->wallHeading);
+    float32 s = sinf(scene->wallHeading);
+    for (uint32 i = 0; i < path->count; i++)
+    {
+        PathPoint *p = &path->points[i];
+        float32 x = p->x;
+        float32 y = p->y;
+
+        p->x = pose->x + x * c - y * s;
+        p->y = pose->y + x * s + y * c;
+        p->heading += scene->wallHeading;
+    }
+    return PLAN_OK;
+}
@@ -0,0 +1,78 @@
+#ifndef PATH_PLANNER_H_
+#define PATH_PLANNER_H_
+
+/*********************************************************************************************************************/
+/*-----------------------------------------------------Includes------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#include "Ifx_Types.h"
+#include "odometry.h"
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------Macros-------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#define PATH_POINTS_MAX 200         // 경로 점 수 상한. 계획 시간의 상한도 이것으로 정해진다
+#define PATH_STEP_MM 20.0f          // 점 간격 [mm]
+
+#define PLAN_CAR_LENGTH 250.0f      // 차체 [mm], pose 는 차체 가운데
+#define PLAN_CAR_WIDTH 180.0f
+#define PLAN_CLEARANCE 30.0f        // 벽/공간 안쪽 끝에서 남길 여유 [mm]
+
+/*********************************************************************************************************************/
+/*-------------------------------------------------Type Definitions--------------------------------------------------*/
+/*********************************************************************************************************************/
+
+typedef enum
+{
+    PARK_PERPENDICULAR,     // 앞으로 돌아 나온 뒤 후진으로 직각 주차
+    PARK_PARALLEL           // 공간을 지나친 뒤 S 자 후진으로 평행 주차
+} ParkMode;
+
+typedef enum
+{
+    PLAN_OK,
+    PLAN_GAP_TOO_SMALL,     // 차체가 들어갈 수 없는 공간
+    PLAN_NO_ROOM,           // 시도한 반경 모두 차체가 벽을 지난다
+    PLAN_TOO_LONG           // PATH_POINTS_MAX 를 넘는다
+} PlanResult;
+
+typedef struct
+{
+    float32 x;              // odometry 좌표 [mm]
+    float32 y;
+    float32 heading;        // [rad], odometry 와 같이 wrap 하지 않는다
+    sint8 dir;              // 1 전진, -1 후진, 0 제자리 회전. 바뀌는 점에서 멈췄다가 방향을 바꾼다
+} PathPoint;
+
+typedef struct
+{
+    PathPoint points[PATH_POINTS_MAX];
+    uint32 count;
+    float32 radius;         // 실제로 쓴 회전 반경 [mm], 0 이면 제자리 회전
+} Path;
+
+/* 벽 좌표계: 원점은 계획 시점 차 가운데, x 는 벽 방향 (진행 방향), y 는 벽 쪽. 단위 mm */
+typedef struct
+{
+    float32 wallHeading;    // 벽 방향의 odometry heading [rad]
+    float32 wallOffset;     // 차 가운데에서 벽 선까지
+    float32 gapStart;       // 공간 시작/끝 x
+    float32 gapEnd;
+    float32 gapDepth;       // 벽 선 너머 깊이
+} PlanScene;
+
+typedef struct
+{
+    ParkMode mode;
+    float32 radius;         // 최소 회전 반경 [mm]. 안 되면 더 크게, 마지막으로 제자리 회전을 시도한다
+    float32 depth;          // 직각: 차 가운데가 벽 선을 넘어 들어갈 거리 [mm]
+} PlanConfig;
+
+/*********************************************************************************************************************/
+/*-------------------------------------------Function Prototypes-----------------------------------------------------*/
+/*********************************************************************************************************************/
+
+PlanResult planPark(Path *path, const OdometryPose *pose, const PlanScene *scene, const PlanConfig *config);
+
+#endif /* PATH_PLANNER_H_ */
@@ -0,0 +1,187 @@
+/*********************************************************************************************************************/
+/*-----------------------------------------------------Includes------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#include "path_tracker.h"
+
+#include <math.h>
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------Macros-------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#define PT_SETTLE_TICKS 50          // 방향 전환 전 정지 (10ms 주기로 500ms)
+#define PT_END_TOLERANCE 5.0f       // run 끝까지 이만큼 남으면 도착 [mm]
+#define PT_DUTY_MAX 1000
+#define PT_SPIN_TOLERANCE 0.035f    // 제자리 회전을 멈출 heading 오차 [rad], 약 2도
+#define PT_SPIN_COAST_TICKS 2.0f    // 정지 명령 후 관성으로 더 도는 양 (직전 주기 회전량의 배수)
+
+/*********************************************************************************************************************/
+/*------------------------------------------Private Function Implementations-----------------------------------------*/
+/*********************************************************************************************************************/
+
+/* first 부터 같은 방향이 이어지는 마지막 점 */
+static uint32 ptFindRunEnd(const Path *path, uint32 first)
+{
+    uint32 i = first;
+
+    while (i + 1 < path->count && path->points[i + 1].dir == path->points[first].dir)
+    {
+        i++;
+    }
+    return i;
+}
+
+static float32 ptDistance(const PathPoint *p, const OdometryPose *pose)
+{
+    float32 dx = p->x - pose->x;
+    float32 dy = p->y - pose->y;
+
+    return sqrtf(dx * dx + dy * dy);
+}
+
+/* 지금 run 이 끝났다. 마지막 run 이면 DONE, 아니면 멈춰서 방향 전환을 기다린다 */
+static TrackStatus ptFinishRun(PathTracker *pt)
+{
+    if (pt->runEnd + 1 >= pt->path->count)
+    {
+        pt->status = TRACK_DONE;
+    }
+    else
+    {
+        pt->settleTicks = PT_SETTLE_TICKS;
+        pt->status = TRACK_SETTLE;
+    }
+    return pt->status;
+}
+
+static int ptClampDuty(float32 duty)
+{
+    if (duty > (float32)PT_DUTY_MAX)
+    {
+        return PT_DUTY_MAX;
+    }
+    if (duty < -(float32)PT_DUTY_MAX)
+    {
+        return -PT_DUTY_MAX;
+    }
+    return (int)duty;
+}
+
+/*********************************************************************************************************************/
+/*-------------------------------------------Public Function Implementations-----------------------------------------*/
+/*********************************************************************************************************************/
+
+void ptInit(PathTracker *pt, const Path *path, float32 lookahead, int dutyForward, int dutyReverse)
+{
+    pt->path = path;
+    pt->nearest = 0;
+    pt->runEnd = (path->count > 0) ? ptFindRunEnd(path, 0) : 0;
+    pt->settleTicks = 0;
+    pt->lastHeading = (path->count > 0) ? path->points[0].heading : 0.0f;
+    pt->status = (path->count > 1) ? TRACK_DRIVE : TRACK_DONE;
+    pt->lookahead = lookahead;
+    pt->dutyForward = dutyForward;
+    pt->dutyReverse = dutyReverse;
+}
+
+/* 한 주기. 바퀴 duty 는 부호가 방향 (+ 앞). run 끝에서는 정지했다가 다음 run 으로 넘어간다 */
+TrackStatus ptStep(PathTracker *pt, const OdometryPose *pose, int *dutyLeft, int *dutyRight)
+{
+    const Path *path = pt->path;
+
+    *dutyLeft = 0;
+    *dutyRight = 0;
+
+    if (pt->status == TRACK_SETTLE)
+    {
+        if (pt->settleTicks > 0)
+        {
+            pt->settleTicks--;
+            return TRACK_SETTLE;
+        }
+        pt->nearest = pt->runEnd;
+        pt->runEnd = ptFindRunEnd(path, pt->runEnd + 1);
+        pt->lastHeading = pose->heading;
+        pt->status = TRACK_DRIVE;
+    }
+    if (pt->status == TRACK_DONE)
+    {
+        return TRACK_DONE;
+    }
+
+    const PathPoint *end = &path->points[pt->runEnd];
+
+    // 제자리 회전: 관성으로 더 도는 만큼 먼저 멈춘다
+    if (end->dir == 0)
+    {
+        float32 error = end->heading - pose->heading;
+        float32 coast = fabsf(pose->heading - pt->lastHeading) * PT_SPIN_COAST_TICKS;
+
+        pt->lastHeading = pose->heading;
+        if (fabsf(error) <= PT_SPIN_TOLERANCE + coast)
+        {
+            return ptFinishRun(pt);
+        }
+        *dutyLeft = (error > 0.0f) ? -pt->dutyForward : pt->dutyForward;
+        *dutyRight = -*dutyLeft;
+        return TRACK_DRIVE;
+    }
+
+    float32 dir = (float32)end->dir;
+    float32 ex = cosf(end->heading) * dir;      // run 끝에서의 진행 방향
+    float32 ey = sinf(end->heading) * dir;
+
+    // 1. run 끝을 지났거나 거의 왔으면 정지
+    if ((end->x - pose->x) * ex + (end->y - pose->y) * ey <= PT_END_TOLERANCE)
+    {
+        return ptFinishRun(pt);
+    }
+
+    // 2. 가장 가까운 점은 앞으로만 옮긴다 (run 안에서)
+    while (pt->nearest < pt->runEnd &&
+           ptDistance(&path->points[pt->nearest + 1], pose) <= ptDistance(&path->points[pt->nearest], pose))
+    {
+        pt->nearest++;
+    }
+
+    // 3. lookahead 만큼 떨어진 목표점. run 끝이 더 가까우면 끝에서 진행 방향으로 늘인 점
+    float32 gx;
+    float32 gy;
+    uint32 i = pt->nearest;
+    while (i < pt->runEnd && ptDistance(&path->points[i], pose) < pt->lookahead)
+    {
+        i++;
+    }
+    float32 left = pt->lookahead - ptDistance(&path->points[i], pose);
+    if (i == pt->runEnd && left > 0.0f)
+    {
+        gx = end->x + ex * left;
+        gy = end->y + ey * left;
+    }
+    else
+    {
+        gx = path->points[i].x;
+        gy = path->points[i].y;
+    }
+
+    // 4. 차 좌표계에서 목표점을 지나는 원호의 곡률. 후진도 같은 식 (목표가 뒤에 있을 뿐)
+    float32 c = cosf(pose->heading);
+    float32 s = sinf(pose->heading);
+    float32 dx = (gx - pose->x) * c + (gy - pose->y) * s;
+    float32 dy = -(gx - pose->x) * s + (gy - pose->y) * c;
+    float32 l2 = dx * dx + dy * dy;
+    float32 curvature = (l2 > 0.0f) ? 2.0f * dy / l2 : 0.0f;
+    float32 v = (dir > 0.0f) ? (float32)pt->dutyForward : -(float32)pt->dutyReverse;
+    float32 turn = curvature * ODOMETRY_TRACK_MM * 0.5f;
+
+    *dutyLeft = ptClampDuty(v * (1.0f - turn));
+    *dutyRight = ptClampDuty(v * (1.0f + turn));
+    return TRACK_DRIVE;
+}
+
+/* 지금 run 의 방향. 1 전진, -1 후진, 0 제자리 회전 */
+sint8 ptGetDir(const PathTracker *pt)
+{
+    return pt->path->points[pt->runEnd].dir;
+}
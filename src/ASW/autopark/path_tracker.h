@@ -0,0 +1,46 @@
+#ifndef PATH_TRACKER_H_
+#define PATH_TRACKER_H_
+
+/*********************************************************************************************************************/
+/*-----------------------------------------------------Includes------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#include "Ifx_Types.h"
+#include "odometry.h"
+#include "path_planner.h"
+
+/*********************************************************************************************************************/
+/*-------------------------------------------------Type Definitions--------------------------------------------------*/
+/*********************************************************************************************************************/
+
+typedef enum
+{
+    TRACK_DRIVE,            // 바퀴 duty 를 내보낸다
+    TRACK_SETTLE,           // 방향이 바뀌는 점에서 정지 중
+    TRACK_DONE
+} TrackStatus;
+
+/* 경로를 같은 방향 구간 (run) 으로 나눠 pure pursuit 로 따라간다. 제자리 회전 run 은 heading 으로 닫는다.
+ * 제어 주기마다 ptStep() */
+typedef struct
+{
+    const Path *path;
+    uint32 runEnd;          // 지금 run 의 마지막 점
+    uint32 nearest;         // 지금 run 에서 가장 가까운 점
+    uint32 settleTicks;     // 남은 정지 주기 수
+    float32 lastHeading;    // 직전 주기 heading (제자리 회전의 관성 추정)
+    TrackStatus status;
+    float32 lookahead;      // [mm]
+    int dutyForward;
+    int dutyReverse;
+} PathTracker;
+
+/*********************************************************************************************************************/
+/*-------------------------------------------Function Prototypes-----------------------------------------------------*/
+/*********************************************************************************************************************/
+
+void ptInit(PathTracker *pt, const Path *path, float32 lookahead, int dutyForward, int dutyReverse);
+TrackStatus ptStep(PathTracker *pt, const OdometryPose *pose, int *dutyLeft, int *dutyRight);
+sint8 ptGetDir(const PathTracker *pt);
+
+#endif /* PATH_TRACKER_H_ */
@@ -0,0 +1,149 @@
+/*********************************************************************************************************************/
+/*-----------------------------------------------------Includes------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#include "pd_autotune.h"
+
+#include <math.h>
+#include <string.h>
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------Macros-------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#define PD_TUNE_RATE_HYSTERESIS 4.0f        // 변화량 릴레이 히스테리시스 [echo/tick], 약 0.01 mm/tick
+#define PD_TUNE_DISTANCE_HYSTERESIS 1500.0f // 거리 릴레이 히스테리시스 [echo], 약 2.5 mm
+#define PD_TUNE_DISTANCE_RELAY 3.0f         // 거리 단계 릴레이는 Kd 로 눌리므로 이만큼 크게 (노이즈보다 크게 흔들리도록)
+#define PD_TUNE_KD_RULE 0.3f                // Kd = 0.3 Ku
+#define PD_TUNE_KP_RULE 0.15f               // Kp = 0.15 Ku
+#define PD_TUNE_MV_MAX 200                  // pd_control.c 의 MV_MAX 와 같게
+
+#define PD_TUNE_PI 3.14159265f
+
+/*********************************************************************************************************************/
+/*------------------------------------------------Function Prototypes------------------------------------------------*/
+/*********************************************************************************************************************/
+
+static void pdTuneEnterStage(PdAutotune *tune, PdTuneStage stage);
+static boolean pdTuneRelay(PdAutotune *tune, float32 y, PdTuneRelay *result);
+
+/*********************************************************************************************************************/
+/*------------------------------------------Private Function Implementations-----------------------------------------*/
+/*********************************************************************************************************************/
+
+static void pdTuneEnterStage(PdAutotune *tune, PdTuneStage stage)
+{
+    tune->stage = stage;
+    tune->hysteresis = (stage == PD_TUNE_RATE) ? PD_TUNE_RATE_HYSTERESIS : PD_TUNE_DISTANCE_HYSTERESIS;
+    tune->height = (stage == PD_TUNE_RATE) ? tune->relay : tune->relay * PD_TUNE_DISTANCE_RELAY;
+    tune->sign = 1;
+    tune->tick = 0;
+    tune->lastRise = 0;
+    tune->cycles = 0;
+    tune->yMax = -INFINITY;
+    tune->yMin = INFINITY;
+    tune->periodSum = 0;
+    tune->amplitudeSum = 0;
+}
+
+/* 릴레이 입력 y 한 주기. 출력 방향은 tune->sign 에 남긴다.
+ * - 에서 + 로 바뀔 때마다 한 주기로 보고 주기와 진폭을 잰다. 다 쟀으면 result 를 채우고 TRUE */
+static boolean pdTuneRelay(PdAutotune *tune, float32 y, PdTuneRelay *result)
+{
+    tune->tick++;
+    tune->yMax = fmaxf(tune->yMax, y);
+    tune->yMin = fminf(tune->yMin, y);
+
+    if (tune->sign < 0 && y > tune->hysteresis)
+    {
+        tune->sign = 1;
+        if (tune->lastRise != 0)
+        {
+            tune->cycles++;
+            if (tune->cycles > PD_TUNE_SKIP_CYCLES)
+            {
+                tune->periodSum += (float32)(tune->tick - tune->lastRise);
+                tune->amplitudeSum += (tune->yMax - tune->yMin) * 0.5f;
+            }
+        }
+        tune->lastRise = tune->tick;
+        tune->yMax = y;
+        tune->yMin = y;
+    }
+    else if (tune->sign > 0 && y < -tune->hysteresis)
+    {
+        tune->sign = -1;
+    }
+
+    if (tune->cycles < PD_TUNE_SKIP_CYCLES + PD_TUNE_MEASURE_CYCLES)
+    {
+        return FALSE;
+    }
+
+    // 히스테리시스가 있는 릴레이의 묘사 함수: N(a) = 4h / (pi sqrt(a^2 - e^2))
+    float32 a = tune->amplitudeSum / PD_TUNE_MEASURE_CYCLES;
+    float32 e = tune->hysteresis;
+
+    result->amplitude = a;
+    result->period = tune->periodSum / PD_TUNE_MEASURE_CYCLES;
+    result->gain = (a > e) ? 4.0f * tune->height / (PD_TUNE_PI * sqrtf(a * a - e * e)) : 0;
+    return TRUE;
+}
+
+/*********************************************************************************************************************/
+/*-------------------------------------------Public Function Implementations-----------------------------------------*/
+/*********************************************************************************************************************/
+
+/* relay 는 변화량 단계의 릴레이 출력 크기 [MV] */
+void pdTuneInit(PdAutotune *tune, float32 relay)
+{
+    memset(tune, 0, sizeof(*tune));
+    tune->relay = relay;
+    pdTuneEnterStage(tune, PD_TUNE_RATE);
+}
+
+/* 한 제어 주기. distance 와 rate 는 pdStepRate() 와 같은 벽 거리 [echo] 와 주기당 변화량 [echo/tick].
+ * 반환값은 PD 와 같은 부호의 MV (+ 면 벽에서 멀어지는 쪽). DONE 이면 kp, kd 가 채워져 있다 */
+int pdTuneStep(PdAutotune *tune, int distance, int rate)
+{
+    float32 derivative = (float32)-rate;
+    float32 mv = 0;
+
+    switch (tune->stage)
+    {
+    case PD_TUNE_RATE:
+        if (pdTuneRelay(tune, derivative, &tune->rate))
+        {
+            tune->kd = PD_TUNE_KD_RULE * tune->rate.gain;
+            tune->target = distance;    // 거리 단계는 지금 거리를 지킨다
+            pdTuneEnterStage(tune, (tune->kd > 0) ? PD_TUNE_DISTANCE : PD_TUNE_FAILED);
+            break;
+        }
+        mv = tune->height * tune->sign;
+        break;
+    case PD_TUNE_DISTANCE:
+        if (pdTuneRelay(tune, (float32)(tune->target - distance), &tune->distance))
+        {
+            tune->kp = PD_TUNE_KP_RULE * tune->distance.gain;
+            pdTuneEnterStage(tune, (tune->kp > 0) ? PD_TUNE_DONE : PD_TUNE_FAILED);
+            break;
+        }
+        mv = tune->kd * derivative + tune->height * tune->sign;
+        break;
+    default:
+        return 0;
+    }
+
+    if (tune->stage != PD_TUNE_FAILED && tune->tick >= PD_TUNE_STAGE_TICKS)
+    {
+        pdTuneEnterStage(tune, PD_TUNE_FAILED);
+    }
+
+    mv = fminf(fmaxf(mv, (float32)-PD_TUNE_MV_MAX), (float32)PD_TUNE_MV_MAX);
+    return (int)mv;
+}
+
+PdTuneStage pdTuneGetStage(const PdAutotune *tune)
+{
+    return tune->stage;
+}
@@ -0,0 +1,71 @@
+#ifndef PD_AUTOTUNE_H_
+#define PD_AUTOTUNE_H_
+
+/*********************************************************************************************************************/
+/*-----------------------------------------------------Includes------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#include "Ifx_Types.h"
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------Macros-------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#define PD_TUNE_SKIP_CYCLES 2       // 과도 응답으로 보고 버리는 릴레이 주기 수
+#define PD_TUNE_MEASURE_CYCLES 3    // 평균을 낼 릴레이 주기 수
+#define PD_TUNE_STAGE_TICKS 1500    // 한 단계가 이 주기 수 안에 끝나지 않으면 실패 (15 s)
+
+/*********************************************************************************************************************/
+/*-------------------------------------------------Type Definitions--------------------------------------------------*/
+/*********************************************************************************************************************/
+
+/* 진행 순서대로 나열 */
+typedef enum
+{
+    PD_TUNE_RATE,           // 거리 변화량에 릴레이 -> Kd
+    PD_TUNE_DISTANCE,       // 찾은 Kd 를 켠 채로 거리 오차에 릴레이 -> Kp
+    PD_TUNE_DONE,
+    PD_TUNE_FAILED          // 주기 안에 진동이 자리잡지 않았거나 진폭이 히스테리시스보다 작다
+} PdTuneStage;
+
+/* 릴레이 실험 한 번의 결과. 단위는 PD 입력과 같은 echo 폭 (10ns 단위) 과 제어 주기 */
+typedef struct
+{
+    float32 amplitude;      // 릴레이 입력의 진동 진폭
+    float32 period;         // 한계 주기 Tu [tick]
+    float32 gain;           // 한계 이득 Ku = 4h / (pi a)
+} PdTuneRelay;
+
+/* 2 단계 릴레이 되먹임 실험. 플랜트를 모르므로 입력은 PD 와 같은 (거리, 변화량) 이고 출력은 MV 이다.
+ * 벽 쪽 플랜트는 MV -> 회전 -> 거리로 적분이 두 번 있어서 거리 릴레이만으로는 진동이 자리잡지 않는다.
+ * 그래서 먼저 변화량 루프의 Ku 로 Kd 를 잡고, 그 Kd 로 안정시킨 뒤 거리 루프의 Ku 로 Kp 를 잡는다 */
+typedef struct
+{
+    PdTuneStage stage;
+    float32 relay;          // 변화량 단계의 릴레이 출력 크기 [MV]
+    float32 height;         // 이번 단계 릴레이 출력 크기 h [MV]
+    float32 hysteresis;     // 이번 단계 릴레이 입력의 히스테리시스
+    int target;             // 거리 단계의 목표 [echo], 변화량 단계가 끝난 곳의 거리
+    sint8 sign;             // 지금 릴레이 출력 방향
+    uint32 tick;            // 이번 단계 시작부터 센 주기
+    uint32 lastRise;        // 마지막으로 + 로 바뀐 주기 (0 이면 아직 없음)
+    uint32 cycles;          // 이번 단계에서 끝난 릴레이 주기 수
+    float32 yMax;           // 이번 주기 릴레이 입력의 최대/최소
+    float32 yMin;
+    float32 periodSum;
+    float32 amplitudeSum;
+    PdTuneRelay rate;
+    PdTuneRelay distance;
+    float32 kp;
+    float32 kd;
+} PdAutotune;
+
+/*********************************************************************************************************************/
+/*-------------------------------------------Function Prototypes-----------------------------------------------------*/
+/*********************************************************************************************************************/
+
+void pdTuneInit(PdAutotune *tune, float32 relay);
+int pdTuneStep(PdAutotune *tune, int distance, int rate);
+PdTuneStage pdTuneGetStage(const PdAutotune *tune);
+
+#endif /* PD_AUTOTUNE_H_ */
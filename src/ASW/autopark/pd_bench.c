@@ -0,0 +1,80 @@
+/*********************************************************************************************************************/
+/*-----------------------------------------------------Includes------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#include "pd_bench.h"
+#include "pd_control.h"
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------Macros-------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#define PD_BENCH_KP 0.05f
+#define PD_BENCH_KD 0.2f
+
+#define PD_BENCH_WALL 87500         // 약 15cm (10ns echo 폭)
+#define PD_BENCH_SWAY 1500          // 좌우 흔들림 진폭
+#define PD_BENCH_NOISE 511          // 샘플 잡음 (마스크)
+#define PD_BENCH_OUTLIER_EVERY 97   // 이 주기마다 튀는 값 하나
+
+/*********************************************************************************************************************/
+/*------------------------------------------Private Function Implementations-----------------------------------------*/
+/*********************************************************************************************************************/
+
+/* 정수만으로 만드는 입력 열: 삼각파 흔들림 + LCG 잡음 + 가끔 튀는 값 */
+static int benchSample(uint32 i, uint32 *seed)
+{
+    uint32 phase = i % 400;
+    int sway = (phase < 200) ? (int)phase : (int)(400 - phase);
+
+    *seed = *seed * 1664525u + 1013904223u;
+    int sample = PD_BENCH_WALL + (sway - 100) * PD_BENCH_SWAY / 100 + (int)((*seed >> 16) & PD_BENCH_NOISE);
+
+    if (i % PD_BENCH_OUTLIER_EVERY == PD_BENCH_OUTLIER_EVERY - 1)
+    {
+        sample += 50000;
+    }
+    return sample;
+}
+
+static uint32 benchHash(uint32 hash, int mv)
+{
+    return (hash ^ (uint32)mv) * 16777619u;
+}
+
+/*********************************************************************************************************************/
+/*-------------------------------------------Public Function Implementations-----------------------------------------*/
+/*********************************************************************************************************************/
+
+/* 같은 입력 열을 float / Q16 PD 에 각각 steps 번 넣고 걸린 시간과 MV 해시를 잰다.
+ * 입력은 미리 만들지 않고 매 스텝 계산하므로 두 경로에 같은 만큼 더해진다 */
+void pdBenchRun(uint32 steps, PdBenchClock clock, PdBenchResult *result)
+{
+    PdController pd;
+    uint32 seed;
+    uint64 start;
+
+    result->steps = steps;
+
+    pdInit(&pd, PD_BENCH_KP, PD_BENCH_KD);
+    seed = 1;
+    pdReset(&pd, PD_BENCH_WALL);
+    result->floatChecksum = 2166136261u;
+    start = clock();
+    for (uint32 i = 0; i < steps; i++)
+    {
+        result->floatChecksum = benchHash(result->floatChecksum, pdStepFloat(&pd, benchSample(i, &seed)));
+    }
+    result->floatTicks = clock() - start;
+
+    pdInit(&pd, PD_BENCH_KP, PD_BENCH_KD);
+    seed = 1;
+    pdReset(&pd, PD_BENCH_WALL);
+    result->fixedChecksum = 2166136261u;
+    start = clock();
+    for (uint32 i = 0; i < steps; i++)
+    {
+        result->fixedChecksum = benchHash(result->fixedChecksum, pdStepQ16(&pd, benchSample(i, &seed)));
+    }
+    result->fixedTicks = clock() - start;
+}
@@ -0,0 +1,38 @@
+#ifndef PD_BENCH_H_
+#define PD_BENCH_H_
+
+/*********************************************************************************************************************/
+/*-----------------------------------------------------Includes------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#include "Ifx_Types.h"
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------Macros-------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#define PD_BENCH_STEPS 10000
+
+/*********************************************************************************************************************/
+/*-------------------------------------------------Type Definitions--------------------------------------------------*/
+/*********************************************************************************************************************/
+
+/* 단조 증가하는 시계. 타깃은 getTime10Ns() (STM0), 호스트는 TSC 등 */
+typedef uint64 (*PdBenchClock)(void);
+
+typedef struct
+{
+    uint32 steps;
+    uint64 floatTicks;      // pdStepFloat() steps 번에 걸린 시계 값
+    uint64 fixedTicks;      // pdStepQ16() steps 번에 걸린 시계 값
+    uint32 floatChecksum;   // MV 열의 해시. float 경로는 컴파일러/FPU 에 따라 다를 수 있다
+    uint32 fixedChecksum;   // 고정소수점 경로는 호스트와 타깃에서 같아야 한다
+} PdBenchResult;
+
+/*********************************************************************************************************************/
+/*-------------------------------------------Function Prototypes-----------------------------------------------------*/
+/*********************************************************************************************************************/
+
+void pdBenchRun(uint32 steps, PdBenchClock clock, PdBenchResult *result);
+
+#endif /* PD_BENCH_H_ */
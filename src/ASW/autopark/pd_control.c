@@ -5,53 +5,52 @@
 #include "pd_control.h"
 #include "bluetooth.h"
 #include "asclin0.h"
+#include "profile.h"
+#include "telemetry.h"
 #include "ultrasonic.h"
 #include "util.h"
 #include <stdlib.h>
+#include <string.h>
 
 /*********************************************************************************************************************/
 /*------------------------------------------------------Macros-------------------------------------------------------*/
 /*********************************************************************************************************************/
 
-#ifdef NDEBUG
-#define DEBUG_PRINTF(...) ((void)0)
-#else
-#define DEBUG_PRINTF(...) myPrintf(__VA_ARGS__)
-#endif
-
-#define FILTER_SIZE 6
 #define ABNORMAL_DIFF 3000
 #define MV_MAX 200
 #define MV_MIN -200
 
-/*********************************************************************************************************************/
-/*-------------------------------------------------Static Variables--------------------------------------------------*/
-/*********************************************************************************************************************/
-
-// // PD 게인
-static float g_Kp = 0.0;
-static float g_Kd = 0.2;
-
-// PD 계산용 변수
-// static float g_error = 0;
-static int g_error = 0;
-static int g_last_error = 0;
-static int g_derivative = 0;
-// static float g_targetDistance = 0;
+#define PD_TRACE_SIZE 18
+#define PD_INIT_READINGS 5      // pd_seed() 가 목표 거리를 잡을 때 모으는 측정값 수 (가운데 값을 쓴다)
 
+#define PD_GAIN_Q16_MAX 0x7FFFFFFF
+// 범위 안의 상수 게인에 대한 pdGainToQ16() (같은 반올림). 정적 초기값이 실행 중 변환과 어긋나지 않게
+#define PD_GAIN_Q16_CONST(gain) \
+    ((sint32)(((gain) >= 0.0f) ? ((gain) * (float)PD_Q16_ONE + 0.5f) : ((gain) * (float)PD_Q16_ONE - 0.5f)))
 
-// 이동 평균 필터용 변수
-static uint32 g_readings[FILTER_SIZE] = {0};
-static int g_read_index = 0;
-static int g_cur_readings_num = 0;
-static uint32 g_total = 0;
-static uint32 g_filtered_distance = 0;
+// Hampel: 중앙값에서 K * 1.4826 * MAD 보다 멀면 outlier. 정수만 쓰도록 100 배
+#define PD_HAMPEL_K_X100 445
+#define PD_HAMPEL_MIN_DEV 3000      // 최소 허용 폭 (약 5mm). MAD 가 echo 분해능 (100) 수준으로 작을 때 잡음까지 버리지 않게
+#define PD_HAMPEL_MIN_READINGS 3    // 이보다 적으면 판정 없이 받는다
 
+/*********************************************************************************************************************/
+/*-------------------------------------------------Static Variables--------------------------------------------------*/
+/*********************************************************************************************************************/
 
-static uint32 g_targetDistance = 0;
-static uint32 g_previous_filtered_distance = 0;
-static uint32 g_current_filtered_distance = 0;
+// 기존 API 용 기본 인스턴스. pd_init() 전에는 게인만 유효하다 (나머지는 pdInit() 처럼 0)
+#define PD_DEFAULT_INSTANCE                                                                             \
+    {                                                                                                   \
+        .kp = PD_DEFAULT_KP, .kd = PD_DEFAULT_KD, .kpQ16 = PD_GAIN_Q16_CONST(PD_DEFAULT_KP),            \
+        .kdQ16 = PD_GAIN_Q16_CONST(PD_DEFAULT_KD), .windowSize = PD_FILTER_SIZE                         \
+    }
 
+static PdController g_pd[LEVEL_DIR_NUM] = {
+    [LEVEL_LEFT] = PD_DEFAULT_INSTANCE,
+    [LEVEL_RIGHT] = PD_DEFAULT_INSTANCE,
+};
+static LevelDir g_lastDir = LEVEL_LEFT;     // pd_sendTrace() 가 보낼 인스턴스
+static int g_seed[LEVEL_DIR_NUM][PD_INIT_READINGS]; // pd_init() 이후 모은 거리 (정렬)
+static int g_seedNum[LEVEL_DIR_NUM];                // 그 개수. PD_INIT_READINGS 이면 목표 거리가 잡혔다
 
 
 // --- [시작] 여기에 새 EMA 필터 변수 추가 ---
@@ -68,7 +67,7 @@ static uint32 g_current_filtered_distance = 0;
 /*********************************************************************************************************************/
 
 // static float getFilteredDistance(int distance);
-static uint32 getFilteredDistance(int distance);
+static uint32 getFilteredDistance(PdController *pd, int distance);
 
 /*********************************************************************************************************************/
 /*------------------------------------------Private Function Implementations-----------------------------------------*/
@@ -96,137 +95,179 @@ static uint32 getFilteredDistance(int distance);
 // // --- [끝] 여기까지 교체 ---
 
 
-static uint32 getFilteredDistance(int distance)
+/* sorted[0..n-1] 에서 value 이상인 첫 위치 */
+static int sortedLowerBound(const uint32 *sorted, int n, uint32 value)
 {
-    DEBUG_PRINTF("[GetFilteredDistance] distance: %d\n", distance);
-    g_total -= g_readings[g_read_index];
+    int lo = 0;
+    int hi = n;
 
-    g_readings[g_read_index] = distance;
-    g_total += distance;
-    g_read_index = (g_read_index + 1) % FILTER_SIZE;
-
-    if (g_cur_readings_num < FILTER_SIZE)
+    while (lo < hi)
     {
-        g_cur_readings_num++;
+        int mid = (lo + hi) / 2;
+        if (sorted[mid] < value)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
     }
-    DEBUG_PRINTF("[GetFilteredDistance] total: %d\n", g_total);
-    DEBUG_PRINTF("[GetFilteredDistance] cur_readings_num: %d\n", g_cur_readings_num);
-    DEBUG_PRINTF("[GetFilteredDistance] return total / cur_reading_num: %d\n", g_total / g_cur_readings_num);
-    return g_total / g_cur_readings_num;
+    return lo;
 }
 
-/*********************************************************************************************************************/
-/*-------------------------------------------Public Function Implementations-----------------------------------------*/
-/*********************************************************************************************************************/
-
-void pd_printState(void)
+/* 가장 오래된 값을 정렬 창에서 빼고 새 값을 끼운다. 빠진 자리와 들어갈 자리 사이만 한 칸씩 민다 */
+static void filterPush(PdController *pd, uint32 value)
 {
-    bluetoothPrintf("Cur Gain: %f\t%f\n", g_Kp, g_Kd);
-    myPrintf("Cur Gain: %f\t%f\n", g_Kp, g_Kd);
-}
+    int n = pd->readingsNum;
+    int pos;
 
-void pd_setGain(int n, float i)
-{
-    if (n == 0)
+    if (n == pd->windowSize)
     {
-        g_Kp = i;
-        bluetoothPrintf("cur Kp: %f\n", g_Kp);
+        uint32 oldest = pd->readings[pd->readIndex];
+        pos = sortedLowerBound(pd->sorted, n, oldest);
+        pd->total -= oldest;
+
+        // 빠진 자리에서 새 값 자리 쪽으로 당긴다
+        while (pos > 0 && pd->sorted[pos - 1] > value)
+        {
+            pd->sorted[pos] = pd->sorted[pos - 1];
+            pos--;
+        }
+        while (pos < n - 1 && pd->sorted[pos + 1] < value)
+        {
+            pd->sorted[pos] = pd->sorted[pos + 1];
+            pos++;
+        }
     }
-    if (n == 1)
+    else
     {
-        g_Kd = i;
-        bluetoothPrintf("cur Kd: %f\n", g_Kd);
+        pos = n;
+        while (pos > 0 && pd->sorted[pos - 1] > value)
+        {
+            pd->sorted[pos] = pd->sorted[pos - 1];
+            pos--;
+        }
+        n++;
     }
-}
-
-// void pd_init(LevelDir dir)
-// {
-//     UltraDir ultDir = (dir == LEVEL_LEFT) ? ULT_LEFT : ULT_RIGHT;
-
-//     g_integral = 0;
-//     g_last_error = 0;
-
-//     g_total = 0;
-//     g_read_index = 0;
-//     g_cur_readings_num = 0;
-
-//     for (int i = 0; i < FILTER_SIZE; i++)
-//     {
-//         g_readings[i] = 0;
-//     }
+    pd->sorted[pos] = value;
 
-//     // 유효한 거리 값으로 필터 초기화
-//     int ultDis = getDistanceByUltra(ultDir);
-//     g_previous_filtered_distance = getFilteredDistance(ultDis);
-// }
+    pd->readings[pd->readIndex] = value;
+    pd->total += value;
+    pd->readIndex = (pd->readIndex + 1) % pd->windowSize;
+    pd->readingsNum = n;
+}
 
-void updateTargetDistance(uint32 distance)
+static uint32 filterMedian(const PdController *pd)
 {
-    g_targetDistance = distance;
+    int n = pd->readingsNum;
+
+    if ((n & 1) != 0)
+    {
+        return pd->sorted[n / 2];
+    }
+    return pd->sorted[n / 2 - 1] + (pd->sorted[n / 2] - pd->sorted[n / 2 - 1]) / 2;
 }
 
-void pd_init(LevelDir dir)
+/* 중앙값에서의 편차는 중앙 바깥으로 갈수록 커지므로 양쪽에서 작은 쪽부터 세어 (n-1)/2 번째 */
+static uint32 filterMad(const PdController *pd, uint32 median)
 {
-    UltraDir ultDir = (dir == LEVEL_LEFT) ? ULT_LEFT : ULT_RIGHT;
+    int l = sortedLowerBound(pd->sorted, pd->readingsNum, median) - 1;
+    int r = l + 1;
+    uint32 dev = 0;
 
-    g_last_error = 0;
+    for (int k = 0; k <= (pd->readingsNum - 1) / 2; k++)
+    {
+        if (r >= pd->readingsNum || (l >= 0 && median - pd->sorted[l] <= pd->sorted[r] - median))
+        {
+            dev = median - pd->sorted[l--];
+        }
+        else
+        {
+            dev = pd->sorted[r++] - median;
+        }
+    }
+    return dev;
+}
 
-    // EMA 필터 초기화 플래그 설정
-    // g_filter_initialized = FALSE; 
+/* Hampel 필터. outlier 는 창에 넣지 않고 지금 창의 평균을 그대로 낸다.
+ * 창 절반을 넘게 연달아 벗어나면 튄 값이 아니라 벽이 바뀐 것으로 보고 새 값부터 다시 채운다 */
+static uint32 getFilteredDistance(PdController *pd, int distance)
+{
+    uint32 value = (uint32)distance;
 
-    // 유효한 거리 값으로 필터 초기화
-    int ultDis = getDistanceByUltra(ultDir);
-    if (ultDis < 0) ultDis = getDistanceByUltra(ultDir); // 재시도
+    if (pd->readingsNum >= PD_HAMPEL_MIN_READINGS)
+    {
+        uint32 median = filterMedian(pd);
+        uint32 limit = filterMad(pd, median) * PD_HAMPEL_K_X100 / 100;
+        uint32 dev = (value > median) ? value - median : median - value;
+
+        if (limit < PD_HAMPEL_MIN_DEV)
+        {
+            limit = PD_HAMPEL_MIN_DEV;
+        }
+
+        if (dev > limit)
+        {
+            pd->rejected++;
+            pd->outlierRun++;
+            if (pd->outlierRun <= pd->windowSize / 2)
+            {
+                return pd->total / (uint32)pd->readingsNum;
+            }
+            pd->readingsNum = 0;
+            pd->readIndex = 0;
+            pd->total = 0;
+        }
+    }
+    pd->outlierRun = 0;
 
-    // 필터를 첫 번째 유효한 값으로 설정 (getFilteredDistance 내부 로직이 처리)
-    g_previous_filtered_distance = getFilteredDistance(ultDis);
-    // 이 호출로 g_filter_initialized = TRUE가 되고,
-    // g_current_filtered_distance가 ultDis로 설정되며,
-    // g_previous_filtered_distance도 동일한 값으로 설정됩니다.
-    g_targetDistance = g_previous_filtered_distance;
+    filterPush(pd, value);
+    return pd->total / (uint32)pd->readingsNum;
 }
 
-
-// --- [시작] 새 pd_calculateSteeringMv 함수로 교체 ---
-int pd_calculateSteeringMv(int ultDis, LevelDir dir)
+/* 필터 업데이트, 오차, 비정상 값 체크. MV 를 계산해야 하면 TRUE, 0 을 내야 하면 FALSE */
+static boolean pdUpdateError(PdController *pd, int ultDis)
 {
-    DEBUG_PRINTF("[getMv] ultDis: %d\n", ultDis);
-    
-    // 1. 새 거리 값으로 필터 업데이트
-    g_current_filtered_distance = getFilteredDistance(ultDis);
+    pd->lastRaw = ultDis;
+
+    if (pd->resetPending)
+    {
+        pdReset(pd, ultDis);
+        pd->output = 0;
+        return FALSE;
+    }
 
-    DEBUG_PRINTF("[getMv] curfilteredDistance: %f\n", g_current_filtered_distance);
+    // 1. 새 거리 값으로 필터 업데이트
+    PROFILE_BEGIN(PROFILE_FILTER);
+    pd->filteredDistance = getFilteredDistance(pd, ultDis);
+    PROFILE_END(PROFILE_FILTER);
 
-    // 2. 에러 계산 (float으로 수행, 로직은 동일)
-    g_error = g_targetDistance - g_current_filtered_distance;
+    // 2. 에러 계산 (부호 있는 정수, 10ns 단위)
+    pd->error = (sint32)(pd->targetDistance - pd->filteredDistance);
 
     // 3. 비정상 값 체크
-    if (g_error >= (float)ABNORMAL_DIFF || g_error <= (float)-ABNORMAL_DIFF)
+    if (pd->error >= ABNORMAL_DIFF || pd->error <= -ABNORMAL_DIFF)
     {
-        pd_init(dir);
-        return 0;
+        pd->resetPending = TRUE;
+        pd->output = 0;
+        return FALSE;
     }
 
-    g_derivative = g_error - g_last_error;
+    pd->derivative = pd->error - pd->lastError;
+    pd->lastError = pd->error;
+    return TRUE;
+}
 
-    float p_term = g_Kp * g_error;
-    float d_term = g_Kd * g_derivative;
+/* kp * error + kd * derivative 를 MV_MIN..MV_MAX 로 자른다 */
+static int pdLawFloat(PdController *pd)
+{
+    float p_term = pd->kp * pd->error;
+    float d_term = pd->kd * pd->derivative;
 
     float unconstrained_output = p_term + d_term;
 
-    // // 6. Anti-Windup
-    // if ((unconstrained_output > (float)MV_MAX && g_error > 0) ||
-    //     (unconstrained_output < (float)MV_MIN && g_error < 0))
-    // {
-    //     // Windup occurs
-    // }
-    // else
-    // {
-    //     // Ki=0이므로 이 부분은 현재 중요하지 않음
-    //     g_integral += g_error; 
-    // }
-
-    // 7. Saturation (출력 제한)
+    // Saturation (출력 제한)
     int output;
     if (unconstrained_output > (float)MV_MAX)
     {
@@ -241,14 +282,300 @@ int pd_calculateSteeringMv(int ultDis, LevelDir dir)
         output = (int)unconstrained_output;
     }
 
-    // 8. 상태 업데이트 (다음 루프 준비)
-    g_last_error = g_error;
-    g_previous_filtered_distance = g_current_filtered_distance;
+    pd->output = output;
+    return output;
+}
+
+/* pdLawFloat() 과 같은 법칙을 정수로. 곱은 64비트로 누적해서 넘치지 않고,
+ * MV_MIN..MV_MAX 로 자른 뒤 float 의 (int) 변환처럼 0 쪽으로 버린다 */
+static int pdLawQ16(PdController *pd)
+{
+    sint64 sum = (sint64)pd->kpQ16 * pd->error + (sint64)pd->kdQ16 * pd->derivative;
+
+    int output;
+    if (sum > (sint64)MV_MAX * PD_Q16_ONE)
+    {
+        output = MV_MAX;
+    }
+    else if (sum < (sint64)MV_MIN * PD_Q16_ONE)
+    {
+        output = MV_MIN;
+    }
+    else
+    {
+        output = (int)(sum / PD_Q16_ONE);
+    }
 
-    bluetoothPrintf("%d,%d,%d\n", g_error, g_derivative, output);
+    pd->output = output;
     return output;
 }
 
+static sint16 clamp16(int value)
+{
+    if (value > 32767) return 32767;
+    if (value < -32768) return -32768;
+    return (sint16)value;
+}
+
+/*********************************************************************************************************************/
+/*-------------------------------------------Public Function Implementations-----------------------------------------*/
+/*********************************************************************************************************************/
+
+/* 게인만 남기고 필터와 오차를 모두 비운다. 첫 pdReset() 전에 한 번 호출 */
+void pdInit(PdController *pd, float kp, float kd)
+{
+    memset(pd, 0, sizeof(*pd));
+    pd->windowSize = PD_FILTER_SIZE;
+    pdSetGain(pd, kp, kd);
+}
+
+/* 새 거리 값을 필터에 넣고 그 필터 값을 목표 거리로 잡는다. 필터에 남은 이전 값은 그대로 둔다 */
+void pdReset(PdController *pd, int ultDis)
+{
+    pd->resetPending = FALSE;
+    pd->lastError = 0;
+    pd->filteredDistance = getFilteredDistance(pd, ultDis);
+    pd->targetDistance = pd->filteredDistance;
+}
+
+void pdSetGain(PdController *pd, float kp, float kd)
+{
+    pd->kp = kp;
+    pd->kd = kd;
+    pd->kpQ16 = pdGainToQ16(kp);
+    pd->kdQ16 = pdGainToQ16(kd);
+}
+
+void pdSetTarget(PdController *pd, uint32 distance)
+{
+    pd->targetDistance = distance;
+}
+
+/* 필터 창 길이 (1..PD_FILTER_MAX). 창을 비우므로 다음 pdReset() 전에 호출 */
+void pdSetWindow(PdController *pd, int size)
+{
+    if (size < 1)
+    {
+        size = 1;
+    }
+    if (size > PD_FILTER_MAX)
+    {
+        size = PD_FILTER_MAX;
+    }
+    pd->windowSize = size;
+    pd->readingsNum = 0;
+    pd->readIndex = 0;
+    pd->total = 0;
+    pd->outlierRun = 0;
+}
+
+/* 거리 한 샘플로 조향 MV 계산. 튄 값은 필터가 버리고, 벽 자체가 바뀌어 필터 값이 목표에서
+ * ABNORMAL_DIFF 이상 벗어나면 0 을 내고 다음 샘플로 다시 잡는다 (센서를 다시 재지 않는다) */
+int pdStep(PdController *pd, int ultDis)
+{
+#if PD_FIXED_POINT
+    return pdStepQ16(pd, ultDis);
+#else
+    return pdStepFloat(pd, ultDis);
+#endif
+}
+
+int pdStepFloat(PdController *pd, int ultDis)
+{
+    if (pdUpdateError(pd, ultDis) == FALSE)
+    {
+        return 0;
+    }
+    return pdLawFloat(pd);
+}
+
+int pdStepQ16(PdController *pd, int ultDis)
+{
+    if (pdUpdateError(pd, ultDis) == FALSE)
+    {
+        return 0;
+    }
+    return pdLawQ16(pd);
+}
+
+/* 필터 대신 추정기가 낸 거리와 주기당 거리 변화량 (둘 다 10ns echo 폭) 으로 계산.
+ * 목표를 다시 잡지 않고 계속 목표 거리로 되돌린다 */
+int pdStepRate(PdController *pd, int distance, int rate)
+{
+    pd->lastRaw = distance;
+    pd->filteredDistance = (distance > 0) ? (uint32)distance : 0;
+    pd->error = (sint32)pd->targetDistance - distance;
+    pd->derivative = -rate;
+    pd->lastError = pd->error;
+
+#if PD_FIXED_POINT
+    return pdLawQ16(pd);
+#else
+    return pdLawFloat(pd);
+#endif
+}
+
+/* 가장 가까운 Q16.16 값 (0.5 는 0 에서 먼 쪽). 범위를 넘으면 포화 */
+sint32 pdGainToQ16(float gain)
+{
+    float scaled = gain * (float)PD_Q16_ONE;
+
+    if (scaled >= (float)PD_GAIN_Q16_MAX)
+    {
+        return PD_GAIN_Q16_MAX;
+    }
+    if (scaled <= -(float)PD_GAIN_Q16_MAX)
+    {
+        return -PD_GAIN_Q16_MAX;
+    }
+    return (sint32)((scaled >= 0.0f) ? (scaled + 0.5f) : (scaled - 0.5f));
+}
+
+/* 마지막 pdStep() 결과와 그 주기의 바퀴 duty 를 TELEMETRY_TYPE_PD 프레임으로 전송.
+ * payload (LE): time_us u32, raw_us s16, filtered_us s16, error s16, derivative s16, mv s16, duty_left s16, duty_right s16
+ * 거리는 echo 폭 [us] (캡처 분해능), error/derivative 는 10ns 단위 그대로 */
+void pdSendTrace(const PdController *pd, int dutyLeft, int dutyRight)
+{
+    uint8 payload[PD_TRACE_SIZE];
+    uint8 *p = payload;
+
+    p = telemetryPut32(p, (uint32)(getTime10Ns() / 100));
+    p = telemetryPut16(p, (uint16)clamp16(pd->lastRaw / 100));
+    p = telemetryPut16(p, (uint16)clamp16((int)(pd->filteredDistance / 100)));
+    p = telemetryPut16(p, (uint16)clamp16(pd->error));
+    p = telemetryPut16(p, (uint16)clamp16(pd->derivative));
+    p = telemetryPut16(p, (uint16)clamp16(pd->output));
+    p = telemetryPut16(p, (uint16)clamp16(dutyLeft));
+    p = telemetryPut16(p, (uint16)clamp16(dutyRight));
+
+    telemetrySend(TELEMETRY_TYPE_PD, payload, PD_TRACE_SIZE);
+}
+
+/*--------------------------------------------- 기본 인스턴스 wrapper ---------------------------------------------*/
+
+void pd_printState(void)
+{
+    bluetoothPrintf("Cur Gain: %f\t%f\n", g_pd[LEVEL_LEFT].kp, g_pd[LEVEL_LEFT].kd);
+    myPrintf("Cur Gain: %f\t%f\n", g_pd[LEVEL_LEFT].kp, g_pd[LEVEL_LEFT].kd);
+    bluetoothPrintf("Outliers: %u\t%u\n", (unsigned)g_pd[LEVEL_LEFT].rejected, (unsigned)g_pd[LEVEL_RIGHT].rejected);
+}
+
+/* n = 0 이면 Kp, 1 이면 Kd. 양쪽 기본 인스턴스에 같이 적용 */
+void pd_setGain(int n, float i)
+{
+    for (int dir = 0; dir < LEVEL_DIR_NUM; dir++)
+    {
+        if (n == 0)
+        {
+            pdSetGain(&g_pd[dir], i, g_pd[dir].kd);
+        }
+        if (n == 1)
+        {
+            pdSetGain(&g_pd[dir], g_pd[dir].kp, i);
+        }
+    }
+    if (n == 0)
+    {
+        bluetoothPrintf("cur Kp: %f\n", g_pd[LEVEL_LEFT].kp);
+    }
+    if (n == 1)
+    {
+        bluetoothPrintf("cur Kd: %f\n", g_pd[LEVEL_LEFT].kd);
+    }
+}
+
+/* n = 0 이면 Kp, 1 이면 Kd (왼쪽 기본 인스턴스, pd_setGain() 으로 양쪽이 같다) */
+float pd_getGain(int n)
+{
+    return (n == 0) ? g_pd[LEVEL_LEFT].kp : g_pd[LEVEL_LEFT].kd;
+}
+
+void updateTargetDistance(uint32 distance)
+{
+    pdSetTarget(&g_pd[LEVEL_LEFT], distance);
+}
+
+/* 새 주행의 시작. 센서를 기다리지 않고 목표 거리만 비운다. 목표는 pd_seed() 가 모은 측정값으로 잡고,
+ * 그 전까지 pd_steerByEstimate() 는 0 (직진) */
+void pd_init(LevelDir dir)
+{
+    g_seedNum[dir] = 0;
+}
+
+/* pd_init() 다음 그 쪽 측정값을 주기마다 넣는다. 목표 거리가 튀는 echo 에 끌려가지 않도록 PD_INIT_READINGS 개를
+ * 모아 가운데 값으로 필터와 목표를 잡는다. 잡혔으면 TRUE (그 뒤 값은 무시). echo 없음 (-1) 은 세지 않는다 */
+boolean pd_seed(LevelDir dir, int ultDis)
+{
+    int *readings = g_seed[dir];
+    int n = g_seedNum[dir];
+
+    if (n >= PD_INIT_READINGS)
+    {
+        return TRUE;
+    }
+    if (ultDis < 0)
+    {
+        return FALSE;
+    }
+
+    int j = n;
+    for (; j > 0 && readings[j - 1] > ultDis; j--)
+    {
+        readings[j] = readings[j - 1];
+    }
+    readings[j] = ultDis;
+    g_seedNum[dir] = ++n;
+    if (n < PD_INIT_READINGS)
+    {
+        return FALSE;
+    }
+
+    // 지난 주행의 필터 창이 남아 있으면 새 목표가 예전 거리로 끌려간다. 창을 비우고 가운데 값으로 시작
+    PdController *pd = &g_pd[dir];
+    int start = readings[PD_INIT_READINGS / 2];
+
+    pdSetWindow(pd, pd->windowSize);
+    pdReset(pd, start);
+    pdSetTarget(pd, (uint32)start);
+    return TRUE;
+}
+
+int pd_calculateSteeringMv(int ultDis, LevelDir dir)
+{
+    PROFILE_BEGIN(PROFILE_PD_STEER);
+    g_lastDir = dir;
+    int mv = pdStep(&g_pd[dir], ultDis);
+    PROFILE_END(PROFILE_PD_STEER);
+    return mv;
+}
+
+/* 추정기의 벽 거리와 변화량으로 조향. 그 쪽 벽을 아직 못 봤거나 pd_seed() 가 목표를 잡기 전이면 0.
+ * 오른쪽 벽은 가까워질 때 왼쪽으로 돌아야 하므로 부호를 바꾼다 */
+int pd_steerByEstimate(const WallEstimator *est, LevelDir dir)
+{
+    UltraDir side = (dir == LEVEL_LEFT) ? ULT_LEFT : ULT_RIGHT;
+
+    if (wallEstIsValid(est, side) == FALSE || g_seedNum[dir] < PD_INIT_READINGS)
+    {
+        return 0;
+    }
+
+    PROFILE_BEGIN(PROFILE_PD_STEER);
+    int distance = (int)(wallEstGetDistance(est, side) / ULT_MM_PER_TICK);
+    int rate = (int)(wallEstGetRate(est, side) / ULT_MM_PER_TICK);
+    int mv = pdStepRate(&g_pd[dir], distance, rate);
+    PROFILE_END(PROFILE_PD_STEER);
+
+    g_pd[dir].lastRaw = est->lastEcho[side];   // 트레이스에는 추정값과 함께 실제 echo 를 남긴다
+    g_lastDir = dir;
+    return (dir == LEVEL_LEFT) ? mv : -mv;
+}
+
+void pd_sendTrace(int dutyLeft, int dutyRight)
+{
+    pdSendTrace(&g_pd[g_lastDir], dutyLeft, dutyRight);
+}
+
 
 
 
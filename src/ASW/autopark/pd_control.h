@@ -7,6 +7,24 @@
 
 #include "Ifx_Types.h"
 #include "ultrasonic.h" // UltraDir 타입을 위해 포함
+#include "wall_estimator.h"
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------Macros-------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#define PD_FILTER_MAX 15         // pdSetWindow() 로 줄 수 있는 최대 창 길이
+#define PD_FILTER_SIZE 6         // 기본 창 길이 (예전 이동 평균과 같은 6)
+#define PD_DEFAULT_KP 0.0f       // 기본 인스턴스와 autopark 보정 페이지의 기본 게인
+#define PD_DEFAULT_KD 0.2f
+
+/* 1 이면 pdStep() 이 고정소수점 (게인 Q16.16, 정수 필터) 으로 계산한다.
+ * 고정소수점 경로는 정수 연산만 쓰므로 호스트와 타깃 결과가 비트 단위로 같다 */
+#ifndef PD_FIXED_POINT
+#define PD_FIXED_POINT 0
+#endif
+
+#define PD_Q16_ONE 65536
 
 /*********************************************************************************************************************/
 /*-------------------------------------------------Type Definitions--------------------------------------------------*/
@@ -14,19 +32,73 @@
 
 typedef enum {
     LEVEL_LEFT,
-    LEVEL_RIGHT
+    LEVEL_RIGHT,
+    LEVEL_DIR_NUM
 } LevelDir;
 
+/* 벽 하나를 따라가는 PD 제어기. 상태는 모두 인스턴스 안에 있고 pd* 함수는 로그를 쓰지 않는다 (버린 샘플은 rejected 로 센다).
+ * 인스턴스 밖으로 나가는 것은 CPU0 의 profile 표 (PROFILE_FILTER) 와 pdSendTrace() 의 텔레메트리뿐이므로,
+ * CPU0 밖에서 돌리는 인스턴스는 PROFILE_ENABLE=0 으로 빌드하고 pdSendTrace() 를 부르지 않는다.
+ * 거리 단위는 ultrasonic 과 같은 10ns echo 폭 */
+typedef struct
+{
+    float kp;
+    float kd;
+    sint32 kpQ16;           // kp, kd 를 Q16.16 으로 반올림한 값 (고정소수점 경로)
+    sint32 kdQ16;
+    int windowSize;
+
+    // Hampel 필터: 들어온 순서 (ring) 와 정렬된 창을 같이 갱신한다. 중앙값/MAD 로 판정, 출력은 창 평균
+    uint32 readings[PD_FILTER_MAX];
+    uint32 sorted[PD_FILTER_MAX];
+    int readIndex;
+    int readingsNum;
+    int outlierRun;         // 연속으로 버린 샘플 수
+    uint32 rejected;        // 버린 샘플 누계
+    uint32 total;           // 창 안 값의 합 (출력은 평균)
+
+    uint32 targetDistance;
+    uint32 filteredDistance;
+
+    // 마지막 계산 값 (텔레메트리용)
+    int lastRaw;
+    int error;
+    int lastError;
+    int derivative;
+    int output;
+    boolean resetPending;   // 비정상 값 다음 샘플로 pdReset()
+} PdController;
+
 /*********************************************************************************************************************/
 /*-------------------------------------------Function Prototypes-----------------------------------------------------*/
 /*********************************************************************************************************************/
 
+/* 인스턴스 API */
+void pdInit(PdController *pd, float kp, float kd);
+void pdReset(PdController *pd, int ultDis);
+void pdSetGain(PdController *pd, float kp, float kd);
+void pdSetTarget(PdController *pd, uint32 distance);
+void pdSetWindow(PdController *pd, int size);
+int pdStep(PdController *pd, int ultDis);
+int pdStepFloat(PdController *pd, int ultDis);
+int pdStepQ16(PdController *pd, int ultDis);
+int pdStepRate(PdController *pd, int distance, int rate);
+sint32 pdGainToQ16(float gain);
+void pdSendTrace(const PdController *pd, int dutyLeft, int dutyRight);
+
+/* 기본 인스턴스 (방향별 하나씩) 를 쓰는 기존 API */
 void pd_init(LevelDir dir);
+boolean pd_seed(LevelDir dir, int ultDis);
 
 void pd_printState(void);
 
 void pd_setGain(int n, float i);
+float pd_getGain(int n);
 
 int pd_calculateSteeringMv(int ultDis, LevelDir dir);
 
+int pd_steerByEstimate(const WallEstimator *est, LevelDir dir);
+
+void pd_sendTrace(int dutyLeft, int dutyRight);
+
 #endif /* PID_CONTROL_H_ */
\ No newline at end of file
@@ -0,0 +1,113 @@
+/*********************************************************************************************************************/
+/*-----------------------------------------------------Includes------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#include "plan_bench.h"
+#include "path_planner.h"
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------Macros-------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#define PLAN_BENCH_NUM(a) (sizeof(a) / sizeof((a)[0]))
+
+/*********************************************************************************************************************/
+/*--------------------------------------------Private Variables/Constants--------------------------------------------*/
+/*********************************************************************************************************************/
+
+/* 공간이 뒤/앞 멀리 (직선이 길다), 좁고 얕은 공간 (모든 반경 실패), 벽이 가깝거나 먼 경우까지 */
+static const int g_benchGapStart[] = { -1500, -600, 0, 600, 1500 };
+static const int g_benchGapLength[] = { 200, 330, 500, 800 };
+static const int g_benchGapDepth[] = { 150, 400, 700 };
+static const int g_benchWallOffset[] = { 150, 250, 400 };
+static const int g_benchRadius[] = { 50, 150, 300 };
+
+static Path g_benchPath;
+
+/*********************************************************************************************************************/
+/*------------------------------------------Private Function Implementations-----------------------------------------*/
+/*********************************************************************************************************************/
+
+static uint32 benchHash(uint32 hash, int value)
+{
+    return (hash ^ (uint32)value) * 16777619u;
+}
+
+/*********************************************************************************************************************/
+/*-------------------------------------------Public Function Implementations-----------------------------------------*/
+/*********************************************************************************************************************/
+
+/* index 번째 경우의 입력. 순서는 mode, 시작, 길이, 깊이, 벽 거리, 반경 (뒤쪽이 빨리 바뀐다) */
+void planBenchDescribe(uint32 index, int *mode, int *gapStart, int *gapLength, int *gapDepth, int *wallOffset, int *radius)
+{
+    *radius = g_benchRadius[index % PLAN_BENCH_NUM(g_benchRadius)];
+    index /= PLAN_BENCH_NUM(g_benchRadius);
+    *wallOffset = g_benchWallOffset[index % PLAN_BENCH_NUM(g_benchWallOffset)];
+    index /= PLAN_BENCH_NUM(g_benchWallOffset);
+    *gapDepth = g_benchGapDepth[index % PLAN_BENCH_NUM(g_benchGapDepth)];
+    index /= PLAN_BENCH_NUM(g_benchGapDepth);
+    *gapLength = g_benchGapLength[index % PLAN_BENCH_NUM(g_benchGapLength)];
+    index /= PLAN_BENCH_NUM(g_benchGapLength);
+    *gapStart = g_benchGapStart[index % PLAN_BENCH_NUM(g_benchGapStart)];
+    index /= PLAN_BENCH_NUM(g_benchGapStart);
+    *mode = (int)index;
+}
+
+/* 두 주차 방식 x 공간/벽/반경 격자의 모든 경우를 한 번씩 계획하고, 한 번에 걸린 최악 시간을 잰다 */
+void planBenchRun(PlanBenchClock clock, PlanBenchResult *result)
+{
+    const OdometryPose pose = { 1000.0f, 200.0f, 0.1f, 1500.0f };
+    uint32 cases = 2 * PLAN_BENCH_NUM(g_benchGapStart) * PLAN_BENCH_NUM(g_benchGapLength) *
+                   PLAN_BENCH_NUM(g_benchGapDepth) * PLAN_BENCH_NUM(g_benchWallOffset) * PLAN_BENCH_NUM(g_benchRadius);
+
+    result->plans = 0;
+    result->ok = 0;
+    result->maxPoints = 0;
+    result->worstTicks = 0;
+    result->totalTicks = 0;
+    result->worstCase = 0;
+    result->checksum = 2166136261u;
+
+    for (uint32 i = 0; i < cases; i++)
+    {
+        PlanScene scene;
+        PlanConfig config;
+        int mode, gapStart, gapLength, gapDepth, wallOffset, radius;
+
+        planBenchDescribe(i, &mode, &gapStart, &gapLength, &gapDepth, &wallOffset, &radius);
+        scene.wallHeading = 0.05f;
+        scene.wallOffset = (float32)wallOffset;
+        scene.gapStart = (float32)gapStart;
+        scene.gapEnd = (float32)(gapStart + gapLength);
+        scene.gapDepth = (float32)gapDepth;
+        config.mode = (mode != 0) ? PARK_PARALLEL : PARK_PERPENDICULAR;
+        config.radius = (float32)radius;
+        config.depth = 200.0f;
+
+        uint64 start = clock();
+        PlanResult plan = planPark(&g_benchPath, &pose, &scene, &config);
+        uint64 ticks = clock() - start;
+
+        result->plans++;
+        result->totalTicks += ticks;
+        if (ticks > result->worstTicks)
+        {
+            result->worstTicks = ticks;
+            result->worstCase = i;
+        }
+        if (g_benchPath.count > result->maxPoints)
+        {
+            result->maxPoints = g_benchPath.count;
+        }
+
+        result->checksum = benchHash(result->checksum, (int)plan);
+        result->checksum = benchHash(result->checksum, (int)g_benchPath.count);
+        if (plan == PLAN_OK)
+        {
+            const PathPoint *last = &g_benchPath.points[g_benchPath.count - 1];
+            result->ok++;
+            result->checksum = benchHash(result->checksum, (int)last->x);
+            result->checksum = benchHash(result->checksum, (int)last->y);
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef PLAN_BENCH_H_
+#define PLAN_BENCH_H_
+
+/*********************************************************************************************************************/
+/*-----------------------------------------------------Includes------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#include "Ifx_Types.h"
+
+/*********************************************************************************************************************/
+/*-------------------------------------------------Type Definitions--------------------------------------------------*/
+/*********************************************************************************************************************/
+
+/* 단조 증가하는 시계. 타깃은 getTime10Ns() (STM0), 호스트는 clock_gettime 등 */
+typedef uint64 (*PlanBenchClock)(void);
+
+typedef struct
+{
+    uint32 plans;           // planPark() 호출 수
+    uint32 ok;              // PLAN_OK 인 수
+    uint32 maxPoints;       // 가장 긴 경로의 점 수
+    uint64 worstTicks;      // 한 번의 planPark() 에 걸린 가장 긴 시계 값
+    uint64 totalTicks;
+    uint32 worstCase;       // worstTicks 인 경우의 번호 (planBenchDescribe)
+    uint32 checksum;        // 결과 코드, 점 수, 끝점 [mm] 의 해시. float 경로라 컴파일러/FPU 에 따라 다를 수 있다
+} PlanBenchResult;
+
+/*********************************************************************************************************************/
+/*-------------------------------------------Function Prototypes-----------------------------------------------------*/
+/*********************************************************************************************************************/
+
+void planBenchRun(PlanBenchClock clock, PlanBenchResult *result);
+void planBenchDescribe(uint32 index, int *mode, int *gapStart, int *gapLength, int *gapDepth, int *wallOffset, int *radius);
+
+#endif /* PLAN_BENCH_H_ */
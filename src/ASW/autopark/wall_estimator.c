@@ -0,0 +1,163 @@
+/*********************************************************************************************************************/
+/*-----------------------------------------------------Includes------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#include "wall_estimator.h"
+
+#include <math.h>
+#include <string.h>
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------Macros-------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#define WALL_EST_R (3.0f * 3.0f)                // 측정 잡음 [mm^2]
+#define WALL_EST_Q_DIST (0.5f * 0.5f)           // 주기당 벽 굴곡 [mm^2]
+#define WALL_EST_Q_HEADING (0.002f * 0.002f)    // 주기당 엔코더 heading 오차, 미끄러짐 [rad^2]
+#define WALL_EST_P0_HEADING (0.05f * 0.05f)     // 시작 heading 불확실성 (약 3도)
+#define WALL_EST_GATE 3.0f                      // 혁신이 이 sigma 배를 넘으면 버린다
+#define WALL_EST_REJECT_MAX 5                   // 연달아 이만큼 버리면 벽이 바뀐 것으로 보고 다시 잡는다
+#define WALL_EST_RANGE_MAX 1000.0f              // 이보다 먼 echo 는 벽으로 보지 않는다 [mm]
+
+/*********************************************************************************************************************/
+/*------------------------------------------Private Function Implementations-----------------------------------------*/
+/*********************************************************************************************************************/
+
+/* 거리 상태 i 를 측정값으로 새로 잡는다. 다른 상태와의 상관은 버린다 */
+static void wallEstSeed(WallEstimator *est, int i, float32 z)
+{
+    for (int k = 0; k < WALL_EST_STATES; k++)
+    {
+        est->P[i][k] = 0.0f;
+        est->P[k][i] = 0.0f;
+    }
+    est->x[i] = z;
+    est->P[i][i] = WALL_EST_R;
+    est->valid[i] = TRUE;
+    est->rejectRun[i] = 0;
+}
+
+/*********************************************************************************************************************/
+/*-------------------------------------------Public Function Implementations-----------------------------------------*/
+/*********************************************************************************************************************/
+
+/* 벽과 나란하다고 보고 시작. 거리는 첫 echo 가 들어올 때 잡는다 */
+void wallEstInit(WallEstimator *est, const OdometryPose *pose)
+{
+    memset(est, 0, sizeof(*est));
+    est->P[WALL_EST_HEADING][WALL_EST_HEADING] = WALL_EST_P0_HEADING;
+    est->lastPose = *pose;
+}
+
+/* 제어 주기마다. 직전 호출 이후의 odometry 이동량으로 상태와 공분산을 민다 */
+void wallEstPredict(WallEstimator *est, const OdometryPose *pose)
+{
+    float32 step = pose->distance - est->lastPose.distance;
+    float32 turn = pose->heading - est->lastPose.heading;
+    float32 mid = est->x[WALL_EST_HEADING] + turn * 0.5f;
+    float32 side = step * sinf(mid);
+    float32 slope = step * cosf(mid);   // d(거리)/d(heading)
+    float32 P[WALL_EST_STATES][WALL_EST_STATES];
+
+    est->lastPose = *pose;
+    est->lastStep = step;
+
+    est->x[WALL_EST_LEFT] -= side;
+    est->x[WALL_EST_RIGHT] += side;
+    est->x[WALL_EST_HEADING] += turn;
+
+    // P = F P F' + Q,  F = I + [0 0 -slope; 0 0 slope; 0 0 0]
+    const float32 f[WALL_EST_STATES] = {-slope, slope, 0.0f};
+    for (int r = 0; r < WALL_EST_STATES; r++)
+    {
+        for (int c = 0; c < WALL_EST_STATES; c++)
+        {
+            P[r][c] = est->P[r][c] + f[r] * est->P[WALL_EST_HEADING][c] + f[c] * est->P[r][WALL_EST_HEADING]
+                      + f[r] * f[c] * est->P[WALL_EST_HEADING][WALL_EST_HEADING];
+        }
+    }
+    P[WALL_EST_LEFT][WALL_EST_LEFT] += WALL_EST_Q_DIST;
+    P[WALL_EST_RIGHT][WALL_EST_RIGHT] += WALL_EST_Q_DIST;
+    P[WALL_EST_HEADING][WALL_EST_HEADING] += WALL_EST_Q_HEADING;
+    memcpy(est->P, P, sizeof(P));
+}
+
+/* 측면 echo 하나로 보정 (echo 폭, 10ns). -1, 너무 먼 값, gate 밖이면 FALSE 이고 예측만 남는다 */
+boolean wallEstUpdate(WallEstimator *est, UltraDir side, int echo)
+{
+    int i = (side == ULT_LEFT) ? WALL_EST_LEFT : WALL_EST_RIGHT;
+
+    if ((side != ULT_LEFT && side != ULT_RIGHT) || echo < 0)
+    {
+        return FALSE;
+    }
+
+    float32 z = (float32)echo * ULT_MM_PER_TICK;
+
+    est->lastEcho[i] = echo;
+    if (z > WALL_EST_RANGE_MAX)
+    {
+        return FALSE;
+    }
+
+    if (est->valid[i] == FALSE)
+    {
+        wallEstSeed(est, i, z);
+        return TRUE;
+    }
+
+    float32 y = z - est->x[i];
+    float32 s = est->P[i][i] + WALL_EST_R;
+
+    if (y * y > WALL_EST_GATE * WALL_EST_GATE * s)
+    {
+        est->rejected++;
+        if (++est->rejectRun[i] >= WALL_EST_REJECT_MAX)
+        {
+            wallEstSeed(est, i, z);
+        }
+        return FALSE;
+    }
+    est->rejectRun[i] = 0;
+
+    // 스칼라 측정 (H = e_i): K = P(:, i) / s,  P -= K P(i, :)
+    float32 k[WALL_EST_STATES];
+    float32 row[WALL_EST_STATES];
+    for (int r = 0; r < WALL_EST_STATES; r++)
+    {
+        k[r] = est->P[r][i] / s;
+        row[r] = est->P[i][r];
+    }
+    for (int r = 0; r < WALL_EST_STATES; r++)
+    {
+        est->x[r] += k[r] * y;
+        for (int c = 0; c < WALL_EST_STATES; c++)
+        {
+            est->P[r][c] -= k[r] * row[c];
+        }
+    }
+    return TRUE;
+}
+
+boolean wallEstIsValid(const WallEstimator *est, UltraDir side)
+{
+    return (side == ULT_LEFT) ? est->valid[WALL_EST_LEFT] : est->valid[WALL_EST_RIGHT];
+}
+
+float32 wallEstGetDistance(const WallEstimator *est, UltraDir side)
+{
+    return (side == ULT_LEFT) ? est->x[WALL_EST_LEFT] : est->x[WALL_EST_RIGHT];
+}
+
+/* 직전 예측 한 주기 동안 그 쪽 벽 거리의 변화량 [mm/주기] */
+float32 wallEstGetRate(const WallEstimator *est, UltraDir side)
+{
+    float32 lateral = est->lastStep * sinf(est->x[WALL_EST_HEADING]);
+
+    return (side == ULT_LEFT) ? -lateral : lateral;
+}
+
+float32 wallEstGetHeading(const WallEstimator *est)
+{
+    return est->x[WALL_EST_HEADING];
+}
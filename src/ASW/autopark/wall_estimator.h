@@ -0,0 +1,55 @@
+#ifndef WALL_ESTIMATOR_H_
+#define WALL_ESTIMATOR_H_
+
+/*********************************************************************************************************************/
+/*-----------------------------------------------------Includes------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#include "Ifx_Types.h"
+#include "odometry.h"
+#include "ultrasonic.h"
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------Macros-------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#define WALL_EST_STATES 3
+
+/*********************************************************************************************************************/
+/*-------------------------------------------------Type Definitions--------------------------------------------------*/
+/*********************************************************************************************************************/
+
+typedef enum
+{
+    WALL_EST_LEFT,          // 왼쪽 벽까지 거리 [mm]
+    WALL_EST_RIGHT,         // 오른쪽 벽까지 거리 [mm]
+    WALL_EST_HEADING        // 벽에 대한 heading [rad], 반시계 (왼쪽 벽 쪽) 가 +
+} WallEstState;
+
+/* 좌우 측면 초음파와 엔코더 이동량을 합치는 EKF. 벽은 직선이고 좌우가 나란하다고 본다.
+ * 예측은 제어 주기마다 odometry 로, 보정은 새 echo 가 있을 때만 하므로 echo 가 빠져도 값이 나온다 */
+typedef struct
+{
+    float32 x[WALL_EST_STATES];
+    float32 P[WALL_EST_STATES][WALL_EST_STATES];
+    boolean valid[2];           // 그 쪽 벽 거리를 한 번이라도 받았는지
+    uint32 rejectRun[2];        // 연속으로 gate 에 걸린 수
+    uint32 rejected;
+    int lastEcho[2];            // 마지막으로 받은 echo (버린 것 포함, 텔레메트리용)
+    OdometryPose lastPose;
+    float32 lastStep;           // 직전 예측의 이동 거리 [mm]
+} WallEstimator;
+
+/*********************************************************************************************************************/
+/*-------------------------------------------Function Prototypes-----------------------------------------------------*/
+/*********************************************************************************************************************/
+
+void wallEstInit(WallEstimator *est, const OdometryPose *pose);
+void wallEstPredict(WallEstimator *est, const OdometryPose *pose);
+boolean wallEstUpdate(WallEstimator *est, UltraDir side, int echo);
+boolean wallEstIsValid(const WallEstimator *est, UltraDir side);
+float32 wallEstGetDistance(const WallEstimator *est, UltraDir side);
+float32 wallEstGetRate(const WallEstimator *est, UltraDir side);
+float32 wallEstGetHeading(const WallEstimator *est);
+
+#endif /* WALL_ESTIMATOR_H_ */
@@ -1,12 +1,56 @@
 #include "asclin0.h"
 
-//
-//IFX_INTERRUPT(asclin0RxIsrHandler, 0, ISR_PRIORITY_ASCLIN0_RX);
-//void asclin0RxIsrHandler(void)
-//{
-//    char c = asclin0InUart();
-//    asclin0OutUart(c);
-//}
+#define ASCLIN0_TX_FIFO_SIZE 16
+
+/* TX ring: asclin0Write() fills it, the TX interrupt drains it into the hardware FIFO. Both run on CPU2 */
+static unsigned char g_asclin0TxBuffer[ASCLIN0_TX_BUFFER_SIZE];
+static volatile uint32 g_asclin0TxHead = 0;
+static volatile uint32 g_asclin0TxTail = 0;
+
+/* RX ring: the RX interrupt fills it, asclin0PollUart() drains it at task level */
+static unsigned char g_asclin0RxBuffer[ASCLIN0_RX_BUFFER_SIZE];
+static volatile uint32 g_asclin0RxHead = 0;
+static volatile uint32 g_asclin0RxTail = 0;
+static volatile uint32 g_asclin0RxDropCount = 0;
+
+static int asclin0ReadRxData(unsigned char *chr);
+
+/* Refills the TX FIFO whenever it has drained; disables itself when the ring is empty */
+IFX_INTERRUPT(asclin0TxIsrHandler, 2, ISR_PRIORITY_ASCLIN0_TX);
+void asclin0TxIsrHandler(void)
+{
+    MODULE_ASCLIN0.FLAGSCLEAR.U = (IFX_ASCLIN_FLAGSCLEAR_TFLC_MSK << IFX_ASCLIN_FLAGSCLEAR_TFLC_OFF);
+
+    while (MODULE_ASCLIN0.TXFIFOCON.B.FILL < ASCLIN0_TX_FIFO_SIZE && g_asclin0TxTail != g_asclin0TxHead)
+    {
+        MODULE_ASCLIN0.TXDATA.U = g_asclin0TxBuffer[g_asclin0TxTail & (ASCLIN0_TX_BUFFER_SIZE - 1)];
+        g_asclin0TxTail++;
+    }
+    if (g_asclin0TxTail == g_asclin0TxHead)
+    {
+        MODULE_ASCLIN0.FLAGSENABLE.B.TFLE = 0;
+    }
+}
+
+/* Moves every received byte into the RX ring; bytes that do not fit are counted and dropped */
+IFX_INTERRUPT(asclin0RxIsrHandler, 0, ISR_PRIORITY_ASCLIN0_RX);
+void asclin0RxIsrHandler(void)
+{
+    unsigned char ch;
+
+    while (asclin0ReadRxData(&ch) != 0)
+    {
+        uint32 head = g_asclin0RxHead;
+
+        if (head - g_asclin0RxTail >= ASCLIN0_RX_BUFFER_SIZE)
+        {
+            g_asclin0RxDropCount++;
+            continue;
+        }
+        g_asclin0RxBuffer[head & (ASCLIN0_RX_BUFFER_SIZE - 1)] = ch;
+        g_asclin0RxHead = head + 1;
+    }
+}
 
 void asclin0InitUart(void)
 {
@@ -61,27 +105,62 @@ void asclin0InitUart(void)
 
     MODULE_ASCLIN0.FLAGSSET.U = (IFX_ASCLIN_FLAGSSET_TFLS_MSK << IFX_ASCLIN_FLAGSSET_TFLS_OFF);
 
+    /* Initialize ASCLIN0 TX interrupt on CPU2, enabled by asclin0Write() while the ring holds data */
+    g_asclin0TxHead = 0;
+    g_asclin0TxTail = 0;
+    volatile Ifx_SRC_SRCR *txSrc;
+    txSrc = (volatile Ifx_SRC_SRCR *)(&MODULE_SRC.ASCLIN.ASCLIN[0].TX);
+    txSrc->B.SRPN = ISR_PRIORITY_ASCLIN0_TX;
+    txSrc->B.TOS  = IfxSrc_Tos_cpu2;
+    txSrc->B.CLRR = 1; /* clear request */
+    txSrc->B.SRE = 1;  /* interrupt enable, gated by FLAGSENABLE.TFLE */
+
     /* Initialize ASCLIN0 RX interrupt */
-//    volatile Ifx_SRC_SRCR *src;
-//    src = (volatile Ifx_SRC_SRCR *)(&MODULE_SRC.ASCLIN.ASCLIN[0].RX);
-//    src->B.SRPN = ISR_PRIORITY_ASCLIN0_RX;
-//    src->B.TOS  = 0;
-//    src->B.CLRR = 1; /* clear request */
-//    MODULE_ASCLIN0.FLAGSENABLE.B.RFLE = 1; /* enable rx fifo fill level flag */
-//    src->B.SRE = 1; /* interrupt enable */
+    g_asclin0RxHead = 0;
+    g_asclin0RxTail = 0;
+    volatile Ifx_SRC_SRCR *src;
+    src = (volatile Ifx_SRC_SRCR *)(&MODULE_SRC.ASCLIN.ASCLIN[0].RX);
+    src->B.SRPN = ISR_PRIORITY_ASCLIN0_RX;
+    src->B.TOS  = IfxSrc_Tos_cpu0;
+    src->B.CLRR = 1; /* clear request */
+    MODULE_ASCLIN0.FLAGSENABLE.B.RFLE = 1; /* enable rx fifo fill level flag */
+    src->B.SRE = 1; /* interrupt enable */
 }
 
-/* Send character CHR via the serial line */
-void asclin0OutUart(const unsigned char chr)
+/* Queue LENGTH bytes for transmission without waiting.
+   All or nothing: returns 0 and queues nothing if the ring has no room for them.
+   Call from CPU2 task level only (uartSinkWrite()); the TX interrupt is the only consumer.
+ */
+uint32 asclin0Write(const unsigned char *data, uint32 length)
 {
-    /* wait until space is available in the FIFO */
-    while (!(MODULE_ASCLIN0.FLAGS.B.TFL != 0));
+    uint32 head = g_asclin0TxHead;
 
-    /* TX Clear */
-    MODULE_ASCLIN0.FLAGSCLEAR.U = (IFX_ASCLIN_FLAGSCLEAR_TFLC_MSK << IFX_ASCLIN_FLAGSCLEAR_TFLC_OFF);
+    if (length > ASCLIN0_TX_BUFFER_SIZE - (head - g_asclin0TxTail))
+    {
+        return 0;
+    }
+    for (uint32 i = 0; i < length; i++)
+    {
+        g_asclin0TxBuffer[(head + i) & (ASCLIN0_TX_BUFFER_SIZE - 1)] = data[i];
+    }
+    g_asclin0TxHead = head + length;
 
-    /* send the character */
-    MODULE_ASCLIN0.TXDATA.U = chr;
+    /* TFL is still set if the FIFO already drained, so this raises the interrupt right away */
+    MODULE_ASCLIN0.FLAGSENABLE.B.TFLE = 1;
+
+    return length;
+}
+
+/* Bytes asclin0Write() can queue right now (CPU2) */
+uint32 asclin0GetTxSpace(void)
+{
+    return ASCLIN0_TX_BUFFER_SIZE - (g_asclin0TxHead - g_asclin0TxTail);
+}
+
+/* Send character CHR via the serial line, waiting only while the TX ring is full (CPU2) */
+void asclin0OutUart(const unsigned char chr)
+{
+    while (asclin0Write(&chr, 1) == 0);
 }
 
 /* Receive (and wait for) a character from the serial line */
@@ -103,11 +182,35 @@ char asclin0InUartNonBlock(void)
     return res == 1 ? ch : -1;
 }
 
-/* Check the serial line if a character has been received.
+/* Take the next received character out of the RX ring.
    returns 1 and the character in *chr if there is one
    else 0
  */
 int asclin0PollUart(unsigned char *chr)
+{
+    uint32 tail = g_asclin0RxTail;
+
+    if (tail == g_asclin0RxHead)
+    {
+        return 0;
+    }
+    *chr = g_asclin0RxBuffer[tail & (ASCLIN0_RX_BUFFER_SIZE - 1)];
+    g_asclin0RxTail = tail + 1;
+
+    return 1;
+}
+
+/* Received bytes lost because the RX ring was full */
+uint32 asclin0GetRxDropCount(void)
+{
+    return g_asclin0RxDropCount;
+}
+
+/* Read one character from the hardware RX buffer (RX interrupt only).
+   returns 1 and the character in *chr if there is one
+   else 0
+ */
+static int asclin0ReadRxData(unsigned char *chr)
 {
     unsigned char ret;
     int res = 0;
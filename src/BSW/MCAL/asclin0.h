@@ -13,12 +13,18 @@
 #include "IfxAsclin_bf.h"
 #include "priority.h"
 
+#define ASCLIN0_TX_BUFFER_SIZE 1024     /* TX ring in bytes, power of two */
+#define ASCLIN0_RX_BUFFER_SIZE 128      /* RX ring in bytes, power of two */
 
 void asclin0InitUart(void);
+uint32 asclin0Write(const unsigned char *data, uint32 length);
+uint32 asclin0GetTxSpace(void);
 void asclin0OutUart(const unsigned char chr);
 int asclin0PollUart(unsigned char *chr);
+uint32 asclin0GetRxDropCount(void);
 unsigned char asclin0InUart(void);
 char asclin0InUartNonBlock(void);
 void asclin0RxIsrHandler(void);
+void asclin0TxIsrHandler(void);
 
 #endif /* BSW_DRIVER_ASCLIN_H_ */
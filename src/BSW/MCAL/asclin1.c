@@ -1,10 +1,16 @@
 #include "asclin1.h"
-#include "main0.h"
+#include "bluetooth.h"
 
-IFX_INTERRUPT(asclin1RxIsrHandler, 0, ISR_PRIORITY_ASCLIN1_RX);
+/* Serviced by CPU2, which owns the Bluetooth link */
+IFX_INTERRUPT(asclin1RxIsrHandler, 2, ISR_PRIORITY_ASCLIN1_RX);
 void asclin1RxIsrHandler (void)
 {
-    char data = asclin1InUart();
+    unsigned char ch;
+
+    while (asclin1PollUart(&ch) != 0)
+    {
+        bluetoothIsr((char) ch);
+    }
 }
 
 void asclin1InitUart (void)
@@ -65,7 +71,7 @@ void asclin1InitUart (void)
     volatile Ifx_SRC_SRCR *src;
     src = (volatile Ifx_SRC_SRCR*) (&MODULE_SRC.ASCLIN.ASCLIN[1].RX);
     src->B.SRPN = ISR_PRIORITY_ASCLIN1_RX;
-    src->B.TOS = 0;
+    src->B.TOS = IfxSrc_Tos_cpu2;
     src->B.CLRR = 1; /* clear request */
     MODULE_ASCLIN1.FLAGSENABLE.B.RFLE = 1; /* enable rx fifo fill level flag */
     src->B.SRE = 1; /* interrupt enable */
@@ -85,6 +91,12 @@ void asclin1OutUart (const unsigned char chr)
     MODULE_ASCLIN1.TXDATA.U = chr;
 }
 
+/* Nonzero if asclin1OutUart() would not have to wait */
+int asclin1TxReady (void)
+{
+    return MODULE_ASCLIN1.FLAGS.B.TFL != 0;
+}
+
 /* Receive (and wait for) a character from the serial line */
 unsigned char asclin1InUart (void)
 {
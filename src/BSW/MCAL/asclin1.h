@@ -9,8 +9,10 @@
 
 void asclin1InitUart(void);
 void asclin1OutUart(const unsigned char chr);
+int asclin1TxReady(void);
 unsigned char asclin1InUart(void);
 int asclin1PollUart(unsigned char *chr);
+void asclin1RxIsrHandler(void);
 
 
 #endif /* BSW_MCAL_ASCLIN1_H_ */
@@ -0,0 +1,75 @@
+#include "dflash.h"
+
+#include "IfxFlash.h"
+#include "IfxScuWdt.h"
+
+#include <string.h>
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------Macros-------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#define DFLASH_BASE     IFXFLASH_DFLASH_START
+#define DFLASH_MODULE   0
+
+/*********************************************************************************************************************/
+/*--------------------------------------------Function Implementations-----------------------------------------------*/
+/*********************************************************************************************************************/
+
+/* DF0 is memory mapped, so a read is a plain copy and takes no flash command */
+void dflashRead(uint32 offset, void *data, uint32 length)
+{
+    memcpy(data, (const void *)(DFLASH_BASE + offset), length);
+}
+
+/* Erases the logical sector at offset (a multiple of DFLASH_SECTOR_SIZE). Blocks until DF0 is idle again;
+ * the caller runs from PFLASH, which stays readable while the data flash bank is busy */
+boolean dflashEraseSector(uint32 offset)
+{
+    uint16 password = IfxScuWdt_getSafetyWatchdogPasswordInline();
+
+    if ((offset % DFLASH_SECTOR_SIZE) != 0 || offset >= DFLASH_SIZE)
+    {
+        return FALSE;
+    }
+
+    IfxScuWdt_clearSafetyEndinitInline(password);
+    IfxFlash_eraseSector(DFLASH_BASE + offset);
+    IfxScuWdt_setSafetyEndinitInline(password);
+    return IfxFlash_waitUnbusy(DFLASH_MODULE, IfxFlash_FlashType_D0) == 0;
+}
+
+/* Programs length bytes (whole pages, page aligned) into erased flash, one page per command sequence */
+boolean dflashWrite(uint32 offset, const void *data, uint32 length)
+{
+    uint16 password = IfxScuWdt_getSafetyWatchdogPasswordInline();
+    const uint8 *bytes = (const uint8 *)data;
+
+    if ((offset % DFLASH_PAGE_SIZE) != 0 || (length % DFLASH_PAGE_SIZE) != 0 || offset + length > DFLASH_SIZE)
+    {
+        return FALSE;
+    }
+
+    for (uint32 i = 0; i < length; i += DFLASH_PAGE_SIZE)
+    {
+        uint32 pageAddr = DFLASH_BASE + offset + i;
+        uint32 words[2];
+
+        memcpy(words, &bytes[i], sizeof(words));
+        if (IfxFlash_enterPageMode(pageAddr) != 0)
+        {
+            return FALSE;
+        }
+        IfxFlash_waitUnbusy(DFLASH_MODULE, IfxFlash_FlashType_D0);
+        IfxFlash_loadPage2X32(pageAddr, words[0], words[1]);
+
+        IfxScuWdt_clearSafetyEndinitInline(password);
+        IfxFlash_writePage(pageAddr);
+        IfxScuWdt_setSafetyEndinitInline(password);
+        if (IfxFlash_waitUnbusy(DFLASH_MODULE, IfxFlash_FlashType_D0) != 0)
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
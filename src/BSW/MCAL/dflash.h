@@ -0,0 +1,24 @@
+#ifndef BSW_MCAL_DFLASH_H_
+#define BSW_MCAL_DFLASH_H_
+
+#include "Ifx_Types.h"
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------Macros-------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+/* DF0 as seen from the CPU (IFXFLASH_DFLASH_*); offsets below are relative to its start */
+#define DFLASH_PAGE_SIZE    8           /* smallest programmable unit */
+#define DFLASH_SECTOR_SIZE  0x1000      /* smallest erasable unit (logical sector) */
+#define DFLASH_SIZE         0x40000     /* 64 logical sectors */
+#define DFLASH_ERASED_WORD  0u          /* TC3xx data flash reads 0 after erase */
+
+/*********************************************************************************************************************/
+/*-------------------------------------------Function Prototypes-----------------------------------------------------*/
+/*********************************************************************************************************************/
+
+void dflashRead(uint32 offset, void *data, uint32 length);
+boolean dflashEraseSector(uint32 offset);
+boolean dflashWrite(uint32 offset, const void *data, uint32 length);
+
+#endif /* BSW_MCAL_DFLASH_H_ */
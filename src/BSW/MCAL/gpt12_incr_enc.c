@@ -0,0 +1,82 @@
+#include "gpt12_incr_enc.h"
+
+#include "IfxGpt12_IncrEnc.h"
+
+/*********************************************************************************************************************/
+/*--------------------------------------------Private Variables/Constants--------------------------------------------*/
+/*********************************************************************************************************************/
+
+typedef struct
+{
+    IfxGpt12_TxIn_In *a;
+    IfxGpt12_TxEud_In *b;
+    boolean reversed;           /* the right encoder is mounted mirrored */
+} EncPins;
+
+static const EncPins ENC_PINS[ENC_WHEELS_NUM] = {
+        [ENC_LEFT] = {&IfxGpt120_T3INB_P10_4_IN, &IfxGpt120_T3EUDB_P10_7_IN, FALSE},
+        [ENC_RIGHT] = {&IfxGpt120_T2INA_P00_7_IN, &IfxGpt120_T2EUDA_P00_8_IN, TRUE}
+};
+
+static IfxGpt12_IncrEnc g_encDriver[ENC_WHEELS_NUM];
+static uint16 g_encLastTimer[ENC_WHEELS_NUM];
+static sint32 g_encCount[ENC_WHEELS_NUM];
+
+/*********************************************************************************************************************/
+/*--------------------------------------------Function Implementations-----------------------------------------------*/
+/*********************************************************************************************************************/
+
+static uint16 readTimer(EncWheel wheel)
+{
+    return wheel == ENC_LEFT ? IfxGpt12_T3_getTimerValue(&MODULE_GPT120) : IfxGpt12_T2_getTimerValue(&MODULE_GPT120);
+}
+
+/* Both wheels run in incremental interface mode with quadrature (four-fold) counting. The driver
+ * picks the timer from pin A: T3 for the left wheel (T5 measures the edge period at low speed)
+ * and T2 for the right one. PERIODUS is the interval at which gpt12IncrEncUpdate() is called. */
+void gpt12IncrEncInit(uint32 periodUs)
+{
+    IfxGpt12_IncrEnc_Config config;
+
+    IfxGpt12_enableModule(&MODULE_GPT120);
+    IfxGpt12_setGpt1BlockPrescaler(&MODULE_GPT120, IfxGpt12_Gpt1BlockPrescaler_4);
+    IfxGpt12_setGpt2BlockPrescaler(&MODULE_GPT120, IfxGpt12_Gpt2BlockPrescaler_4);
+
+    for (int wheel = 0; wheel < ENC_WHEELS_NUM; wheel++)
+    {
+        IfxGpt12_IncrEnc_initConfig(&config, &MODULE_GPT120);
+
+        config.base.resolution = ENC_PULSES_PER_REV;
+        config.base.resolutionFactor = IfxStdIf_Pos_ResolutionFactor_fourFold;
+        config.base.updatePeriod = (float32)periodUs * 1e-6f;
+        config.base.reversed = ENC_PINS[wheel].reversed;
+        config.pinA = ENC_PINS[wheel].a;
+        config.pinB = ENC_PINS[wheel].b;
+        config.pinMode = IfxPort_InputMode_pullUp;     /* open collector hall outputs */
+
+        IfxGpt12_IncrEnc_init(&g_encDriver[wheel], &config);
+
+        g_encLastTimer[wheel] = readTimer((EncWheel)wheel);
+        g_encCount[wheel] = 0;
+    }
+}
+
+/* Call every periodUs. The 16-bit timers are extended to a running count here, so a wheel
+ * may move at most 32767 counts (about 35 turns) between two calls */
+void gpt12IncrEncUpdate(void)
+{
+    for (int wheel = 0; wheel < ENC_WHEELS_NUM; wheel++)
+    {
+        uint16 timer = readTimer((EncWheel)wheel);
+
+        IfxGpt12_IncrEnc_update(&g_encDriver[wheel]);
+        g_encCount[wheel] += (sint16)(timer - g_encLastTimer[wheel]);
+        g_encLastTimer[wheel] = timer;
+    }
+}
+
+/* Counts since gpt12IncrEncInit(), positive when the wheel drives the car forward */
+sint32 gpt12IncrEncGetCount(EncWheel wheel)
+{
+    return g_encCount[wheel];
+}
@@ -0,0 +1,33 @@
+#ifndef BSW_MCAL_GPT12_INCR_ENC_H_
+#define BSW_MCAL_GPT12_INCR_ENC_H_
+
+#include "IfxGpt12.h"
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------Macros-------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#define ENC_PULSES_PER_REV  234                         /* encoder lines per wheel turn (11 line hall, 1:21.3 gear) */
+#define ENC_COUNTS_PER_REV  (ENC_PULSES_PER_REV * 4)    /* both edges of A and B are counted */
+
+/*********************************************************************************************************************/
+/*-------------------------------------------------Type Definitions--------------------------------------------------*/
+/*********************************************************************************************************************/
+
+/* motor A drives the left wheel, motor B the right one */
+typedef enum
+{
+    ENC_LEFT,       /* GPT12 T3, A = P10.4, B = P10.7 */
+    ENC_RIGHT,      /* GPT12 T2, A = P00.7, B = P00.8 */
+    ENC_WHEELS_NUM
+} EncWheel;
+
+/*********************************************************************************************************************/
+/*-------------------------------------------Function Prototypes-----------------------------------------------------*/
+/*********************************************************************************************************************/
+
+void gpt12IncrEncInit(uint32 periodUs);
+void gpt12IncrEncUpdate(void);
+sint32 gpt12IncrEncGetCount(EncWheel wheel);
+
+#endif /* BSW_MCAL_GPT12_INCR_ENC_H_ */
@@ -8,6 +8,12 @@ IfxGtm_Atom_Pwm_Config g_atomConfig_PwmB;
 IfxGtm_Atom_Pwm_Driver g_atomDriver_PwmA;
 IfxGtm_Atom_Pwm_Driver g_atomDriver_PwmB;
 
+/* AGC GLB_CTRL values that hold / release the shadow transfer of one PWM channel, see gtmAtomPwmSetDutyCycleAB */
+static uint32 g_pwmAUpdateHold;
+static uint32 g_pwmAUpdateRelease;
+static uint32 g_pwmBUpdateHold;
+static uint32 g_pwmBUpdateRelease;
+
 IfxGtm_Atom_Pwm_Config g_atomConfig;                            /* Timer configuration structure                    */
 IfxGtm_Atom_Pwm_Driver g_atomDriver;                            /* Timer Driver structure                           */
 
@@ -50,6 +56,11 @@ void gtmAtomPwmInit(void)
 
     IfxGtm_Atom_Pwm_init(&g_atomDriver_PwmB, &g_atomConfig_PwmB);                 /* Initialize the PWM                       */
     IfxGtm_Atom_Pwm_start(&g_atomDriver_PwmB, TRUE);                         /* Start the PWM                            */
+
+    g_pwmAUpdateHold = IfxGtm_Atom_Agc_buildFeature(0, (uint16)(1u << PWM_A.channel), IFX_GTM_ATOM_AGC_GLB_CTRL_UPEN_CTRL0_OFF);
+    g_pwmAUpdateRelease = IfxGtm_Atom_Agc_buildFeature((uint16)(1u << PWM_A.channel), 0, IFX_GTM_ATOM_AGC_GLB_CTRL_UPEN_CTRL0_OFF);
+    g_pwmBUpdateHold = IfxGtm_Atom_Agc_buildFeature(0, (uint16)(1u << PWM_B.channel), IFX_GTM_ATOM_AGC_GLB_CTRL_UPEN_CTRL0_OFF);
+    g_pwmBUpdateRelease = IfxGtm_Atom_Agc_buildFeature((uint16)(1u << PWM_B.channel), 0, IFX_GTM_ATOM_AGC_GLB_CTRL_UPEN_CTRL0_OFF);
 }
 
 /* This function sets the duty cycle of the PWM */
@@ -59,14 +70,31 @@ void gtmAtomPwmSetDutyCycle(uint32 dutyCycle)
     IfxGtm_Atom_Pwm_init(&g_atomDriver, &g_atomConfig); /* Re-initialize the PWM                                    */
 }
 
+/* Fast path: only the shadow compare registers are written. With synchronous update the channel
+ * copies SR0/SR1 into CM0/CM1 at the end of the running period, so a period is never cut short */
 void gtmAtomPwmASetDutyCycle(uint32 dutyCycle)
 {
-    g_atomConfig_PwmA.dutyCycle = dutyCycle;                 /* Set duty cycle                                           */
-    IfxGtm_Atom_Pwm_init(&g_atomDriver_PwmA, &g_atomConfig_PwmA); /* Re-initialize the PWM                                    */
+    IfxGtm_Atom_Ch_setCompareShadow(g_atomDriver_PwmA.atom, g_atomDriver_PwmA.atomChannel, PWM_PERIOD, dutyCycle);
 }
 
 void gtmAtomPwmBSetDutyCycle(uint32 dutyCycle)
 {
-    g_atomConfig_PwmB.dutyCycle = dutyCycle;                 /* Set duty cycle                                           */
-    IfxGtm_Atom_Pwm_init(&g_atomDriver_PwmB, &g_atomConfig_PwmB); /* Re-initialize the PWM                                    */
+    IfxGtm_Atom_Ch_setCompareShadow(g_atomDriver_PwmB.atom, g_atomDriver_PwmB.atomChannel, PWM_PERIOD, dutyCycle);
+}
+
+/* Updates both wheels together: the shadow transfer of both channels is held while SR0/SR1 are
+ * written and released right after (UPEN fields written as 00 are left alone), so a period end
+ * that falls between the writes cannot hand one wheel its new duty before the other is written.
+ * PWM_A and PWM_B sit on different ATOMs whose periods are not phase aligned; each takes the new
+ * value at its next period boundary, i.e. within one PWM period of the other */
+void gtmAtomPwmSetDutyCycleAB(uint32 dutyCycleA, uint32 dutyCycleB)
+{
+    IfxGtm_Atom_Agc_setChannelsUpdate(g_atomDriver_PwmA.agc, g_pwmAUpdateHold);
+    IfxGtm_Atom_Agc_setChannelsUpdate(g_atomDriver_PwmB.agc, g_pwmBUpdateHold);
+
+    IfxGtm_Atom_Ch_setCompareShadow(g_atomDriver_PwmA.atom, g_atomDriver_PwmA.atomChannel, PWM_PERIOD, dutyCycleA);
+    IfxGtm_Atom_Ch_setCompareShadow(g_atomDriver_PwmB.atom, g_atomDriver_PwmB.atomChannel, PWM_PERIOD, dutyCycleB);
+
+    IfxGtm_Atom_Agc_setChannelsUpdate(g_atomDriver_PwmA.agc, g_pwmAUpdateRelease);
+    IfxGtm_Atom_Agc_setChannelsUpdate(g_atomDriver_PwmB.agc, g_pwmBUpdateRelease);
 }
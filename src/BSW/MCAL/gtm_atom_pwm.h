@@ -20,5 +20,6 @@ void gtmAtomPwmSetDutyCycle(uint32 dutyCycle);
 
 void gtmAtomPwmASetDutyCycle(uint32 dutyCycle);
 void gtmAtomPwmBSetDutyCycle(uint32 dutyCycle);
+void gtmAtomPwmSetDutyCycleAB(uint32 dutyCycleA, uint32 dutyCycleB);
 
 #endif /* BSW_DRIVER_GTM_ATOM_PWM_H_ */
@@ -0,0 +1,72 @@
+#include "gtm_tim_in.h"
+
+/*********************************************************************************************************************/
+/*--------------------------------------------Private Variables/Constants--------------------------------------------*/
+/*********************************************************************************************************************/
+
+static const Ifx_Priority TIM_IN_PRIORITY[GTM_TIM_IN_NUM] = {
+        ISR_PRIORITY_GTM_TIM_IN0, ISR_PRIORITY_GTM_TIM_IN1, ISR_PRIORITY_GTM_TIM_IN2
+};
+
+static IfxGtm_Tim_In g_timInDriver[GTM_TIM_IN_NUM];
+static GtmTimInCallback g_timInCallback[GTM_TIM_IN_NUM];
+static float32 g_timInTo10Ns[GTM_TIM_IN_NUM];
+
+/*********************************************************************************************************************/
+/*--------------------------------------------Function Implementations-----------------------------------------------*/
+/*********************************************************************************************************************/
+
+/* The channel measures from falling edge to falling edge (right aligned PWM), so the new value arrives
+ * right at the end of the pulse: GPR1 is the whole period and GPR0 the low phase before the pulse. */
+static void onCapture(uint32 slot)
+{
+    IfxGtm_Tim_In *driver = &g_timInDriver[slot];
+
+    IfxGtm_Tim_In_onIsr(driver);
+    if (driver->newData && driver->periodTick > driver->pulseLengthTick && g_timInCallback[slot] != NULL_PTR)
+    {
+        uint32 high = driver->periodTick - driver->pulseLengthTick;
+        g_timInCallback[slot](slot, (uint32)((float32)high * g_timInTo10Ns[slot]));
+    }
+}
+
+IFX_INTERRUPT(gtmTimIn0IsrHandler, 1, ISR_PRIORITY_GTM_TIM_IN0);
+void gtmTimIn0IsrHandler(void)
+{
+    onCapture(0);
+}
+
+IFX_INTERRUPT(gtmTimIn1IsrHandler, 1, ISR_PRIORITY_GTM_TIM_IN1);
+void gtmTimIn1IsrHandler(void)
+{
+    onCapture(1);
+}
+
+IFX_INTERRUPT(gtmTimIn2IsrHandler, 1, ISR_PRIORITY_GTM_TIM_IN2);
+void gtmTimIn2IsrHandler(void)
+{
+    onCapture(2);
+}
+
+/* GTM and CMU clock 0 must already be running (gtmAtomPwmInit). The capture interrupts are serviced by CPU1 */
+void gtmTimInInit(uint32 slot, IfxGtm_Tim_TinMap *pin, GtmTimInCallback callback)
+{
+    IfxGtm_Tim_In_Config config;
+
+    IfxGtm_Tim_In_initConfig(&config, &MODULE_GTM);
+
+    config.filter.inputPin = pin;
+    config.filter.inputPinMode = IfxPort_InputMode_pullUp;
+    config.timIndex = pin->tim;
+    config.channelIndex = pin->channel;
+    config.mode = IfxGtm_Tim_Mode_pwmMeasurement;
+    config.capture.mode = Ifx_Pwm_Mode_rightAligned;
+    config.capture.clock = IfxGtm_Cmu_Clk_0;
+    config.capture.irqOnNewVal = TRUE;
+    config.isrProvider = IfxSrc_Tos_cpu1;
+    config.isrPriority = TIM_IN_PRIORITY[slot];
+
+    g_timInCallback[slot] = callback;
+    IfxGtm_Tim_In_init(&g_timInDriver[slot], &config);
+    g_timInTo10Ns[slot] = 100000000.0f / g_timInDriver[slot].captureClockFrequency;
+}
@@ -0,0 +1,30 @@
+#ifndef BSW_MCAL_GTM_TIM_IN_H_
+#define BSW_MCAL_GTM_TIM_IN_H_
+
+#include "IfxGtm_Tim_In.h"
+#include "priority.h"
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------Macros-------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#define GTM_TIM_IN_NUM 3                /* capture slots, one interrupt each */
+
+/*********************************************************************************************************************/
+/*-------------------------------------------------Type Definitions--------------------------------------------------*/
+/*********************************************************************************************************************/
+
+/* Called from the (CPU1) capture interrupt with the high time of the pulse that just ended, in 10 ns (STM0) ticks */
+typedef void (*GtmTimInCallback)(uint32 slot, uint32 pulse10Ns);
+
+/*********************************************************************************************************************/
+/*-------------------------------------------Function Prototypes-----------------------------------------------------*/
+/*********************************************************************************************************************/
+
+void gtmTimInInit(uint32 slot, IfxGtm_Tim_TinMap *pin, GtmTimInCallback callback);
+
+void gtmTimIn0IsrHandler(void);
+void gtmTimIn1IsrHandler(void);
+void gtmTimIn2IsrHandler(void);
+
+#endif /* BSW_MCAL_GTM_TIM_IN_H_ */
@@ -0,0 +1,32 @@
+#include "overlay.h"
+
+#include "IfxCpu.h"
+
+#include <string.h>
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------Macros-------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#define OVERLAY_OBASE_MASK  0x003FFFE0u     /* RABR.OBASE: offset of the working page inside CPU0 DSPR */
+#define OVERLAY_NONCACHED   0x20000000u     /* segment 8 -> segment A alias of the same flash */
+
+/*********************************************************************************************************************/
+/*--------------------------------------------Function Implementations-----------------------------------------------*/
+/*********************************************************************************************************************/
+
+/* Copies the first size bytes (at most OVERLAY_PAGE_SIZE) of the reference page into the working page,
+ * then redirects CPU0 data accesses of the reference page to it. Returns the address to read the page
+ * through: the non-cached alias of the reference page, so a value patched in the working page is seen
+ * by the next read without a data cache flush.
+ * Both pages must be OVERLAY_PAGE_SIZE aligned; call before anything reads the page */
+const volatile void *overlayMapPage(uint16 block, const volatile void *flashPage, void *ramPage, uint32 size)
+{
+    memcpy(ramPage, (const void *)flashPage, size);
+
+    IfxCpu_enableOverlayBlock(IfxCpu_ResourceCpu_0, block, IfxCpu_OverlayMemorySelect_core0DsprPspr,
+                              IfxCpu_OverlayAddressMask_256byte, (uint32)flashPage,
+                              (uint32)ramPage & OVERLAY_OBASE_MASK);
+
+    return (const volatile void *)((uint32)flashPage | OVERLAY_NONCACHED);
+}
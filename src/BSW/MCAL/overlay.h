@@ -0,0 +1,26 @@
+#ifndef BSW_MCAL_OVERLAY_H_
+#define BSW_MCAL_OVERLAY_H_
+
+#include "Ifx_Types.h"
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------Macros-------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+/* One calibration page is one CPU0 data overlay block. The linker scripts reserve and align the
+ * reference pages (.calib, in PFLASH) and the working pages (.calib_ram, in CPU0 DSPR) to this size */
+#define OVERLAY_PAGE_SIZE 256
+
+#define OVERLAY_FLASH_PAGE __attribute__((section(".calib")))
+#define OVERLAY_RAM_PAGE __attribute__((section(".calib_ram")))
+
+/* overlay blocks in use, one per calibration page */
+#define OVERLAY_BLOCK_AUTOPARK 0
+
+/*********************************************************************************************************************/
+/*-------------------------------------------Function Prototypes-----------------------------------------------------*/
+/*********************************************************************************************************************/
+
+const volatile void *overlayMapPage(uint16 block, const volatile void *flashPage, void *ramPage, uint32 size);
+
+#endif /* BSW_MCAL_OVERLAY_H_ */
@@ -0,0 +1,32 @@
+#include "perf_counter.h"
+
+#include "IfxCpu.h"
+
+/*********************************************************************************************************************/
+/*--------------------------------------------Function Implementations-----------------------------------------------*/
+/*********************************************************************************************************************/
+
+/* Selects the M1CNT..M3CNT events, then clears and starts the counters of the calling core.
+ * The counters are core special function registers, so every core that profiles calls this */
+void perfCounterInit(void)
+{
+    Ifx_CPU_CCTRL cctrl;
+
+    cctrl.U = __mfcr(CPU_CCTRL);
+    cctrl.B.M1 = PERF_EVENT_SELECT;
+    cctrl.B.M2 = PERF_EVENT_SELECT;
+    cctrl.B.M3 = PERF_EVENT_SELECT;
+    __mtcr(CPU_CCTRL, cctrl.U);
+
+    IfxCpu_resetAndStartCounters(IfxCpu_CounterMode_normal);
+}
+
+/* Reads the calling core's counters. The five reads take a few cycles, far less than any scope */
+void perfCounterRead(PerfSample *sample)
+{
+    sample->cycles = __mfcr(CPU_CCNT);
+    sample->instructions = __mfcr(CPU_ICNT);
+    sample->events[0] = __mfcr(CPU_M1CNT);
+    sample->events[1] = __mfcr(CPU_M2CNT);
+    sample->events[2] = __mfcr(CPU_M3CNT);
+}
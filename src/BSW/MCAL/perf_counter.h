@@ -0,0 +1,38 @@
+#ifndef BSW_MCAL_PERF_COUNTER_H_
+#define BSW_MCAL_PERF_COUNTER_H_
+
+#include "Ifx_Types.h"
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------Macros-------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+/* CCNT, ICNT and M1CNT..M3CNT count in bits 0..30; bit 31 is the sticky overflow flag. Differences
+ * of two reads are taken modulo 2^31, which covers about 7 s at 300 MHz */
+#define PERF_COUNTER_MASK 0x7FFFFFFFu
+
+#define PERF_EVENTS_NUM 3               /* M1CNT, M2CNT, M3CNT */
+
+/* CCTRL.M1/M2/M3 selection, the same value for all three. 1 counts program cache hits, program
+ * cache misses and multi-issued instructions; 2 data cache hits, clean and dirty misses */
+#define PERF_EVENT_SELECT 1
+
+/*********************************************************************************************************************/
+/*-------------------------------------------------Type Definitions--------------------------------------------------*/
+/*********************************************************************************************************************/
+
+typedef struct
+{
+    uint32 cycles;                      /* CCNT */
+    uint32 instructions;                /* ICNT */
+    uint32 events[PERF_EVENTS_NUM];     /* M1CNT..M3CNT */
+} PerfSample;
+
+/*********************************************************************************************************************/
+/*-------------------------------------------Function Prototypes-----------------------------------------------------*/
+/*********************************************************************************************************************/
+
+void perfCounterInit(void);
+void perfCounterRead(PerfSample *sample);
+
+#endif /* BSW_MCAL_PERF_COUNTER_H_ */
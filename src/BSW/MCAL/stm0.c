@@ -0,0 +1,80 @@
+#include "stm0.h"
+
+#include "trace.h"
+
+/*********************************************************************************************************************/
+/*--------------------------------------------Private Variables/Constants--------------------------------------------*/
+/*********************************************************************************************************************/
+
+static uint32 g_stm0PeriodTicks = 0;
+static volatile uint32 g_stm0TickCount = 0;
+
+static uint32 g_stm0TimerTicks = 0;
+static Stm0Callback g_stm0TimerCallback = NULL_PTR;
+
+/*********************************************************************************************************************/
+/*--------------------------------------------Function Implementations-----------------------------------------------*/
+/*********************************************************************************************************************/
+
+/* Compare 0 fires once per period; the next compare value is derived from the previous one so the period does not drift */
+IFX_INTERRUPT(stm0IsrHandler, 0, ISR_PRIORITY_STM0);
+void stm0IsrHandler(void)
+{
+    IfxStm_clearCompareFlag(&MODULE_STM0, IfxStm_Comparator_0);
+    IfxStm_increaseCompare(&MODULE_STM0, IfxStm_Comparator_0, g_stm0PeriodTicks);
+    g_stm0TickCount++;
+    TRACE_CPU0(TRACE_ISR, TRACE_ISR_STM0_TICK, g_stm0TickCount);
+}
+
+void stm0InitTick(uint32 periodUs)
+{
+    IfxStm_CompareConfig config;
+
+    g_stm0PeriodTicks = (uint32)IfxStm_getTicksFromMicroseconds(&MODULE_STM0, periodUs);
+
+    IfxStm_initCompareConfig(&config);
+    config.comparator = IfxStm_Comparator_0;
+    config.comparatorInterrupt = IfxStm_ComparatorInterrupt_ir0;
+    config.ticks = g_stm0PeriodTicks;
+    config.triggerPriority = ISR_PRIORITY_STM0;
+    config.typeOfService = IfxSrc_Tos_cpu0;
+
+    IfxStm_initCompare(&MODULE_STM0, &config);
+}
+
+/* Number of periods elapsed since stm0InitTick() */
+uint32 stm0GetTickCount(void)
+{
+    return g_stm0TickCount;
+}
+
+/* Compare 1 runs a second periodic interrupt for BSW services, e.g. the ultrasonic trigger schedule.
+ * It is serviced by CPU1 so the callback never preempts the control core */
+IFX_INTERRUPT(stm0TimerIsrHandler, 1, ISR_PRIORITY_ULTRASONIC_TRIGGER);
+void stm0TimerIsrHandler(void)
+{
+    IfxStm_clearCompareFlag(&MODULE_STM0, IfxStm_Comparator_1);
+    IfxStm_increaseCompare(&MODULE_STM0, IfxStm_Comparator_1, g_stm0TimerTicks);
+    if (g_stm0TimerCallback != NULL_PTR)
+    {
+        g_stm0TimerCallback();
+    }
+}
+
+/* Calling it again changes the period; the callback runs in CPU1 interrupt context */
+void stm0InitTimer(uint32 periodUs, Stm0Callback callback)
+{
+    IfxStm_CompareConfig config;
+
+    g_stm0TimerTicks = (uint32)IfxStm_getTicksFromMicroseconds(&MODULE_STM0, periodUs);
+    g_stm0TimerCallback = callback;
+
+    IfxStm_initCompareConfig(&config);
+    config.comparator = IfxStm_Comparator_1;
+    config.comparatorInterrupt = IfxStm_ComparatorInterrupt_ir1;
+    config.ticks = g_stm0TimerTicks;
+    config.triggerPriority = ISR_PRIORITY_ULTRASONIC_TRIGGER;
+    config.typeOfService = IfxSrc_Tos_cpu1;
+
+    IfxStm_initCompare(&MODULE_STM0, &config);
+}
@@ -0,0 +1,24 @@
+#ifndef BSW_MCAL_STM0_H_
+#define BSW_MCAL_STM0_H_
+
+#include "IfxStm.h"
+#include "priority.h"
+
+/*********************************************************************************************************************/
+/*-------------------------------------------------Type Definitions--------------------------------------------------*/
+/*********************************************************************************************************************/
+
+typedef void (*Stm0Callback)(void);
+
+/*********************************************************************************************************************/
+/*-------------------------------------------Function Prototypes-----------------------------------------------------*/
+/*********************************************************************************************************************/
+
+void stm0InitTick(uint32 periodUs);
+uint32 stm0GetTickCount(void);
+void stm0IsrHandler(void);
+
+void stm0InitTimer(uint32 periodUs, Stm0Callback callback);
+void stm0TimerIsrHandler(void);
+
+#endif /* BSW_MCAL_STM0_H_ */
@@ -6,22 +6,64 @@
 #include <string.h>
 
 #include "asclin1.h"
+#include "lineedit.h"
+#include "mailbox.h"
+#include "profile.h"
+#include "trace.h"
 
 #include "Ifx_Types.h"
 #define BUFSIZE 128
-#define KB_BS '\x7F'
-#define KB_CR '\r'
 
+#define BT_RX_MAILBOX_SIZE 64
+#define BT_TX_MAILBOX_SIZE 1024
+#define BT_WAIT_US 50           // 다른 코어를 기다릴 때 mailbox 확인 간격
+#define BT_ECHO_SIZE 32         // bluetoothPollLine() 한 번에 모아 보내는 echo
+
+/* UART 는 CPU2 가 맡는다. 명령은 RX 인터럽트 -> CPU0, 텔레메트리는 CPU0 -> CPU2 루프 */
+MAILBOX_DEFINE(g_btRxMailbox, char, BT_RX_MAILBOX_SIZE);
+MAILBOX_DEFINE(g_btTxMailbox, char, BT_TX_MAILBOX_SIZE);
+
+static volatile uint32 g_btTxDropCount = 0;
+static LineEditor g_btLine;     // bluetoothPollLine() 이 조립 중인 줄 (CPU0)
+static uint32 g_btBurst = 0;    // mailbox 가 비지 않은 채 이어서 보낸 바이트 수 (CPU2, 트레이스용)
+
+static void remove_null(char *s);
+
+/* CPU2 의 ASCLIN1 RX 인터럽트에서 호출 */
 void bluetoothIsr(char c)
 {
-    //    myPrintf("%c", c);
+    TRACE_CPU2(TRACE_ISR, TRACE_ISR_BT_RX, c);
+    mailboxPush(&g_btRxMailbox, &c);
 }
 
+/* CPU2 에서 호출 */
 void bluetoothInit(void)
 {
     asclin1InitUart();
 }
 
+/* CPU2 루프에서 호출. TX FIFO 가 비는 만큼만 보내고 바로 돌아온다 */
+void bluetoothPump(void)
+{
+    char c;
+
+    while (asclin1TxReady() && mailboxPop(&g_btTxMailbox, &c))
+    {
+        // 트레이스에는 mailbox 가 빌 때까지를 한 구간으로 남긴다. 바이트마다 남기면 링이 금방 넘친다
+        if (g_btBurst == 0)
+        {
+            TRACE_CPU2(TRACE_ENTER, TRACE_SCOPE_BT_PUMP, 0);
+        }
+        asclin1OutUart((unsigned char)c);
+        g_btBurst++;
+    }
+    if (g_btBurst > 0 && mailboxIsEmpty(&g_btTxMailbox))
+    {
+        TRACE_CPU2(TRACE_EXIT, TRACE_SCOPE_BT_PUMP, g_btBurst);
+        g_btBurst = 0;
+    }
+}
+
 void bluetoothAtCommand(char *cmd)
 {
     char buf[30];
@@ -29,44 +71,103 @@ void bluetoothAtCommand(char *cmd)
     sprintf(buf, "%s", cmd);
     while (buf[i] != 0)
     {
-        asclin1OutUart(buf[i]);
+        bluetoothSendByteBlocked(buf[i]);
         i++;
     }
-    asclin1OutUart(buf[i]);
-    asclin1OutUart('\r');
-    asclin1OutUart('\n');
+    bluetoothSendByteBlocked(buf[i]);
+    bluetoothSendByteBlocked('\r');
+    bluetoothSendByteBlocked('\n');
 
     delayMs(300);
 }
 
 char bluetoothRecvByteBlocked(void)
 {
-    return asclin1InUart();
+    char ch;
+
+    while (mailboxPop(&g_btRxMailbox, &ch) == FALSE)
+    {
+        delayUs(BT_WAIT_US);
+    }
+    return ch;
 }
 
 char bluetoothRecvByteNonBlocked(void)
 {
-    unsigned char ch = 0;
-    int res;
-    res = asclin1PollUart(&ch);
+    char ch;
+
+    return mailboxPop(&g_btRxMailbox, &ch) ? ch : -1;
+}
+
+/* 통째로 mailbox 에 넣는다. 자리가 없으면 버리고 세고 FALSE. 기다리지 않는다 (CPU0) */
+boolean bluetoothWrite(const char *data, uint32 length)
+{
+    if (mailboxPushN(&g_btTxMailbox, data, length) == FALSE)
+    {
+        g_btTxDropCount++;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/* 지금 bluetoothWrite() 로 한 번에 넣을 수 있는 바이트 수 */
+uint32 bluetoothGetTxSpace(void)
+{
+    return mailboxGetSpace(&g_btTxMailbox);
+}
 
-    return res == 1 ? ch : -1;
+/* TX mailbox 가 가득 차서 버려진 메시지 (bluetoothPrintf, 텔레메트리 프레임) 수 */
+uint32 bluetoothGetTxDropCount(void)
+{
+    return g_btTxDropCount;
 }
 
+/* TX mailbox 가 가득 찼을 때만 CPU2 가 비울 때까지 기다린다 (입력 echo, AT 명령용) */
 void bluetoothSendByteBlocked(unsigned char ch)
 {
-    asclin1OutUart(ch);
+    while (mailboxIsFull(&g_btTxMailbox))
+    {
+        delayUs(BT_WAIT_US);
+    }
+    mailboxPush(&g_btTxMailbox, &ch);
+}
+
+/* 받아 둔 바이트만 줄 편집기에 넣고 바로 돌아온다 (CPU0).
+   CR 로 줄이 끝나면 line 에 복사하고 TRUE. echo 는 모아서 한 번에 보낸다 */
+boolean bluetoothPollLine(char *line, uint32 size)
+{
+    char echo[BT_ECHO_SIZE];
+    uint32 n = 0;
+    boolean done = FALSE;
+    char c;
+
+    while (done == FALSE && n + LINE_EDIT_ECHO_MAX <= BT_ECHO_SIZE && mailboxPop(&g_btRxMailbox, &c))
+    {
+        LineEditEvent event = lineEditFeed(&g_btLine, c);
+
+        n += lineEditEcho(event, c, &echo[n]);
+        done = (event == LINE_EDIT_DONE);
+    }
+    if (n > 0)
+    {
+        bluetoothWrite(echo, n);
+    }
+    if (done)
+    {
+        lineEditTake(&g_btLine, line, size);
+    }
+    return done;
 }
 
 void bluetoothPrintf(const char *fmt, ...)
 {
     char buffer[128];
-    char buffer2[128]; // add \r before \n
-    char *ptr;
+    char buffer2[256]; // add \r before \n
     va_list ap;
 
+    PROFILE_BEGIN(PROFILE_BT_PRINTF);
     va_start(ap, fmt);
-    vsprintf(buffer, fmt, ap);
+    vsnprintf(buffer, sizeof(buffer), fmt, ap);
     va_end(ap);
     int j = 0;
     for (int i = 0; buffer[i]; i++)
@@ -83,47 +184,22 @@ void bluetoothPrintf(const char *fmt, ...)
     }
     buffer2[j] = '\0';
 
-    for (ptr = buffer2; *ptr; ++ptr)
-        bluetoothSendByteBlocked((const unsigned char)*ptr);
+    bluetoothWrite(buffer2, (uint32)j);
+    PROFILE_END(PROFILE_BT_PRINTF);
 }
 
 void bluetoothScanf(const char *fmt, ...)
 {
     uint8 c = 0;
     char buf[128];
-    int idx = 0, i;
+    int i;
     char *pstr, *pidx;
 
     memset(buf, 0, 128);
-    while (c != '\r')
+    while (bluetoothPollLine(buf, sizeof(buf)) == FALSE)
     {
-        c = asclin1InUart();
-        if (c == KB_BS || c == 0x8)
-        {
-            if (idx > 0)
-            {
-                buf[idx - 1] = 0;
-                idx--;
-                bluetoothPrintf("%c %c", 8, 8);
-            }
-            continue;
-        }
-        else
-        {
-            if (c == KB_CR)
-            {
-                idx += 1;
-                buf[idx] = '\0';
-            }
-            else
-            {
-                buf[idx] = c;
-                idx += 1;
-            }
-        }
-        bluetoothPrintf("%c", c);
+        delayUs(BT_WAIT_US);
     }
-    bluetoothPrintf("\n");
 
     va_list ap;
     va_start(ap, fmt);
@@ -16,6 +16,8 @@
 #include "asclin1.h"
 
 void bluetoothInit(void);
+void bluetoothIsr(char c);
+void bluetoothPump(void);
 void bluetoothSetName(char *name);
 void bluetoothSetPwd(char *pwd);
 void bluetoothSetBaud(int baudrate);
@@ -23,10 +25,12 @@ void bluetoothAtCommand(char *cmd);
 char bluetoothRecvByteBlocked(void);
 char bluetoothRecvByteNonBlocked(void);
 void bluetoothSendByteBlocked(unsigned char ch);
+boolean bluetoothWrite(const char *data, uint32 length);
 void bluetoothPrintf(const char *fmt, ...);
+uint32 bluetoothGetTxSpace(void);
+uint32 bluetoothGetTxDropCount(void);
+boolean bluetoothPollLine(char *line, uint32 size);
 void bluetoothScanf(const char *fmt, ...);
 
-static void remove_null(char *s);
-
 
 #endif /* BSW_IO_BLUETOOTH_H_ */
@@ -0,0 +1,75 @@
+#include "lineedit.h"
+
+#define KEY_BS  '\x08'
+#define KEY_DEL '\x7F'
+#define KEY_CR  '\r'
+#define KEY_LF  '\n'
+
+void lineEditReset(LineEditor *editor)
+{
+    editor->length = 0;
+    editor->buffer[0] = '\0';
+}
+
+LineEditEvent lineEditFeed(LineEditor *editor, char c)
+{
+    switch (c)
+    {
+    case KEY_BS:
+    case KEY_DEL:
+        if (editor->length == 0)
+        {
+            return LINE_EDIT_IGNORED;
+        }
+        editor->buffer[--editor->length] = '\0';
+        return LINE_EDIT_ERASED;
+    case KEY_CR:
+        return LINE_EDIT_DONE;
+    case KEY_LF:
+        return LINE_EDIT_IGNORED;
+    default:
+        // 가득 차면 CR 이 올 때까지 버린다
+        if (editor->length >= LINE_EDIT_SIZE - 1)
+        {
+            return LINE_EDIT_IGNORED;
+        }
+        editor->buffer[editor->length++] = c;
+        editor->buffer[editor->length] = '\0';
+        return LINE_EDIT_APPENDED;
+    }
+}
+
+/* event 에 맞는 echo 를 echo 에 쓰고 길이를 돌려준다 (최대 LINE_EDIT_ECHO_MAX) */
+uint32 lineEditEcho(LineEditEvent event, char c, char *echo)
+{
+    switch (event)
+    {
+    case LINE_EDIT_APPENDED:
+        echo[0] = c;
+        return 1;
+    case LINE_EDIT_ERASED:
+        echo[0] = KEY_BS;
+        echo[1] = ' ';
+        echo[2] = KEY_BS;
+        return 3;
+    case LINE_EDIT_DONE:
+        echo[0] = KEY_CR;
+        echo[1] = KEY_LF;
+        return 2;
+    default:
+        return 0;
+    }
+}
+
+/* 완성된 줄을 line 으로 옮기고 (size 에 맞게 자름) 다음 줄을 위해 비운다 */
+void lineEditTake(LineEditor *editor, char *line, uint32 size)
+{
+    uint32 n = editor->length < size - 1 ? editor->length : size - 1;
+
+    for (uint32 i = 0; i < n; i++)
+    {
+        line[i] = editor->buffer[i];
+    }
+    line[n] = '\0';
+    lineEditReset(editor);
+}
@@ -0,0 +1,38 @@
+/*
+ * lineedit.h
+ *
+ *  Non-blocking line assembler for the serial consoles. Bytes are fed one at
+ *  a time as they come out of an RX queue; the caller echoes according to the
+ *  returned event and picks the line up once LINE_EDIT_DONE is returned.
+ *  Backspace (0x08 or 0x7F) erases, CR ends the line, LF is ignored so that
+ *  terminals sending CR LF work as well. Bytes past the buffer are dropped.
+ */
+
+#ifndef BSW_SERVICE_LINEEDIT_H_
+#define BSW_SERVICE_LINEEDIT_H_
+
+#include "Ifx_Types.h"
+
+#define LINE_EDIT_SIZE 128      /* including the terminating NUL */
+#define LINE_EDIT_ECHO_MAX 3    /* longest echo of a single byte */
+
+typedef enum
+{
+    LINE_EDIT_IGNORED,          /* nothing changed, no echo */
+    LINE_EDIT_APPENDED,         /* echo the byte */
+    LINE_EDIT_ERASED,           /* echo "\b \b" */
+    LINE_EDIT_DONE              /* echo "\r\n", line is in buffer */
+} LineEditEvent;
+
+typedef struct
+{
+    char buffer[LINE_EDIT_SIZE];
+    uint32 length;
+} LineEditor;
+
+void lineEditReset(LineEditor *editor);
+LineEditEvent lineEditFeed(LineEditor *editor, char c);
+uint32 lineEditEcho(LineEditEvent event, char c, char *echo);
+void lineEditTake(LineEditor *editor, char *line, uint32 size);
+
+#endif /* BSW_SERVICE_LINEEDIT_H_ */
@@ -0,0 +1,152 @@
+#include "log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "mailbox.h"
+#include "uart.h"
+
+#define LOG_SPEC_MAX 16                 // 변환 하나 ("%-8.3f" 등) 의 최대 길이
+
+/* CPU0 -> CPU2. 기록은 포맷 문자열 주소와 인자뿐이다 */
+MAILBOX_DEFINE(g_logMailbox, LogRecord, LOG_MAILBOX_SIZE);
+
+static uint32 g_logDropReported = 0;    // 이미 알린 버린 기록 수 (CPU2)
+
+/* LOG_PRINTF(): 인자를 그대로 mailbox 에 넣고 돌아온다. 포맷은 CPU2 가 나중에 한다 (CPU0) */
+void logWrite(const char *format, uint32 count, uint32 a0, uint32 a1, uint32 a2, uint32 a3)
+{
+    LogRecord record;
+
+    record.format = format;
+    record.count = count;
+    record.args[0] = a0;
+    record.args[1] = a1;
+    record.args[2] = a2;
+    record.args[3] = a3;
+    mailboxPush(&g_logMailbox, &record);
+}
+
+/* mailbox 가 가득 차서 버려진 기록 수 */
+uint32 logGetDropCount(void)
+{
+    return mailboxGetDropped(&g_logMailbox);
+}
+
+static boolean isConversion(char c)
+{
+    return c != '\0' && strchr("diouxXcfFeEgG", c) != NULL;
+}
+
+/* 플래그, 폭, 정밀도, 길이 수식어 */
+static boolean isSpecChar(char c)
+{
+    return c != '\0' && strchr("-+ #0123456789.hlzjt", c) != NULL;
+}
+
+/* 변환 하나를 인자 하나로 찍는다. 길이 수식어는 빼고 conversion 에 맞는 타입으로 넘긴다 */
+static int formatArg(char *out, size_t size, const char *spec, uint32 length, uint32 arg)
+{
+    char clean[LOG_SPEC_MAX + 1];
+    uint32 n = 0;
+    char conversion = spec[length - 1];
+
+    for (uint32 i = 0; i < length && n < LOG_SPEC_MAX; i++)
+    {
+        if (spec[i] != 'l' && spec[i] != 'h' && spec[i] != 'z' && spec[i] != 'j' && spec[i] != 't')
+        {
+            clean[n++] = spec[i];
+        }
+    }
+    clean[n] = '\0';
+
+    switch (conversion)
+    {
+    case 'd':
+    case 'i':
+    case 'c':
+        return snprintf(out, size, clean, (int)(sint32)arg);
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    {
+        union
+        {
+            uint32 u;
+            float32 f;
+        } bits;
+
+        bits.u = arg;
+        return snprintf(out, size, clean, (double)bits.f);
+    }
+    default:
+        return snprintf(out, size, clean, (unsigned)arg);
+    }
+}
+
+/* printf 와 같은 결과를 기록의 인자로 만든다. 인자가 모자라면 변환을 그대로 둔다 */
+static uint32 formatRecord(const LogRecord *record, char *line, uint32 size)
+{
+    const char *p = record->format;
+    uint32 n = 0;
+    uint32 arg = 0;
+
+    while (*p != '\0' && n < size - 1)
+    {
+        if (*p != '%')
+        {
+            line[n++] = *p++;
+            continue;
+        }
+        if (p[1] == '%')
+        {
+            line[n++] = '%';
+            p += 2;
+            continue;
+        }
+
+        uint32 length = 1;
+        while (length < LOG_SPEC_MAX - 1 && isSpecChar(p[length]))
+        {
+            length++;
+        }
+        if (!isConversion(p[length]) || arg >= record->count)
+        {
+            line[n++] = *p++;
+            continue;
+        }
+        length++;
+
+        int written = formatArg(&line[n], size - n, p, length, record->args[arg++]);
+        if (written > 0)
+        {
+            n += ((uint32)written < size - n) ? (uint32)written : size - 1 - n;
+        }
+        p += length;
+    }
+    line[n] = '\0';
+    return n;
+}
+
+/* CPU2 루프에서 호출. ASCLIN0 에 줄이 통째로 들어갈 자리가 있는 동안 기록을 포맷해서 보낸다 */
+void logPump(void)
+{
+    LogRecord record;
+    char line[LOG_LINE_MAX];
+
+    while (uartGetSinkSpace() >= 2 * LOG_LINE_MAX && mailboxPop(&g_logMailbox, &record))
+    {
+        uint32 dropped = mailboxGetDropped(&g_logMailbox);
+
+        if (dropped != g_logDropReported)
+        {
+            uint32 n = (uint32)snprintf(line, sizeof(line), "[log] %u dropped\n", (unsigned)(dropped - g_logDropReported));
+            g_logDropReported = dropped;
+            uartSinkWrite(line, n);
+        }
+        uartSinkWrite(line, formatRecord(&record, line, sizeof(line)));
+    }
+}
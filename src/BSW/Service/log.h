@@ -0,0 +1,62 @@
+/*
+ * log.h
+ *
+ *  Deferred debug log: LOG_PRINTF() on CPU0 stores the format string's
+ *  address and up to LOG_ARGS_MAX raw 32-bit arguments in a mailbox and
+ *  returns, so a log call costs a few stores instead of a vsnprintf() and a
+ *  second pass for the line ends. CPU2 formats the records in its loop
+ *  (logPump()) and hands the text to the ASCLIN0 sink (uart.h), which is the
+ *  one place that turns "\n" into "\r\n".
+ *
+ *  The format string is the record's ID, so it must outlive the record: use
+ *  a string literal. Arguments are stored as 32-bit words: integers and
+ *  chars as they are, floats through logFloat(). There is no "%s" or "%p",
+ *  no '*' width and no 64-bit argument; length modifiers are ignored.
+ *
+ *  Only CPU0 task level may log (single producer). A full mailbox drops the
+ *  record and counts it; the sink prints the count with the next line.
+ */
+
+#ifndef BSW_SERVICE_LOG_H_
+#define BSW_SERVICE_LOG_H_
+
+#include "Ifx_Types.h"
+
+#define LOG_ARGS_MAX 4
+#define LOG_MAILBOX_SIZE 64             /* records, a power of two */
+#define LOG_LINE_MAX 128                /* formatted line, longer ones are cut */
+
+typedef struct
+{
+    const char *format;                 /* the message ID */
+    uint32 count;                       /* arguments used */
+    uint32 args[LOG_ARGS_MAX];
+} LogRecord;
+
+/* LOG_PRINTF(fmt, ...) with 0 to LOG_ARGS_MAX arguments */
+#define LOG_PRINTF(...) LOG_SELECT(__VA_ARGS__, LOG_4, LOG_3, LOG_2, LOG_1, LOG_0, 0)(__VA_ARGS__)
+#define LOG_SELECT(fmt, a0, a1, a2, a3, name, ...) name
+#define LOG_0(fmt) logWrite((fmt), 0, 0, 0, 0, 0)
+#define LOG_1(fmt, a0) logWrite((fmt), 1, (uint32)(a0), 0, 0, 0)
+#define LOG_2(fmt, a0, a1) logWrite((fmt), 2, (uint32)(a0), (uint32)(a1), 0, 0)
+#define LOG_3(fmt, a0, a1, a2) logWrite((fmt), 3, (uint32)(a0), (uint32)(a1), (uint32)(a2), 0)
+#define LOG_4(fmt, a0, a1, a2, a3) logWrite((fmt), 4, (uint32)(a0), (uint32)(a1), (uint32)(a2), (uint32)(a3))
+
+/* the bits of a float argument, formatted by %f, %e or %g */
+static inline uint32 logFloat(float32 value)
+{
+    union
+    {
+        float32 f;
+        uint32 u;
+    } bits;
+
+    bits.f = value;
+    return bits.u;
+}
+
+void logWrite(const char *format, uint32 count, uint32 a0, uint32 a1, uint32 a2, uint32 a3);
+void logPump(void);
+uint32 logGetDropCount(void);
+
+#endif /* BSW_SERVICE_LOG_H_ */
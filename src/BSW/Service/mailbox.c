@@ -0,0 +1,87 @@
+#include "mailbox.h"
+
+#include <string.h>
+
+#include "IfxCpu.h"
+
+/* 꽉 차 있으면 버리고 dropped 를 센다. producer 코어에서만 호출 */
+boolean mailboxPush(Mailbox *box, const void *item)
+{
+    uint32 head = box->head;
+
+    if (head - box->tail >= box->capacity)
+    {
+        box->dropped++;
+        return FALSE;
+    }
+
+    memcpy(&box->buffer[(head & (box->capacity - 1)) * box->itemSize], item, box->itemSize);
+    __dsync();              // 데이터가 먼저 보인 다음 head 가 보이도록
+    box->head = head + 1;
+
+    return TRUE;
+}
+
+/* count 개를 한 번에 넣는다. 다 들어갈 자리가 없으면 하나도 넣지 않고 count 개를 dropped 로 센다.
+ * 복사는 링 끝에서 많아야 두 번으로 나뉘고, head 는 한 번만 올리므로 consumer 는 전부 아니면 아무것도 못 본다 */
+boolean mailboxPushN(Mailbox *box, const void *items, uint32 count)
+{
+    uint32 head = box->head;
+    uint32 index = head & (box->capacity - 1);
+    uint32 first = box->capacity - index;
+
+    if (count > box->capacity - (head - box->tail))
+    {
+        box->dropped += count;
+        return FALSE;
+    }
+
+    if (first > count)
+    {
+        first = count;
+    }
+    memcpy(&box->buffer[index * box->itemSize], items, first * box->itemSize);
+    memcpy(box->buffer, (const uint8 *)items + first * box->itemSize, (count - first) * box->itemSize);
+    __dsync();              // 데이터가 먼저 보인 다음 head 가 보이도록
+    box->head = head + count;
+
+    return TRUE;
+}
+
+/* 비어 있으면 FALSE. consumer 코어에서만 호출 */
+boolean mailboxPop(Mailbox *box, void *item)
+{
+    uint32 tail = box->tail;
+
+    if (tail == box->head)
+    {
+        return FALSE;
+    }
+
+    memcpy(item, &box->buffer[(tail & (box->capacity - 1)) * box->itemSize], box->itemSize);
+    __dsync();              // 다 읽은 다음에 슬롯을 돌려준다
+    box->tail = tail + 1;
+
+    return TRUE;
+}
+
+boolean mailboxIsEmpty(const Mailbox *box)
+{
+    return box->tail == box->head;
+}
+
+boolean mailboxIsFull(const Mailbox *box)
+{
+    return box->head - box->tail >= box->capacity;
+}
+
+/* producer 가 지금 넣을 수 있는 개수. consumer 가 꺼내면 늘어날 뿐 줄지 않는다 */
+uint32 mailboxGetSpace(const Mailbox *box)
+{
+    return box->capacity - (box->head - box->tail);
+}
+
+uint32 mailboxGetDropped(const Mailbox *box)
+{
+    return box->dropped;
+}
@@ -0,0 +1,42 @@
+/*
+ * mailbox.h
+ *
+ *  Lock-free single-producer / single-consumer queue between two cores.
+ *  Only the producer writes head and only the consumer writes tail, so no
+ *  lock or interrupt masking is needed across cores.
+ *
+ *  Mailboxes are plain globals and therefore land in CPU0's DSPR (default_ram
+ *  in both linker scripts). DSPR is not cached, so CPU1/CPU2 see every store
+ *  without cache maintenance; do not move a mailbox into the cached LMU
+ *  segment (0x9xxxxxxx).
+ */
+
+#ifndef BSW_SERVICE_MAILBOX_H_
+#define BSW_SERVICE_MAILBOX_H_
+
+#include "Ifx_Types.h"
+
+typedef struct
+{
+    volatile uint32 head;       /* written by the producer only */
+    volatile uint32 tail;       /* written by the consumer only */
+    volatile uint32 dropped;    /* pushes lost because the queue was full */
+    uint32 itemSize;
+    uint32 capacity;            /* power of two */
+    uint8 *buffer;
+} Mailbox;
+
+/* Statically initialised, so it is valid before the other cores start */
+#define MAILBOX_DEFINE(name, type, size)                                    \
+    static type name##Buffer[size];                                         \
+    Mailbox name = {0, 0, 0, sizeof(type), (size), (uint8 *)name##Buffer}
+
+boolean mailboxPush(Mailbox *box, const void *item);
+boolean mailboxPushN(Mailbox *box, const void *items, uint32 count);
+boolean mailboxPop(Mailbox *box, void *item);
+boolean mailboxIsEmpty(const Mailbox *box);
+boolean mailboxIsFull(const Mailbox *box);
+uint32 mailboxGetSpace(const Mailbox *box);
+uint32 mailboxGetDropped(const Mailbox *box);
+
+#endif /* BSW_SERVICE_MAILBOX_H_ */
@@ -1,5 +1,16 @@
 #include "motor.h"
 
+#include "profile.h"
+#include "recorder.h"
+
+/* 기록 중이면 모터 명령 하나를 남긴다 */
+static void motorRecord(int dutyA, int dirA, int dutyB, int dirB, boolean brake)
+{
+    uint8 bits = (uint8)((dirA ? RECORD_MOTOR_DIR_A : 0) | (dirB ? RECORD_MOTOR_DIR_B : 0) |
+                         (brake ? RECORD_MOTOR_BRAKE : 0));
+    recorderAdd(RECORD_MOTOR, bits, getTime10Ns(), dutyA, dutyB);
+}
+
 void motorInit(void)
 {
     MODULE_P02.IOCR4.B.PC7 = 0x10;  // A Break
@@ -9,8 +20,7 @@ void motorInit(void)
 
     gtmAtomPwmInit();
 
-    gtmAtomPwmASetDutyCycle(0);
-    gtmAtomPwmBSetDutyCycle(0);
+    gtmAtomPwmSetDutyCycleAB(0, 0);
 }
 
 void motorStopChA(void)
@@ -56,13 +66,28 @@ void motorMovChBPwm(int duty, int dir)
     MODULE_P02.OUT.B.P6 = 0;   /* 모터 Brake 해제 (1: 정지, 0: PWM-A에 따라 동작) */
 }
 
+/* 양쪽 바퀴를 같은 PWM 주기에 바꾼다 (1: 정방향, 0: 역방향) */
+void motorMovPwm(int dutyA, int dirA, int dutyB, int dirB)
+{
+    motorRecord(dutyA, dirA, dutyB, dirB, FALSE);
+
+    PROFILE_BEGIN(PROFILE_PWM_UPDATE);
+    gtmAtomPwmSetDutyCycleAB(dutyA, dutyB);
+
+    MODULE_P10.OUT.B.P1 = dirA ? 1 : 0;  /* 모터 회전 방향 (1: 앞, 0: 뒤) */
+    MODULE_P10.OUT.B.P2 = dirB ? 1 : 0;
+
+    MODULE_P02.OUT.B.P7 = 0;   /* 모터 Brake 해제 */
+    MODULE_P02.OUT.B.P6 = 0;
+    PROFILE_END(PROFILE_PWM_UPDATE);
+}
+
 void motorSoftBraking(int duty)
 {
     while (duty > 0)
     {
         duty = (duty >= 100) ? duty - 100 : 0;
-        gtmAtomPwmASetDutyCycle(duty);
-        gtmAtomPwmBSetDutyCycle(duty);
+        gtmAtomPwmSetDutyCycleAB(duty, duty);
     }
 
     motorStop();  // 마지막에 완전 정지
@@ -74,8 +99,7 @@ void motorHardBraking(int duty)
     MODULE_P10.OUT.B.P1 = 0;
     MODULE_P10.OUT.B.P2 = 0;
 
-    gtmAtomPwmASetDutyCycle(duty);
-    gtmAtomPwmBSetDutyCycle(duty);
+    gtmAtomPwmSetDutyCycleAB(duty, duty);
 
     delayMs(200);
 
@@ -84,18 +108,19 @@ void motorHardBraking(int duty)
 
 void motorMoveForward(int duty)
 {
+    motorRecord(duty, 1, duty, 1, FALSE);
     MODULE_P10.OUT.B.P1 = 1;
     MODULE_P10.OUT.B.P2 = 1;
 
     MODULE_P02.OUT.B.P7 = 0;
     MODULE_P02.OUT.B.P6 = 0;
 
-    gtmAtomPwmASetDutyCycle(duty);
-    gtmAtomPwmBSetDutyCycle(duty);
+    gtmAtomPwmSetDutyCycleAB(duty, duty);
 }
 
 void motorMoveReverse (int duty)
 {
+    motorRecord(duty, 0, duty, 0, FALSE);
     MODULE_P10.OUT.B.P1 = 0;
     MODULE_P10.OUT.B.P2 = 0;
 
@@ -104,15 +129,14 @@ void motorMoveReverse (int duty)
     MODULE_P02.OUT.B.P6 = 0;
 
 
-    gtmAtomPwmASetDutyCycle(duty);
-    gtmAtomPwmBSetDutyCycle(duty);
+    gtmAtomPwmSetDutyCycleAB(duty, duty);
 }
 
 void motorStop(void){
+    motorRecord(0, 0, 0, 0, TRUE);
     MODULE_P02.OUT.B.P7 = 1;
     MODULE_P02.OUT.B.P6 = 1;
 
-    gtmAtomPwmASetDutyCycle(0);
-    gtmAtomPwmBSetDutyCycle(0);
+    gtmAtomPwmSetDutyCycleAB(0, 0);
 }
 
@@ -28,6 +28,8 @@ void motorStopChB(void);
 ///* 1: 정방향, 0: 역방향 */
 void motorMovChBPwm(int duty, int dir);
 void motorKeypadPwm(char c, int duty);
+///* A/B 를 한 번에, 1: 정방향, 0: 역방향 */
+void motorMovPwm(int dutyA, int dirA, int dutyB, int dirB);
 
 void motorSoftBraking(int duty);
 void motorHardBraking(int duty);
@@ -0,0 +1,61 @@
+#include "odometry.h"
+
+#include <math.h>
+
+#include "gpt12_incr_enc.h"
+#include "recorder.h"
+#include "util.h"
+
+#define ODOMETRY_MM_PER_COUNT (ODOMETRY_WHEEL_DIAMETER_MM * IFX_PI / ENC_COUNTS_PER_REV)
+
+static OdometryPose g_pose;
+static sint32 g_lastCount[ENC_WHEELS_NUM];
+
+/* CPU0 에서 한 번. periodUs 는 odometryUpdate() 호출 주기 */
+void odometryInit(uint32 periodUs)
+{
+    gpt12IncrEncInit(periodUs);
+
+    g_pose.x = 0.0f;
+    g_pose.y = 0.0f;
+    g_pose.heading = 0.0f;
+    g_pose.distance = 0.0f;
+    for (int wheel = 0; wheel < ENC_WHEELS_NUM; wheel++)
+    {
+        g_lastCount[wheel] = gpt12IncrEncGetCount((EncWheel)wheel);
+    }
+}
+
+/* 제어 주기마다 호출. 주기 동안의 바퀴 이동량으로 pose 를 적분 (중간 heading 사용) */
+void odometryUpdate(void)
+{
+    gpt12IncrEncUpdate();
+
+    sint32 left = gpt12IncrEncGetCount(ENC_LEFT);
+    sint32 right = gpt12IncrEncGetCount(ENC_RIGHT);
+    recorderAdd(RECORD_ENCODER, 0, getTime10Ns(), left - g_lastCount[ENC_LEFT], right - g_lastCount[ENC_RIGHT]);
+    float32 dLeft = (float32)(left - g_lastCount[ENC_LEFT]) * ODOMETRY_MM_PER_COUNT;
+    float32 dRight = (float32)(right - g_lastCount[ENC_RIGHT]) * ODOMETRY_MM_PER_COUNT;
+    g_lastCount[ENC_LEFT] = left;
+    g_lastCount[ENC_RIGHT] = right;
+
+    float32 d = (dLeft + dRight) * 0.5f;
+    float32 dHeading = (dRight - dLeft) / ODOMETRY_TRACK_MM;
+    float32 mid = g_pose.heading + dHeading * 0.5f;
+
+    g_pose.x += d * cosf(mid);
+    g_pose.y += d * sinf(mid);
+    g_pose.heading += dHeading;
+    g_pose.distance += d;
+}
+
+OdometryPose odometryGetPose(void)
+{
+    return g_pose;
+}
+
+/* 다음 odometryUpdate() 부터 pose 에서 이어서 적분한다 (기록 재생용) */
+void odometrySetPose(const OdometryPose *pose)
+{
+    g_pose = *pose;
+}
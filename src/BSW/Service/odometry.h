@@ -0,0 +1,31 @@
+/*
+ * odometry.h
+ *
+ *  Differential drive pose from the two wheel encoders (gpt12_incr_enc).
+ *  The pose starts at (0, 0) heading 0 in odometryInit(); x is forward,
+ *  y to the left, heading counter-clockwise. odometryUpdate() runs on the
+ *  CPU0 control tick, so the pose is at most one period old.
+ */
+
+#ifndef BSW_SERVICE_ODOMETRY_H_
+#define BSW_SERVICE_ODOMETRY_H_
+
+#include "Ifx_Types.h"
+
+#define ODOMETRY_WHEEL_DIAMETER_MM 65.0f
+#define ODOMETRY_TRACK_MM 150.0f        /* distance between the wheel contact points */
+
+typedef struct
+{
+    float32 x;              /* mm */
+    float32 y;              /* mm */
+    float32 heading;        /* rad, not wrapped, so turns can be measured as a difference */
+    float32 distance;       /* mm travelled by the centre point, negative when reversing */
+} OdometryPose;
+
+void odometryInit(uint32 periodUs);
+void odometryUpdate(void);
+OdometryPose odometryGetPose(void);
+void odometrySetPose(const OdometryPose *pose);
+
+#endif /* BSW_SERVICE_ODOMETRY_H_ */
@@ -0,0 +1,202 @@
+#include "param_store.h"
+
+#include "Ifx_Crc.h"
+
+#include <string.h>
+
+#define PARAM_STORE_CRC_OFFSET (PARAM_STORE_SLOT_SIZE - 4)
+#define PARAM_STORE_NONE 0xFFFFFFFFu    // 찾은 레코드가 없음
+
+static Ifc_Crc_Table32 g_paramCrcTable;
+static Ifc_Crc g_paramCrc;
+
+// paramStoreInit() 이 찾은 최신 레코드와 다음에 쓸 칸. 칸 번호는 링 전체에서 센다 (섹터 * PARAM_STORE_SLOTS + 칸)
+static uint32 g_current = PARAM_STORE_NONE;
+static uint32 g_next = 0;
+static uint32 g_sequence = 0;
+static uint8 g_record[PARAM_STORE_SLOT_SIZE];   // g_current 의 내용
+
+/*********************************************************************************************************************/
+/*------------------------------------------Private Function Implementations-----------------------------------------*/
+/*********************************************************************************************************************/
+
+static uint32 slotOffset(uint32 slot)
+{
+    return PARAM_STORE_OFFSET + slot * PARAM_STORE_SLOT_SIZE;
+}
+
+static uint32 get32(const uint8 *p)
+{
+    return (uint32)p[0] | ((uint32)p[1] << 8) | ((uint32)p[2] << 16) | ((uint32)p[3] << 24);
+}
+
+static uint16 get16(const uint8 *p)
+{
+    return (uint16)(p[0] | (p[1] << 8));
+}
+
+static void put32(uint8 *p, uint32 value)
+{
+    p[0] = (uint8)value;
+    p[1] = (uint8)(value >> 8);
+    p[2] = (uint8)(value >> 16);
+    p[3] = (uint8)(value >> 24);
+}
+
+static void put16(uint8 *p, uint16 value)
+{
+    p[0] = (uint8)value;
+    p[1] = (uint8)(value >> 8);
+}
+
+static uint32 recordCrc(const uint8 *record)
+{
+    return Ifx_Crc_tableFast(&g_paramCrc, (uint8 *)record, PARAM_STORE_CRC_OFFSET);
+}
+
+/* 칸을 읽어 record 에 두고, 온전한 레코드면 TRUE */
+static boolean readSlot(uint32 slot, uint8 *record)
+{
+    dflashRead(slotOffset(slot), record, PARAM_STORE_SLOT_SIZE);
+    return get32(&record[0]) == PARAM_STORE_MAGIC &&
+           get16(&record[10]) <= PARAM_STORE_DATA_MAX &&
+           get32(&record[PARAM_STORE_CRC_OFFSET]) == recordCrc(record);
+}
+
+/* 쓰기는 페이지 순서대로 하므로 magic 자리가 지워진 상태면 그 칸은 통째로 비어 있다 */
+static boolean slotUsed(uint32 slot)
+{
+    uint32 magic;
+
+    dflashRead(slotOffset(slot), &magic, sizeof(magic));
+    return magic != DFLASH_ERASED_WORD;
+}
+
+/* 섹터 안 첫 빈 칸 (다 찼으면 PARAM_STORE_SLOTS). 칸은 앞에서부터 채워지므로 이분 탐색 */
+static uint32 firstFreeSlot(uint32 sector)
+{
+    uint32 lo = 0;
+    uint32 hi = PARAM_STORE_SLOTS;
+
+    while (lo < hi)
+    {
+        uint32 mid = (lo + hi) / 2;
+        if (slotUsed(sector * PARAM_STORE_SLOTS + mid))
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/*********************************************************************************************************************/
+/*-------------------------------------------Public Function Implementations-----------------------------------------*/
+/*********************************************************************************************************************/
+
+/* CPU0 에서 부팅 때 한 번. 최신 레코드를 찾아 g_record 에 둔다.
+ * 섹터마다 첫 칸 하나, 쓰던 섹터에서 이분 탐색 log2(PARAM_STORE_SLOTS) 번, 레코드 CRC 한 번을 읽는다 */
+void paramStoreInit(void)
+{
+    uint8 record[PARAM_STORE_SLOT_SIZE];
+    uint32 active = PARAM_STORE_NONE;
+
+    Ifx_Crc_createTable(&g_paramCrcTable.data, 32, 0x04C11DB7, 1);
+    Ifx_Crc_init(&g_paramCrc, &g_paramCrcTable.data, 1, 1, 0xFFFFFFFF, 0xFFFFFFFF);
+
+    g_current = PARAM_STORE_NONE;
+    g_next = 0;
+    g_sequence = 0;
+
+    // 쓰던 섹터는 첫 칸의 sequence 가 가장 큰 섹터. 지우다 끊긴 섹터는 첫 칸 CRC 가 맞지 않아 빠진다
+    for (uint32 sector = 0; sector < PARAM_STORE_SECTOR_NUM; sector++)
+    {
+        if (readSlot(sector * PARAM_STORE_SLOTS, record) &&
+            (active == PARAM_STORE_NONE || (sint32)(get32(&record[4]) - g_sequence) > 0))
+        {
+            active = sector;
+            g_sequence = get32(&record[4]);
+        }
+    }
+    if (active == PARAM_STORE_NONE)
+    {
+        return;
+    }
+
+    // 마지막으로 쓴 칸이 끊겼으면 그 앞 칸으로. 첫 칸은 위에서 확인했으므로 반드시 멈춘다
+    uint32 used = firstFreeSlot(active);
+    g_next = active * PARAM_STORE_SLOTS + used;
+    for (uint32 slot = g_next - 1; ; slot--)
+    {
+        if (readSlot(slot, g_record))
+        {
+            g_current = slot;
+            g_sequence = get32(&g_record[4]);
+            break;
+        }
+    }
+}
+
+/* version 과 length 가 모두 같은 최신 레코드를 data 로. 없으면 FALSE 이고 data 는 그대로 */
+boolean paramStoreLoad(uint16 version, void *data, uint16 length)
+{
+    if (g_current == PARAM_STORE_NONE || get16(&g_record[8]) != version || get16(&g_record[10]) != length)
+    {
+        return FALSE;
+    }
+    memcpy(data, &g_record[PARAM_STORE_HEADER_SIZE], length);
+    return TRUE;
+}
+
+/* 다음 빈 칸에 새 레코드를 쓰고 읽어서 확인한다. 섹터가 다 찼으면 링의 다음 섹터를 지우고 그 첫 칸에.
+ * 섹터를 지우는 동안 (수십 ms) CPU0 가 멈추므로 차가 서 있을 때만 부른다 */
+boolean paramStoreSave(uint16 version, const void *data, uint16 length)
+{
+    uint8 record[PARAM_STORE_SLOT_SIZE];
+    uint8 check[PARAM_STORE_SLOT_SIZE];
+
+    if (length > PARAM_STORE_DATA_MAX)
+    {
+        return FALSE;
+    }
+
+    memset(record, 0, sizeof(record));
+    put32(&record[0], PARAM_STORE_MAGIC);
+    put32(&record[4], g_sequence + 1);
+    put16(&record[8], version);
+    put16(&record[10], length);
+    memcpy(&record[PARAM_STORE_HEADER_SIZE], data, length);
+    put32(&record[PARAM_STORE_CRC_OFFSET], recordCrc(record));
+
+    g_next %= PARAM_STORE_SECTOR_NUM * PARAM_STORE_SLOTS;
+    if (g_next % PARAM_STORE_SLOTS == 0 && dflashEraseSector(slotOffset(g_next)) == FALSE)
+    {
+        return FALSE;
+    }
+
+    // 실패한 칸은 비어 있지 않을 수 있으므로 다음 저장은 그 뒤 칸에
+    uint32 slot = g_next++;
+    if (dflashWrite(slotOffset(slot), record, PARAM_STORE_SLOT_SIZE) == FALSE)
+    {
+        return FALSE;
+    }
+    dflashRead(slotOffset(slot), check, PARAM_STORE_SLOT_SIZE);
+    if (memcmp(check, record, PARAM_STORE_SLOT_SIZE) != 0)
+    {
+        return FALSE;
+    }
+
+    memcpy(g_record, record, PARAM_STORE_SLOT_SIZE);
+    g_current = slot;
+    g_sequence++;
+    return TRUE;
+}
+
+/* 최신 레코드의 sequence (저장 횟수). 없으면 0 */
+uint32 paramStoreGetSequence(void)
+{
+    return (g_current == PARAM_STORE_NONE) ? 0 : g_sequence;
+}
@@ -0,0 +1,38 @@
+/*
+ * param_store.h
+ *
+ *  Versioned parameter block in data flash, written as an append-only log of
+ *  fixed-size records over a ring of PARAM_STORE_SECTOR_NUM sectors.
+ *
+ *  | magic | sequence | version (LE16) | length (LE16) | data[PARAM_STORE_DATA_MAX] | crc |
+ *
+ *  All fields are 32-bit little-endian unless noted; crc is CRC-32 (poly
+ *  0x04C11DB7, reflected, init and xor 0xFFFFFFFF) over magic..data. Each save
+ *  goes to the next erased slot, and a sector is erased only when the log moves
+ *  into it, so every sector sees one erase per PARAM_STORE_SLOTS (32) saves. Slots
+ *  fill in order, so paramStoreInit() finds the newest record from the first
+ *  slot of each sector plus a binary search, without reading the whole ring.
+ *  A record whose CRC does not match (torn write) is skipped in favour of the
+ *  one before it.
+ */
+
+#ifndef BSW_SERVICE_PARAM_STORE_H_
+#define BSW_SERVICE_PARAM_STORE_H_
+
+#include "Ifx_Types.h"
+#include "dflash.h"
+
+#define PARAM_STORE_OFFSET 0                // DFLASH offset of the first sector
+#define PARAM_STORE_SECTOR_NUM 4
+#define PARAM_STORE_SLOT_SIZE 128           // multiple of DFLASH_PAGE_SIZE
+#define PARAM_STORE_HEADER_SIZE 12
+#define PARAM_STORE_SLOTS (DFLASH_SECTOR_SIZE / PARAM_STORE_SLOT_SIZE)  // per sector
+#define PARAM_STORE_DATA_MAX (PARAM_STORE_SLOT_SIZE - PARAM_STORE_HEADER_SIZE - 4)
+#define PARAM_STORE_MAGIC 0x4D525041u       // "APRM"
+
+void paramStoreInit(void);
+boolean paramStoreLoad(uint16 version, void *data, uint16 length);
+boolean paramStoreSave(uint16 version, const void *data, uint16 length);
+uint32 paramStoreGetSequence(void);
+
+#endif /* BSW_SERVICE_PARAM_STORE_H_ */
@@ -0,0 +1,159 @@
+#include "profile.h"
+
+#if PROFILE_ENABLE
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bluetooth.h"
+#include "util.h"
+
+#define PROFILE_LINE_MAX 128        // bluetoothPrintf() 한 줄의 최대 길이
+#define PROFILE_HIST_LINE 80        // 히스토그램 줄을 이 길이에서 나눈다
+#define PROFILE_WAIT_US 50          // 보고 중 TX mailbox 자리를 기다리는 간격
+
+static ProfileStats g_profile[PROFILE_SCOPE_NUM];
+
+static const char *PROFILE_NAMES[PROFILE_SCOPE_NUM] = {
+    "pd_steer", "filter", "bt_printf", "pwm_update"
+};
+
+/* 사이클 수의 log2 구간. 0 은 2^PROFILE_HIST_MIN_LOG2 미만, 마지막 구간은 그 위 전부 */
+static uint32 histBin(uint32 cycles)
+{
+    uint32 bin = 0;
+
+    cycles >>= PROFILE_HIST_MIN_LOG2;
+    while (cycles != 0 && bin < PROFILE_HIST_BINS - 1)
+    {
+        cycles >>= 1;
+        bin++;
+    }
+    return bin;
+}
+
+/* 줄 하나가 통째로 들어갈 때까지 기다린다. 자리가 없으면 bluetoothPrintf() 는 줄을 버린다 */
+static void waitTxSpace(void)
+{
+    while (bluetoothGetTxSpace() < 2 * PROFILE_LINE_MAX)
+    {
+        delayUs(PROFILE_WAIT_US);
+    }
+}
+
+/* CPU0 의 카운터를 켜고 표를 비운다 (systemInit) */
+void profileInit(void)
+{
+    perfCounterInit();
+    profileReset();
+}
+
+void profileReset(void)
+{
+    memset(g_profile, 0, sizeof(g_profile));
+    for (uint32 i = 0; i < PROFILE_SCOPE_NUM; i++)
+    {
+        g_profile[i].minCycles = 0xFFFFFFFFu;
+    }
+}
+
+/* PROFILE_END(): start 부터 지금까지의 카운터 차이를 scope 에 더한다 (CPU0) */
+void profileAdd(ProfileScope scope, const PerfSample *start)
+{
+    PerfSample now;
+    ProfileStats *s = &g_profile[scope];
+
+    perfCounterRead(&now);
+    uint32 cycles = (now.cycles - start->cycles) & PERF_COUNTER_MASK;
+
+    s->count++;
+    s->cycles += cycles;
+    s->instructions += (now.instructions - start->instructions) & PERF_COUNTER_MASK;
+    for (uint32 i = 0; i < PERF_EVENTS_NUM; i++)
+    {
+        s->events[i] += (now.events[i] - start->events[i]) & PERF_COUNTER_MASK;
+    }
+    if (cycles < s->minCycles)
+    {
+        s->minCycles = cycles;
+    }
+    if (cycles > s->maxCycles)
+    {
+        s->maxCycles = cycles;
+    }
+    s->histogram[histBin(cycles)]++;
+}
+
+void profileGetStats(ProfileStats stats[PROFILE_SCOPE_NUM])
+{
+    memcpy(stats, g_profile, sizeof(g_profile));
+}
+
+const char *profileGetName(ProfileScope scope)
+{
+    return PROFILE_NAMES[scope];
+}
+
+/* 지난 보고 이후의 표를 Bluetooth 로 보내고 비운다. 보고 자체의 bluetoothPrintf() 가 섞이지
+ * 않도록 먼저 복사하고 비운다. 정지한 상태에서 부른다 (CPU0, 다 보낼 때까지 돌아오지 않음) */
+void profileReport(void)
+{
+    ProfileStats stats[PROFILE_SCOPE_NUM];
+    char line[PROFILE_LINE_MAX];
+
+    profileGetStats(stats);
+    profileReset();
+
+    waitTxSpace();
+    bluetoothPrintf("%-10s %7s %8s %8s %8s %5s %8s %8s %8s\n", "scope", "count", "min", "mean", "max",
+                    "ipc", "m1", "m2", "m3");
+    for (uint32 i = 0; i < PROFILE_SCOPE_NUM; i++)
+    {
+        const ProfileStats *s = &stats[i];
+
+        if (s->count == 0)
+        {
+            continue;
+        }
+
+        waitTxSpace();
+        bluetoothPrintf("%-10s %7u %8u %8u %8u %5.2f %8u %8u %8u\n", PROFILE_NAMES[i], (unsigned)s->count,
+                        (unsigned)s->minCycles, (unsigned)(s->cycles / s->count), (unsigned)s->maxCycles,
+                        (float32)s->instructions / (float32)s->cycles, (unsigned)(s->events[0] / s->count),
+                        (unsigned)(s->events[1] / s->count), (unsigned)(s->events[2] / s->count));
+
+        // 비어 있지 않은 구간만 "<2^k:개수" 로
+        int n = 0;
+        for (uint32 bin = 0; bin < PROFILE_HIST_BINS; bin++)
+        {
+            if (s->histogram[bin] == 0)
+            {
+                continue;
+            }
+            if (bin < PROFILE_HIST_BINS - 1)
+            {
+                n += sprintf(&line[n], " <2^%u:%u", (unsigned)(PROFILE_HIST_MIN_LOG2 + bin), (unsigned)s->histogram[bin]);
+            }
+            else
+            {
+                n += sprintf(&line[n], " >=2^%u:%u", (unsigned)(PROFILE_HIST_MIN_LOG2 + bin - 1),
+                             (unsigned)s->histogram[bin]);
+            }
+            if (n > PROFILE_HIST_LINE)
+            {
+                waitTxSpace();
+                bluetoothPrintf("          %s\n", line);
+                n = 0;
+            }
+        }
+        if (n > 0)
+        {
+            waitTxSpace();
+            bluetoothPrintf("          %s\n", line);
+        }
+    }
+    waitTxSpace();
+    bluetoothPrintf("(cycles per call, m1..m3 per call, CCTRL event select %d)\n", PERF_EVENT_SELECT);
+}
+
+#endif /* PROFILE_ENABLE */
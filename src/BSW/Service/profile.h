@@ -0,0 +1,81 @@
+/*
+ * profile.h
+ *
+ *  Per-scope cycle profile from the TriCore performance counters
+ *  (BSW/MCAL/perf_counter.h). PROFILE_BEGIN()/PROFILE_END() bracket a scope
+ *  in one function; each pass adds its CCNT, ICNT and M1CNT..M3CNT deltas to
+ *  the scope's entry in a fixed table: count, min/max/sum of cycles, sums of
+ *  instructions and events, and a log2 histogram of cycles.
+ *
+ *  The table belongs to CPU0; the instrumented scopes all run there. The
+ *  cycles include any interrupt taken inside the scope.
+ *
+ *  Release builds (NDEBUG) compile the macros to nothing and leave out the
+ *  table and the report; -DPROFILE_ENABLE=0 does the same in a debug build.
+ *  Command 'f' prints the table over Bluetooth and clears it. On the host,
+ *  perfCounterRead() returns the TSC (or clock_gettime() nanoseconds) as
+ *  cycles and zero for the other counters; autopark_sil -P prints the table.
+ */
+
+#ifndef BSW_SERVICE_PROFILE_H_
+#define BSW_SERVICE_PROFILE_H_
+
+#include "Ifx_Types.h"
+
+#include "perf_counter.h"
+
+#ifndef PROFILE_ENABLE
+#ifdef NDEBUG
+#define PROFILE_ENABLE 0
+#else
+#define PROFILE_ENABLE 1
+#endif
+#endif
+
+/* histogram bin 0 counts passes under 2^PROFILE_HIST_MIN_LOG2 cycles, bin i the ones under
+ * 2^(PROFILE_HIST_MIN_LOG2 + i), the last bin everything above */
+#define PROFILE_HIST_BINS 16
+#define PROFILE_HIST_MIN_LOG2 6
+
+typedef enum
+{
+    PROFILE_PD_STEER,                   /* pd_calculateSteeringMv(), pd_steerByEstimate() */
+    PROFILE_FILTER,                     /* getFilteredDistance() */
+    PROFILE_BT_PRINTF,                  /* bluetoothPrintf() */
+    PROFILE_PWM_UPDATE,                 /* motorMovPwm() duty and direction update */
+    PROFILE_SCOPE_NUM
+} ProfileScope;
+
+typedef struct
+{
+    uint32 count;
+    uint32 minCycles;
+    uint32 maxCycles;
+    uint64 cycles;                      /* sums over count passes */
+    uint64 instructions;
+    uint64 events[PERF_EVENTS_NUM];
+    uint32 histogram[PROFILE_HIST_BINS];
+} ProfileStats;
+
+#if PROFILE_ENABLE
+
+#define PROFILE_BEGIN(scope) PerfSample profileStart##scope; perfCounterRead(&profileStart##scope)
+#define PROFILE_END(scope) profileAdd((scope), &profileStart##scope)
+
+void profileInit(void);
+void profileAdd(ProfileScope scope, const PerfSample *start);
+void profileReset(void);
+void profileGetStats(ProfileStats stats[PROFILE_SCOPE_NUM]);
+const char *profileGetName(ProfileScope scope);
+void profileReport(void);
+
+#else
+
+#define PROFILE_BEGIN(scope)
+#define PROFILE_END(scope) ((void)0)
+
+#define profileInit() ((void)0)
+
+#endif /* PROFILE_ENABLE */
+
+#endif /* BSW_SERVICE_PROFILE_H_ */
@@ -0,0 +1,113 @@
+#include "recorder.h"
+
+#include <string.h>
+
+#include "telemetry.h"
+#include "util.h"
+
+#define RECORDER_PER_FRAME 3            // 덤프 프레임 하나에 넣는 항목 수 (index 2 + 16 * 3 바이트)
+#define RECORDER_HEADER_INDEX 0xFFFF    // 첫 프레임: 항목 수와 버린 수
+
+/* CPU1 DSPR (240 KB) 은 CPU1 스택과 CSA 말고는 거의 비어 있으므로 거기에 둔다. CPU0 는 SRI 로 쓴다 */
+static RecordEntry g_records[RECORDER_ENTRIES] __attribute__((section(".bss_cpu1")));
+static uint32 g_recordCount = 0;
+static uint32 g_recordDropped = 0;
+static boolean g_recording = FALSE;
+
+/* 비우고 기록을 시작한다 (CPU0) */
+void recorderStart(void)
+{
+    g_recordCount = 0;
+    g_recordDropped = 0;
+    g_recording = TRUE;
+}
+
+void recorderStop(void)
+{
+    g_recording = FALSE;
+}
+
+boolean recorderIsActive(void)
+{
+    return g_recording;
+}
+
+/* 항목 하나를 덧붙인다. 기록 중이 아니면 아무것도 안 하고, 가득 찼으면 버린 수만 센다 (CPU0) */
+void recorderAdd(RecordType type, uint8 channel, uint64 time, sint32 a, sint32 b)
+{
+    if (g_recording == FALSE)
+    {
+        return;
+    }
+    if (g_recordCount >= RECORDER_ENTRIES)
+    {
+        g_recordDropped++;
+        return;
+    }
+
+    RecordEntry *e = &g_records[g_recordCount++];
+    e->timeLo = (uint32)time;
+    e->timeHi = (uint16)(time >> 32);
+    e->type = (uint8)type;
+    e->channel = channel;
+    e->a = a;
+    e->b = b;
+}
+
+/* float 두 개를 비트 그대로 남긴다 (튜닝 변수, pose) */
+void recorderAddFloat(RecordType type, uint8 channel, float32 a, float32 b)
+{
+    sint32 bitsA, bitsB;
+
+    if (g_recording == FALSE)
+    {
+        return;
+    }
+    memcpy(&bitsA, &a, sizeof(bitsA));
+    memcpy(&bitsB, &b, sizeof(bitsB));
+    recorderAdd(type, channel, getTime10Ns(), bitsA, bitsB);
+}
+
+uint32 recorderGetCount(void)
+{
+    return g_recordCount;
+}
+
+uint32 recorderGetDropCount(void)
+{
+    return g_recordDropped;
+}
+
+const RecordEntry *recorderGetEntries(void)
+{
+    return g_records;
+}
+
+/* 기록을 TELEMETRY_TYPE_RECORD 프레임으로 보낸다: 머리 프레임 (index 0xFFFF, 항목 수, 버린 수)
+ * 다음에 index 와 항목 최대 3 개씩. 정지한 상태에서 부른다 (CPU0, 다 보낼 때까지 돌아오지 않음) */
+void recorderDump(void)
+{
+    uint8 payload[TELEMETRY_PAYLOAD_MAX];
+    uint8 *p = payload;
+
+    p = telemetryPut16(p, RECORDER_HEADER_INDEX);
+    p = telemetryPut32(p, g_recordCount);
+    p = telemetryPut32(p, g_recordDropped);
+    telemetrySendWait(TELEMETRY_TYPE_RECORD, payload, (uint8)(p - payload));
+
+    for (uint32 i = 0; i < g_recordCount; i += RECORDER_PER_FRAME)
+    {
+        p = telemetryPut16(payload, (uint16)i);
+        for (uint32 j = i; j < g_recordCount && j < i + RECORDER_PER_FRAME; j++)
+        {
+            const RecordEntry *e = &g_records[j];
+            p = telemetryPut32(p, e->timeLo);
+            p = telemetryPut16(p, e->timeHi);
+            *p++ = e->type;
+            *p++ = e->channel;
+            p = telemetryPut32(p, (uint32)e->a);
+            p = telemetryPut32(p, (uint32)e->b);
+        }
+        telemetrySendWait(TELEMETRY_TYPE_RECORD, payload, (uint8)(p - payload));
+    }
+}
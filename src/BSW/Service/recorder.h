@@ -0,0 +1,70 @@
+/*
+ * recorder.h
+ *
+ *  Record of every input the autopark state machine sees and every motor
+ *  command it gives, for replaying a run offline (tools/sil, autopark_replay).
+ *
+ *  autoparkStart() clears and arms the buffer, autopark stops it when the run
+ *  ends. Entries are appended in the order the firmware consumes them:
+ *
+ *    RECORD_PARAM    channel = tunable index, a = float32 bits of the value.
+ *                    All of them at the start, then every change (live calibration).
+ *    RECORD_POSE     odometry pose at the start, channel 0: x, y; channel 1: heading, distance.
+ *    RECORD_COMMAND  channel = 'p' (autoparkStart) or 's' (autoparkAbort).
+ *    RECORD_TICK     autoparkStep() entry, channel = state.
+ *    RECORD_ENCODER  counts since the previous odometryUpdate(), a = left, b = right.
+ *    RECORD_ULTRA    sample returned by ultrasonicPop(), channel = sensor,
+ *                    time = end of the echo, a = echo width (10 ns), -1 if none.
+ *    RECORD_MOTOR    a = duty A, b = duty B, channel = RECORD_MOTOR_* bits.
+ *
+ *  The buffer does not wrap: a run's replay needs its start, so entries past
+ *  RECORDER_ENTRIES are counted as dropped instead. The dump is a sequence of
+ *  TELEMETRY_TYPE_RECORD frames; tools/pid-analyzer/pid_log.py --record turns
+ *  it back into the file autopark_replay reads.
+ */
+
+#ifndef BSW_SERVICE_RECORDER_H_
+#define BSW_SERVICE_RECORDER_H_
+
+#include "Ifx_Types.h"
+
+#define RECORDER_ENTRIES 12288          /* 192 KB, about 35 s of parking at 10 ms */
+
+/* RECORD_MOTOR channel bits */
+#define RECORD_MOTOR_DIR_A 0x01         /* 1: forward */
+#define RECORD_MOTOR_DIR_B 0x02
+#define RECORD_MOTOR_BRAKE 0x04
+
+typedef enum
+{
+    RECORD_PARAM = 1,
+    RECORD_POSE,
+    RECORD_COMMAND,
+    RECORD_TICK,
+    RECORD_ENCODER,
+    RECORD_ULTRA,
+    RECORD_MOTOR
+} RecordType;
+
+/* 16 bytes, little-endian on both the target and the host */
+typedef struct
+{
+    uint32 timeLo;                      /* getTime10Ns(), bits 0..31 */
+    uint16 timeHi;                      /* bits 32..47 */
+    uint8 type;                         /* RecordType */
+    uint8 channel;
+    sint32 a;
+    sint32 b;
+} RecordEntry;
+
+void recorderStart(void);
+void recorderStop(void);
+boolean recorderIsActive(void);
+void recorderAdd(RecordType type, uint8 channel, uint64 time, sint32 a, sint32 b);
+void recorderAddFloat(RecordType type, uint8 channel, float32 a, float32 b);
+uint32 recorderGetCount(void);
+uint32 recorderGetDropCount(void);
+const RecordEntry *recorderGetEntries(void);
+void recorderDump(void);
+
+#endif /* BSW_SERVICE_RECORDER_H_ */
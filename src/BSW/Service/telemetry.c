@@ -0,0 +1,73 @@
+#include "telemetry.h"
+
+#include "Ifx_Crc.h"
+#include "bluetooth.h"
+#include "util.h"
+
+#define TELEMETRY_HEADER_SIZE 6         // sync 2, type, length, seq 2
+#define TELEMETRY_CRC_SIZE 2
+
+static Ifc_Crc_Table16 g_telemetryCrcTable;
+static Ifc_Crc g_telemetryCrc;
+static uint16 g_telemetrySeq = 0;
+
+/* CRC 테이블 생성. 첫 telemetrySend() 전에 CPU0 에서 한 번 호출 */
+void telemetryInit(void)
+{
+    Ifx_Crc_createTable(&g_telemetryCrcTable.data, 16, 0x1021, 0);
+    Ifx_Crc_init(&g_telemetryCrc, &g_telemetryCrcTable.data, 1, 0, 0xFFFF, 0);
+    g_telemetrySeq = 0;
+}
+
+uint16 telemetryCrc(const uint8 *data, uint32 length)
+{
+    return (uint16)Ifx_Crc_tableFast(&g_telemetryCrc, (uint8 *)data, length);
+}
+
+uint8 *telemetryPut16(uint8 *p, uint16 value)
+{
+    p[0] = (uint8)value;
+    p[1] = (uint8)(value >> 8);
+    return p + 2;
+}
+
+uint8 *telemetryPut32(uint8 *p, uint32 value)
+{
+    p = telemetryPut16(p, (uint16)value);
+    return telemetryPut16(p, (uint16)(value >> 16));
+}
+
+/* 프레임 하나를 TX mailbox 에 통째로 넣는다. 자리가 없으면 버리고 FALSE (seq 는 증가) */
+boolean telemetrySend(uint8 type, const uint8 *payload, uint8 length)
+{
+    uint8 frame[TELEMETRY_HEADER_SIZE + TELEMETRY_PAYLOAD_MAX + TELEMETRY_CRC_SIZE];
+    uint8 *p = frame;
+
+    if (length > TELEMETRY_PAYLOAD_MAX)
+    {
+        return FALSE;
+    }
+
+    *p++ = TELEMETRY_SYNC0;
+    *p++ = TELEMETRY_SYNC1;
+    *p++ = type;
+    *p++ = length;
+    p = telemetryPut16(p, g_telemetrySeq++);
+    for (uint8 i = 0; i < length; i++)
+    {
+        *p++ = payload[i];
+    }
+    p = telemetryPut16(p, telemetryCrc(&frame[2], (uint32)(p - &frame[2])));
+
+    return bluetoothWrite((const char *)frame, (uint32)(p - frame));
+}
+
+/* 덤프용: 프레임이 TX mailbox 에 통째로 들어갈 때까지 기다렸다 보낸다. CPU2 가 비우므로 seq 가 빠지지 않는다 */
+void telemetrySendWait(uint8 type, const uint8 *payload, uint8 length)
+{
+    while (bluetoothGetTxSpace() < (uint32)length + TELEMETRY_OVERHEAD)
+    {
+        delayUs(TELEMETRY_WAIT_US);
+    }
+    telemetrySend(type, payload, length);
+}
@@ -0,0 +1,40 @@
+/*
+ * telemetry.h
+ *
+ *  Binary frames on the Bluetooth link, interleaved with bluetoothPrintf text.
+ *
+ *  | 0xA5 0x5A | type | length | seq (LE16) | payload[length] | crc (LE16) |
+ *
+ *  crc is CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) over type..payload.
+ *  seq counts every frame handed to telemetrySend(), including the ones
+ *  dropped because the TX mailbox was full, so gaps show up at the receiver.
+ *  The decoder is tools/pid-analyzer/pid_log.py.
+ */
+
+#ifndef BSW_SERVICE_TELEMETRY_H_
+#define BSW_SERVICE_TELEMETRY_H_
+
+#include "Ifx_Types.h"
+
+#define TELEMETRY_SYNC0 0xA5
+#define TELEMETRY_SYNC1 0x5A
+#define TELEMETRY_PAYLOAD_MAX 64
+#define TELEMETRY_OVERHEAD 8            /* sync, type, length, seq and crc around the payload */
+
+#define TELEMETRY_WAIT_US 50           /* telemetrySendWait() polling interval */
+
+/* frame types */
+#define TELEMETRY_TYPE_PD 0x01          /* pd_control.c, pd_sendTrace() */
+#define TELEMETRY_TYPE_RECORD 0x02      /* recorder.c, recorderDump() */
+#define TELEMETRY_TYPE_TRACE 0x03       /* trace.c, traceDump() */
+
+void telemetryInit(void);
+boolean telemetrySend(uint8 type, const uint8 *payload, uint8 length);
+void telemetrySendWait(uint8 type, const uint8 *payload, uint8 length);
+uint16 telemetryCrc(const uint8 *data, uint32 length);
+
+/* little-endian packing helpers for payload builders */
+uint8 *telemetryPut16(uint8 *p, uint16 value);
+uint8 *telemetryPut32(uint8 *p, uint32 value);
+
+#endif /* BSW_SERVICE_TELEMETRY_H_ */
@@ -0,0 +1,66 @@
+#include "trace.h"
+
+#if TRACE_ENABLE
+
+#include "telemetry.h"
+#include "util.h"
+
+#define TRACE_PER_FRAME 7               // 덤프 프레임 하나에 넣는 기록 수 (core 1 + index 2 + 8 * 7 바이트)
+#define TRACE_HEADER_INDEX 0xFFFF       // 코어마다 첫 프레임: 쓴 기록 수, 보내는 기록 수, 덤프 시각
+
+/* 링은 각 코어의 DSPR 에 둔다. 기록은 자기 코어의 로컬 메모리에 한 번 쓰는 것으로 끝난다 */
+TraceRing g_traceCpu0 __attribute__((section(".bss_cpu0")));
+TraceRing g_traceCpu1 __attribute__((section(".bss_cpu1")));
+TraceRing g_traceCpu2 __attribute__((section(".bss_cpu2")));
+volatile boolean g_traceOn = TRUE;
+
+static TraceRing *const TRACE_RINGS[TRACE_CORE_NUM] = { &g_traceCpu0, &g_traceCpu1, &g_traceCpu2 };
+
+static void dumpRing(uint8 core, const TraceRing *ring, uint64 now)
+{
+    uint8 payload[TELEMETRY_PAYLOAD_MAX];
+    uint8 *p = payload;
+    uint32 head = ring->head;
+    uint32 count = (head < TRACE_RING_SIZE) ? head : TRACE_RING_SIZE;
+    uint32 first = head - count;
+
+    *p++ = core;
+    p = telemetryPut16(p, TRACE_HEADER_INDEX);
+    p = telemetryPut32(p, head);
+    p = telemetryPut32(p, count);
+    p = telemetryPut32(p, (uint32)now);
+    p = telemetryPut32(p, (uint32)(now >> 32));
+    telemetrySendWait(TELEMETRY_TYPE_TRACE, payload, (uint8)(p - payload));
+
+    for (uint32 i = 0; i < count; i += TRACE_PER_FRAME)
+    {
+        p = payload;
+        *p++ = core;
+        p = telemetryPut16(p, (uint16)i);
+        for (uint32 j = i; j < count && j < i + TRACE_PER_FRAME; j++)
+        {
+            uint64 record = ring->records[(first + j) & (TRACE_RING_SIZE - 1)];
+            p = telemetryPut32(p, (uint32)record);
+            p = telemetryPut32(p, (uint32)(record >> 32));
+        }
+        telemetrySendWait(TELEMETRY_TYPE_TRACE, payload, (uint8)(p - payload));
+    }
+}
+
+/* 모든 코어의 링을 오래된 기록부터 TELEMETRY_TYPE_TRACE 프레임으로 보낸다. 코어마다 머리 프레임
+ * (core, index 0xFFFF, 쓴 기록 수, 보내는 기록 수, 지금 STM0 시각 64 비트) 다음에
+ * core, index 와 기록 최대 7 개씩.
+ * 보내는 동안은 기록을 멈춘다. 정지한 상태에서 부른다 (CPU0, 다 보낼 때까지 돌아오지 않음) */
+void traceDump(void)
+{
+    g_traceOn = FALSE;
+    uint64 now = getTime10Ns();
+
+    for (uint8 core = 0; core < TRACE_CORE_NUM; core++)
+    {
+        dumpRing(core, TRACE_RINGS[core], now);
+    }
+    g_traceOn = TRUE;
+}
+
+#endif /* TRACE_ENABLE */
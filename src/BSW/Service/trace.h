@@ -0,0 +1,116 @@
+/*
+ * trace.h
+ *
+ *  Binary event trace: each core appends 8-byte records to its own ring in
+ *  its own DSPR, so a trace point costs one STM0 read and one 64-bit store
+ *  instead of the milliseconds a myPrintf() stalls on ASCLIN0.
+ *
+ *  Record (little-endian, one 64-bit word):
+ *
+ *    | time (LE32) | type | id | arg (LE16) |
+ *
+ *    time  STM0 TIM0, 10 ns; all cores share STM0, so the rings line up.
+ *          It wraps after 42.9 s; the dump carries the full STM0 time, and
+ *          records younger than that unwrap against it.
+ *    TRACE_ENTER/TRACE_EXIT  id = TraceScope, arg on exit = scope specific
+ *    TRACE_ISR               id = TraceIsr, arg = ISR specific
+ *    TRACE_STATE             id = new AutoparkState, arg = previous state
+ *    TRACE_SAMPLE            id = UltraDir, arg = echo width [us], 0xFFFF none
+ *
+ *  The rings keep the newest TRACE_RING_SIZE records. Command 'e' (while
+ *  idle) pauses tracing, sends every ring as TELEMETRY_TYPE_TRACE frames and
+ *  resumes; tools/pid-analyzer/pid_log.py --trace turns the capture into
+ *  Chrome/Perfetto trace JSON, one track per core. Release builds (NDEBUG)
+ *  compile the trace points out; -DTRACE_ENABLE=0 does the same in a debug
+ *  build.
+ */
+
+#ifndef BSW_SERVICE_TRACE_H_
+#define BSW_SERVICE_TRACE_H_
+
+#include "Ifx_Types.h"
+#include "IfxCpu.h"
+#include "IfxStm.h"
+
+#ifndef TRACE_ENABLE
+#ifdef NDEBUG
+#define TRACE_ENABLE 0
+#else
+#define TRACE_ENABLE 1
+#endif
+#endif
+
+#define TRACE_RING_SIZE 2048            /* records per core, a power of two (16 KB) */
+#define TRACE_SAMPLE_NONE 0xFFFF
+#define TRACE_CORE_NUM 3
+
+typedef enum
+{
+    TRACE_ENTER = 1,
+    TRACE_EXIT,
+    TRACE_ISR,
+    TRACE_STATE,
+    TRACE_SAMPLE
+} TraceType;
+
+typedef enum
+{
+    TRACE_SCOPE_STEP,                   /* CPU0 autoparkStep() */
+    TRACE_SCOPE_BT_PUMP                 /* CPU2 bluetoothPump() until the TX mailbox is empty, exit arg = bytes */
+} TraceScope;
+
+typedef enum
+{
+    TRACE_ISR_STM0_TICK,                /* CPU0 control tick, arg = tick count (low 16 bits) */
+    TRACE_ISR_ULT_SLOT,                 /* CPU1 ultrasonic slot timer */
+    TRACE_ISR_ULT_ECHO,                 /* CPU1 GTM TIM echo capture, arg = sensor */
+    TRACE_ISR_BT_RX                     /* CPU2 ASCLIN1 receive, arg = byte */
+} TraceIsr;
+
+/* one per core, in that core's DSPR */
+typedef struct
+{
+    uint64 records[TRACE_RING_SIZE];
+    uint32 head;                        /* records written so far, the ring index is head % TRACE_RING_SIZE */
+} TraceRing;
+
+#if TRACE_ENABLE
+
+extern TraceRing g_traceCpu0;
+extern TraceRing g_traceCpu1;
+extern TraceRing g_traceCpu2;
+extern volatile boolean g_traceOn;
+
+/* Appends one record to the calling core's ring. The timestamp is read and the slot taken and
+ * filled with interrupts off, so an ISR tracing in between can neither get the same slot nor
+ * land in the ring ahead of an older timestamp */
+static inline void traceEvent(TraceRing *ring, TraceType type, uint8 id, uint16 arg)
+{
+    if (g_traceOn == FALSE)
+    {
+        return;
+    }
+
+    uint64 tag = ((uint64)type << 32) | ((uint64)id << 40) | ((uint64)arg << 48);
+
+    boolean interruptState = IfxCpu_disableInterrupts();
+    ring->records[ring->head++ & (TRACE_RING_SIZE - 1)] = (uint64)MODULE_STM0.TIM0.U | tag;
+    IfxCpu_restoreInterrupts(interruptState);
+}
+
+/* each trace point names the core it runs on */
+#define TRACE_CPU0(type, id, arg) traceEvent(&g_traceCpu0, (type), (uint8)(id), (uint16)(arg))
+#define TRACE_CPU1(type, id, arg) traceEvent(&g_traceCpu1, (type), (uint8)(id), (uint16)(arg))
+#define TRACE_CPU2(type, id, arg) traceEvent(&g_traceCpu2, (type), (uint8)(id), (uint16)(arg))
+
+void traceDump(void);
+
+#else
+
+#define TRACE_CPU0(type, id, arg) ((void)0)
+#define TRACE_CPU1(type, id, arg) ((void)0)
+#define TRACE_CPU2(type, id, arg) ((void)0)
+
+#endif /* TRACE_ENABLE */
+
+#endif /* BSW_SERVICE_TRACE_H_ */
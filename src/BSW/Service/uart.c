@@ -1,85 +1,163 @@
 #include "uart.h"
+#include "lineedit.h"
+#include "mailbox.h"
+
+#define UART_ECHO_SIZE 32       // myPollLine() 한 번에 모아 보내는 echo
+#define UART_TX_MAILBOX_SIZE 512
+#define UART_SINK_CHUNK 64      // uartPump() 가 한 번에 옮기는 바이트
+
+static void remove_null(char *s);
+
+/* ASCLIN0 TX 는 CPU2 가 맡는다. CPU0 의 텍스트는 이 mailbox 로, LOG_PRINTF() 는 log.c 의 mailbox 로 넘어온다 */
+MAILBOX_DEFINE(g_uartTxMailbox, char, UART_TX_MAILBOX_SIZE);
+
+static volatile uint32 g_uartTxDropCount = 0;
+static LineEditor g_uartLine;   // myPollLine() 이 조립 중인 줄
+static char g_uartSinkLast = 0; // 마지막으로 보낸 문자 (CPU2). 이미 \r\n 인 줄 끝을 알아본다
 
 void uartInit(void)
 {
     asclin0InitUart();
 }
 
+/* 통째로 mailbox 에 넣고 바로 돌아온다. 자리가 없으면 메시지를 버리고 센다 (CPU0) */
+static void uartWrite(const char *str, uint32 length)
+{
+    if (mailboxPushN(&g_uartTxMailbox, str, length) == FALSE)
+    {
+        g_uartTxDropCount++;
+    }
+}
+
+/* mailbox 가 가득 차서 버려진 myPrintf/myPuts 메시지 수 */
+uint32 uartGetTxDropCount(void)
+{
+    return g_uartTxDropCount;
+}
+
+/* uartSinkWrite() 로 지금 한 번에 보낼 수 있는 텍스트 바이트 수 (\n 이 모두 \r\n 이 되어도 들어간다) */
+uint32 uartGetSinkSpace(void)
+{
+    return asclin0GetTxSpace() / 2;
+}
+
+/* CPU2: 텍스트를 ASCLIN0 TX 링에 넣는다. \n 앞에 \r 을 붙이는 곳은 여기 하나뿐이다.
+   입력 echo 처럼 이미 \r\n 인 줄 끝은 그대로 둔다. 자리가 없으면 보내지 않고 FALSE */
+boolean uartSinkWrite(const char *text, uint32 length)
+{
+    unsigned char wire[2 * UART_SINK_MAX];
+    uint32 n = 0;
+    char last = g_uartSinkLast;
+
+    if (length > UART_SINK_MAX)
+    {
+        length = UART_SINK_MAX;
+    }
+    for (uint32 i = 0; i < length; i++)
+    {
+        if (text[i] == '\n' && last != '\r')
+        {
+            wire[n++] = '\r';
+        }
+        wire[n++] = (unsigned char)text[i];
+        last = text[i];
+    }
+    if (n == 0 || asclin0Write(wire, n) == 0)
+    {
+        return FALSE;
+    }
+    g_uartSinkLast = last;
+    return TRUE;
+}
+
+/* CPU2 루프에서 호출. ASCLIN0 TX 링이 받는 만큼만 mailbox 에서 옮기고 바로 돌아온다 */
+void uartPump(void)
+{
+    char chunk[UART_SINK_CHUNK];
+
+    while (uartGetSinkSpace() >= UART_SINK_CHUNK)
+    {
+        uint32 n = 0;
+
+        while (n < UART_SINK_CHUNK && mailboxPop(&g_uartTxMailbox, &chunk[n]))
+        {
+            n++;
+        }
+        if (n == 0)
+        {
+            break;
+        }
+        uartSinkWrite(chunk, n);
+    }
+}
+
 void myPuts(const char *str)
 {
     char buffer[BUFSIZE];
-    char *ptr;
+    int len;
 
-    sprintf(buffer, "%s\r\n", str);
+    len = snprintf(buffer, sizeof(buffer), "%s\n", str);
+    if (len >= (int)sizeof(buffer)) len = sizeof(buffer) - 1;
 
-    for (ptr = buffer; *ptr; ++ptr)
-        asclin0OutUart((const unsigned char)*ptr);
+    uartWrite(buffer, (uint32)len);
 }
 
 
 
+/* 포맷만 여기서 한다. 줄 끝의 \r 은 CPU2 의 uartSinkWrite() 가 붙인다 */
 void myPrintf(const char *fmt, ...)
 {
-    char buffer[128];
-    char buffer2[128]; // add \r before \n
-    sint16 len = 0;
+    char buffer[BUFSIZE];
     va_list ap;
+    int len;
 
     va_start(ap, fmt);
-    vsprintf(buffer, fmt, ap);
+    len = vsnprintf(buffer, sizeof(buffer), fmt, ap);
     va_end(ap);
-    int j = 0;
-    for (int i = 0; buffer[i]; i++) {
-        if (buffer[i] == '\n') {
-            buffer2[j++] = '\r';
-            buffer2[j++] = buffer[i];
-        } else {
-            buffer2[j++] = buffer[i];
-        }
-        len += 1;
-    }
-    buffer2[j] = '\0';
-    len += 1;
+    if (len < 0) return;
+    if (len >= (int)sizeof(buffer)) len = sizeof(buffer) - 1;
 
-    for (int i = 0; buffer2[i] != '\0'; i++)
-        asclin0OutUart((const unsigned char)buffer2[i]);
+    uartWrite(buffer, (uint32)len);
 }
 
 
 
+/* RX 링에 받아 둔 바이트만 줄 편집기에 넣고 바로 돌아온다.
+   CR 로 줄이 끝나면 line 에 복사하고 TRUE. echo 는 모아서 한 번에 보낸다 */
+boolean myPollLine(char *line, uint32 size)
+{
+    char echo[UART_ECHO_SIZE];
+    uint32 n = 0;
+    boolean done = FALSE;
+    unsigned char c;
+
+    while (done == FALSE && n + LINE_EDIT_ECHO_MAX <= UART_ECHO_SIZE && asclin0PollUart(&c) != 0)
+    {
+        LineEditEvent event = lineEditFeed(&g_uartLine, (char)c);
+
+        n += lineEditEcho(event, (char)c, &echo[n]);
+        done = (event == LINE_EDIT_DONE);
+    }
+    if (n > 0)
+    {
+        uartWrite(echo, n);
+    }
+    if (done)
+    {
+        lineEditTake(&g_uartLine, line, size);
+    }
+    return done;
+}
+
 void myScanf(const char *fmt, ...)
 {
     uint8 c = 0;
     char buf[128];
-    int idx = 0, i;
+    int i;
     char *pstr, *pidx;
 
     memset(buf, 0, 128);
-    while (c != '\r')
-    {
-        c = asclin0InUart();
-        if (c == KB_BS || c == 0x8)
-        {
-            if (idx > 0) {
-                buf[idx - 1] = 0;
-                idx--;
-                myPrintf("%c %c", 8,8);
-            }
-            continue;
-        }
-        else
-        {
-            if (c == KB_CR) {
-                idx += 1;
-                buf[idx] = '\0';
-            } else {
-                buf[idx] = c;
-                idx += 1;
-            }
-        }
-        myPrintf("%c", c);
-    }
-    myPrintf("\n");
+    while (myPollLine(buf, sizeof(buf)) == FALSE);
 
     va_list ap;
     va_start(ap, fmt);
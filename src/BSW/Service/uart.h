@@ -10,13 +10,18 @@
 #include "Ifx_Types.h"
 
 #define BUFSIZE     128
+#define UART_SINK_MAX 128   /* text bytes per uartSinkWrite() */
 #define KB_BS '\x7F'
 #define KB_CR '\r'
 
 void uartInit(void);
+uint32 uartGetTxDropCount(void);
+uint32 uartGetSinkSpace(void);
+boolean uartSinkWrite(const char *text, uint32 length);
+void uartPump(void);
 void myPuts(const char *str);
 void myPrintf(const char *fmt, ...);
+boolean myPollLine(char *line, uint32 size);
 void myScanf(const char *fmt, ...);
-static void remove_null(char *s);
 
 #endif /* BSW_ETC_MY_STDIO_H_ */
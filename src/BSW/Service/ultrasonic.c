@@ -1,17 +1,95 @@
+
 #include "ultrasonic.h"
 
+#include "IfxCpu.h"
+#include "mailbox.h"
+#include "recorder.h"
+#include "stm0.h"
+#include "trace.h"
+
+#define ULT_ECHO_TIMEOUT 4000000    // 40ms, HC-SR04 echo 는 타겟이 없어도 38ms 안에 끝남
+#define ULT_MAX_ECHO 3000000        // 30ms 이상은 타겟 없음 (38ms 펄스)
+
+/* 측정 (트리거, 캡처, 타임아웃) 은 CPU1 에서, 소비는 CPU0 에서 한다 */
+typedef struct
+{
+    volatile boolean busy;          // 트리거 후 echo 대기 중
+    uint64 triggerTime;
+} UltChannel;
+
 const UltPin ULT_PINS[ULT_SENSORS_NUM] = {
-        [ULT_LEFT] = {.trigger = {&MODULE_P15, 2}, .echo = {&MODULE_P15, 3}},
-        [ULT_RIGHT] = {.trigger = {&MODULE_P10, 5}, .echo = {&MODULE_P02, 4}},
-        [ULT_REAR] = {.trigger = {&MODULE_P02, 5}, .echo = {&MODULE_P02, 3}}
+        [ULT_LEFT] = {.trigger = {&MODULE_P15, 2}, .echo = {&MODULE_P15, 3}, .echoCapture = &IfxGtm_TIM2_6_P15_3_IN},
+        [ULT_RIGHT] = {.trigger = {&MODULE_P10, 5}, .echo = {&MODULE_P02, 4}, .echoCapture = &IfxGtm_TIM0_4_P02_4_IN},
+        [ULT_REAR] = {.trigger = {&MODULE_P02, 5}, .echo = {&MODULE_P02, 3}, .echoCapture = &IfxGtm_TIM0_3_P02_3_IN}
 };
 
-void ultrasonicInit(void)
+// CPU1 -> CPU0 측정값 mailbox
+MAILBOX_DEFINE(g_ultLeftMailbox, UltSample, ULT_BUFFER_SIZE);
+MAILBOX_DEFINE(g_ultRightMailbox, UltSample, ULT_BUFFER_SIZE);
+MAILBOX_DEFINE(g_ultRearMailbox, UltSample, ULT_BUFFER_SIZE);
+
+static Mailbox *const ULT_MAILBOX[ULT_SENSORS_NUM] = {
+        [ULT_LEFT] = &g_ultLeftMailbox,
+        [ULT_RIGHT] = &g_ultRightMailbox,
+        [ULT_REAR] = &g_ultRearMailbox
+};
+
+static UltChannel g_ultChannel[ULT_SENSORS_NUM];    // CPU1
+static UltSample g_ultLatest[ULT_SENSORS_NUM];      // CPU0, 마지막으로 꺼낸 값
+static boolean g_ultHasLatest[ULT_SENSORS_NUM];     // CPU0
+
+// 트리거 스케줄: 슬롯마다 pattern 의 다음 센서를 발사, 한 번에 하나만 측정 중
+static const UltraDir ULT_DEFAULT_PATTERN[] = {ULT_LEFT, ULT_RIGHT, ULT_LEFT, ULT_REAR};
+
+static UltraDir g_ultPattern[ULT_PATTERN_MAX];
+static uint32 g_ultPatternLength = 0;
+static uint32 g_ultPatternIndex = 0;
+static volatile sint32 g_ultActive = -1;
+static uint64 g_ultLastTrigger = 0;                 // CPU1, 마지막 트리거 시각
+static volatile uint32 g_ultStrayCount[ULT_SENSORS_NUM]; // CPU1, 듣고 있지 않을 때 들어온 echo
+
+/* CPU1 에서만 호출. 캡처와 슬롯 인터럽트가 같은 mailbox 에 넣으므로 인터럽트를 막고 넣는다.
+ * CPU0 이 못 따라와 가득 차면 새 값을 버린다 (mailbox 의 dropped 로 셈) */
+static void pushSample(UltraDir dir, int distance)
 {
-    for (int i = 0; i < ULT_SENSORS_NUM; i++)
+    UltSample sample;
+
+    sample.distance = distance;
+    sample.time = getTime10Ns();
+    TRACE_CPU1(TRACE_SAMPLE, dir, distance < 0 ? TRACE_SAMPLE_NONE : distance / 100);
+
+    boolean interruptState = IfxCpu_disableInterrupts();
+    if (g_ultChannel[dir].busy)
     {
-        IfxPort_setPinMode(ULT_PINS[i].trigger.port, ULT_PINS[i].trigger.pinIndex, IfxPort_Mode_outputPushPullGeneral);
-        IfxPort_setPinMode(ULT_PINS[i].echo.port, ULT_PINS[i].echo.pinIndex, IfxPort_Mode_inputPullUp);
+        mailboxPush(ULT_MAILBOX[dir], &sample);
+        g_ultChannel[dir].busy = FALSE;
+    }
+    IfxCpu_restoreInterrupts(interruptState);
+}
+
+/* echo 펄스가 끝나면 CPU1 의 GTM TIM 캡처 인터럽트에서 호출됨 */
+static void onEcho(uint32 slot, uint32 pulse10Ns)
+{
+    UltraDir dir = (UltraDir)slot;
+
+    TRACE_CPU1(TRACE_ISR, TRACE_ISR_ULT_ECHO, slot);
+    // 듣고 있지 않을 때 (타임아웃 뒤, 트리거 간격 안) 들어온 echo 는 세고 버린다
+    if (g_ultChannel[dir].busy == FALSE)
+    {
+        g_ultStrayCount[dir]++;
+        return;
+    }
+    pushSample(dir, pulse10Ns >= ULT_MAX_ECHO ? -1 : (int)pulse10Ns);
+}
+
+/* echo 가 오지 않으면 -1 을 넣고 다음 트리거를 허용 (CPU1) */
+static void checkTimeout(UltraDir dir)
+{
+    UltChannel *channel = &g_ultChannel[dir];
+
+    if (channel->busy && getTime10Ns() - channel->triggerTime > ULT_ECHO_TIMEOUT)
+    {
+        pushSample(dir, -1);
     }
 }
 
@@ -23,25 +101,139 @@ static void sendTrigger(UltraDir dir)
 
 }
 
-int getDistanceByUltra(UltraDir dir)
+/* CPU1 슬롯 타이머 인터럽트. 앞 센서의 echo 가 끝났고 (또는 타임아웃으로 -1 을 넣었고) 앞 트리거에서
+ * ULT_TRIGGER_GAP_US 가 지났을 때만 다음 센서를 발사. echo 가 끝났다는 것은 첫 반사가 왔다는 것뿐이고,
+ * 그 버스트가 더 먼 물체에서 돌아오는 반사는 그 뒤에도 들어온다. 간격을 사거리만큼 두어 그 반사가 다음 센서의
+ * echo 로 잡히지 않게 한다 (crosstalk) */
+static void onSlot(void)
 {
-    uint64 start, timeOut;
+    TRACE_CPU1(TRACE_ISR, TRACE_ISR_ULT_SLOT, 0);
+    if (g_ultActive >= 0)
+    {
+        checkTimeout((UltraDir)g_ultActive);
+        if (g_ultChannel[g_ultActive].busy)
+        {
+            return;
+        }
+    }
+    if (g_ultPatternLength == 0)
+    {
+        return;
+    }
+
+    uint64 now = getTime10Ns();
+    if (now - g_ultLastTrigger < (uint64)ULT_TRIGGER_GAP_US * 100)
+    {
+        return;
+    }
+
+    UltraDir dir = g_ultPattern[g_ultPatternIndex];
+    g_ultPatternIndex = (g_ultPatternIndex + 1) % g_ultPatternLength;
+
+    g_ultActive = dir;
+    g_ultLastTrigger = now;
+    g_ultChannel[dir].triggerTime = now;
+    g_ultChannel[dir].busy = TRUE;
     sendTrigger(dir);
+}
 
-    timeOut = getTime10Ns();
-    timeOut += 10000000; // 100ms
+/* CPU1 에서 호출. 캡처와 슬롯 인터럽트도 CPU1 로 간다 */
+void ultrasonicInit(void)
+{
+    for (int i = 0; i < ULT_SENSORS_NUM; i++)
+    {
+        IfxPort_setPinMode(ULT_PINS[i].trigger.port, ULT_PINS[i].trigger.pinIndex, IfxPort_Mode_outputPushPullGeneral);
+        gtmTimInInit((uint32)i, ULT_PINS[i].echoCapture, onEcho);
+    }
+    ultrasonicSetSchedule(ULT_DEFAULT_PATTERN, sizeof(ULT_DEFAULT_PATTERN) / sizeof(ULT_DEFAULT_PATTERN[0]), ULT_SLOT_US);
+}
+
+/* pattern 순서대로 slotUs 마다 하나씩 발사. 앞 센서가 아직 듣고 있거나 ULT_TRIGGER_GAP_US 가 안 지난 슬롯은
+ * 건너뛰므로, slotUs 는 트리거 시점의 분해능일 뿐 간격을 그보다 좁히지는 못한다. 슬롯 인터럽트와 같은 코어 (CPU1) 에서 호출 */
+void ultrasonicSetSchedule(const UltraDir *pattern, uint32 length, uint32 slotUs)
+{
+    if (length > ULT_PATTERN_MAX)
+    {
+        length = ULT_PATTERN_MAX;
+    }
+
+    boolean interruptState = IfxCpu_disableInterrupts();
+    for (uint32 i = 0; i < length; i++)
+    {
+        g_ultPattern[i] = pattern[i];
+    }
+    g_ultPatternLength = length;
+    g_ultPatternIndex = 0;
+    IfxCpu_restoreInterrupts(interruptState);
+
+    stm0InitTimer(slotUs, onSlot);
+}
+
+/* CPU1 의 백그라운드 루프에서 호출. 슬롯 사이에도 타임아웃을 바로 처리 */
+void ultrasonicPoll(void)
+{
+    for (int i = 0; i < ULT_SENSORS_NUM; i++)
+    {
+        checkTimeout((UltraDir)i);
+    }
+}
+
+/* CPU0 이 따라오지 못해 버려진 측정값 수 */
+uint32 ultrasonicGetDropCount(UltraDir dir)
+{
+    return mailboxGetDropped(ULT_MAILBOX[dir]);
+}
 
-    while(!IfxPort_getPinState(ULT_PINS[dir].echo.port, ULT_PINS[dir].echo.pinIndex)){
-        if(getTime10Ns() > timeOut) return -1;
+/* 듣고 있지 않을 때 들어와 버린 echo 수 (늦은 echo, 다른 센서의 반사) */
+uint32 ultrasonicGetStrayCount(UltraDir dir)
+{
+    return g_ultStrayCount[dir];
+}
+
+/* 가장 오래된 측정값을 꺼낸다. 비어 있으면 FALSE (CPU0) */
+boolean ultrasonicPop(UltraDir dir, UltSample *sample)
+{
+    if (mailboxPop(ULT_MAILBOX[dir], sample) == FALSE)
+    {
+        return FALSE;
     }
-    start = getTime10Ns();
-    timeOut = start + 10000000;
 
-    while(IfxPort_getPinState(ULT_PINS[dir].echo.port, ULT_PINS[dir].echo.pinIndex)){
-        if(getTime10Ns() > timeOut) return -1;
+    g_ultLatest[dir] = *sample;
+    g_ultHasLatest[dir] = TRUE;
+    recorderAdd(RECORD_ULTRA, (uint8)dir, sample->time, sample->distance, 0);
+    return TRUE;
+}
+
+/* 가장 최근 측정값. 쌓인 값은 모두 꺼내 버린다. 아직 측정값이 없으면 FALSE (CPU0) */
+boolean ultrasonicGetLatest(UltraDir dir, UltSample *sample)
+{
+    UltSample drained;
+
+    while (ultrasonicPop(dir, &drained))
+    {
+    }
+
+    if (g_ultHasLatest[dir] == FALSE)
+    {
+        return FALSE;
+    }
+    *sample = g_ultLatest[dir];
+    return TRUE;
+}
+
+/* 블로킹 측정 (튜닝 메뉴용). CPU1 이 다음 측정값을 넣을 때까지 기다린다 */
+int getDistanceByUltra(UltraDir dir)
+{
+    UltSample sample;
+    uint64 timeOut;
+
+    ultrasonicGetLatest(dir, &sample);     // 이전 값은 버림
+    timeOut = getTime10Ns() + (uint64)ULT_ECHO_TIMEOUT * ULT_PATTERN_MAX;
+
+    while (ultrasonicPop(dir, &sample) == FALSE)
+    {
+        if (getTime10Ns() > timeOut) return -1;    // 스케줄에 없는 센서
     }
 
-    int res = (int) (getTime10Ns() - start);
-    if(res < 0) return -1;
-    return res;
+    return sample.distance;
 }
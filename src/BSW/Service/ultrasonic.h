@@ -10,13 +10,22 @@
 
 #include "IfxPort.h"
 
+#include "gtm_tim_in.h"
 #include "port.h"
 #include "util.h"
 
+#define ULT_BUFFER_SIZE 8               /* samples kept per sensor, power of two */
+#define ULT_PATTERN_MAX 8               /* trigger schedule length */
+#define ULT_SLOT_US 5000                /* default slot period, a trigger may go out on a slot */
+#define ULT_TRIGGER_GAP_US 25000        /* minimum time between two triggers: the previous burst's returns
+                                           from up to about 4 m are over before the next sensor listens */
+#define ULT_MM_PER_TICK 0.001715f       /* echo width (10 ns) to range, 343 m/s over the round trip */
+
 typedef struct
 {
     GpioPin trigger;
     GpioPin echo;
+    IfxGtm_Tim_TinMap *echoCapture;     /* GTM TIM channel on the echo pin */
 } UltPin;
 
 
@@ -25,9 +34,21 @@ typedef enum ultradir
     ULT_LEFT, ULT_RIGHT, ULT_REAR, ULT_SENSORS_NUM
 } UltraDir;
 
+typedef struct
+{
+    int distance;                       /* echo width in 10 ns ticks, -1 if no echo */
+    uint64 time;                        /* getTime10Ns() at the end of the echo */
+} UltSample;
+
 
 
 void ultrasonicInit(void);
+void ultrasonicSetSchedule(const UltraDir *pattern, uint32 length, uint32 slotUs);
+void ultrasonicPoll(void);
+uint32 ultrasonicGetDropCount(UltraDir dir);
+uint32 ultrasonicGetStrayCount(UltraDir dir);
+boolean ultrasonicPop(UltraDir dir, UltSample *sample);
+boolean ultrasonicGetLatest(UltraDir dir, UltSample *sample);
 int getDistanceByUltra(UltraDir dir);
 
 #endif /* BSW_IO_ULTRASONIC_H_ */
@@ -28,6 +28,8 @@
 #include "IfxCpu.h"
 #include "IfxScuWdt.h"
 
+#include "main2.h"
+
 extern IfxCpu_syncEvent g_cpuSyncEvent;
 
 void core2_main(void)
@@ -43,7 +45,5 @@ void core2_main(void)
     IfxCpu_emitEvent(&g_cpuSyncEvent);
     IfxCpu_waitEvent(&g_cpuSyncEvent, 1);
 
-    while(1)
-    {
-    }
+    main2();
 }
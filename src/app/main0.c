@@ -1,35 +1,192 @@
 #include "main0.h"
 #include "bluetooth.h"
 #include "autopark.h"
+#include "profile.h"
+#include "recorder.h"
+#include "stm0.h"
 #include "systeminit.h"
+#include "trace.h"
 #include "uart.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+static boolean g_calMode = FALSE;   // 'k' 이후 한 줄씩 보정값을 받는 중
+
+/* 숫자 하나로만 된 문자열이면 TRUE. atof() 는 잘못된 값에 0 을 내므로 오타 하나가 주행 중인 값을 0 으로 만든다 */
+static boolean parseValue(const char *text, float32 *value)
+{
+    char *end;
+
+    *value = strtof(text, &end);
+    return end != text && *end == '\0';
+}
+
+/* 보정 명령 한 줄: "이름 값" 은 바로 덮어쓰고, "?" 는 전체 목록, "s" 는 정지. 숫자가 아니거나 범위 밖이면 그대로 둔다 */
+static void handleCalLine(char *line)
+{
+    char *name = strtok(line, " ");
+    char *value = strtok(NULL, " ");
+    const char *known;
+    float32 v, min, max;
+
+    if (name == NULL)
+    {
+        g_calMode = FALSE;
+        bluetoothPrintf("Waiting for command...\n");
+        return;
+    }
+    if (strcmp(name, "s") == 0)
+    {
+        autoparkAbort();
+    }
+    else if (strcmp(name, "?") == 0)
+    {
+        for (uint32 i = 0; (known = autoparkGetParamName(i)) != NULL; i++)
+        {
+            autoparkGetParam(known, &v);
+            bluetoothPrintf("  %s = %.3f\n", known, v);
+        }
+    }
+    else if (value == NULL)
+    {
+        bluetoothPrintf("usage: NAME VALUE, ? lists, empty line exits\n");
+    }
+    else if (parseValue(value, &v) == FALSE)
+    {
+        bluetoothPrintf("'%s' is not a number, not changed\n", value);
+    }
+    else if (autoparkSetParam(name, v) == FALSE)
+    {
+        if (autoparkGetParamRange(name, &min, &max))
+        {
+            bluetoothPrintf("%s must be %.3f..%.3f, not changed\n", name, min, max);
+        }
+        else
+        {
+            bluetoothPrintf("unknown parameter '%s'\n", name);
+        }
+    }
+    else
+    {
+        autoparkGetParam(name, &v);
+        bluetoothPrintf("%s = %.3f\n", name, v);
+    }
+    bluetoothPrintf("cal> ");
+}
+
+static void handleCommand(char command)
+{
+    bluetoothPrintf("Command: %c\n", command);
+    switch(command)
+    {
+        case 'p':
+        {
+            autoparkStart();
+            break;
+        }
+        case 's':
+        {
+            autoparkAbort();
+            break;
+        }
+        case 't':
+        {
+            if (autoparkIsBusy() == FALSE)
+            {
+                autoparkTune();
+                bluetoothPrintf("Waiting for command...\n");
+            }
+            break;
+        }
+        case 'r':
+        {
+            /* 마지막 주행의 기록을 텔레메트리 프레임으로 보낸다 (pid_log.py --record) */
+            if (autoparkIsBusy() == FALSE)
+            {
+                bluetoothPrintf("Dumping %u recorded entries...\n", (unsigned)recorderGetCount());
+                recorderDump();
+                bluetoothPrintf("Waiting for command...\n");
+            }
+            break;
+        }
+        case 'f':
+        {
+            /* 지난 'f' 이후의 구간별 사이클 통계 (profile.h). 릴리스 빌드에는 없다 */
+            if (autoparkIsBusy() == FALSE)
+            {
+#if PROFILE_ENABLE
+                profileReport();
+#else
+                bluetoothPrintf("Profiling is not built in (NDEBUG)\n");
+#endif
+                bluetoothPrintf("Waiting for command...\n");
+            }
+            break;
+        }
+        case 'e':
+        {
+            /* 세 코어의 이벤트 트레이스 링을 텔레메트리 프레임으로 보낸다 (pid_log.py --trace) */
+            if (autoparkIsBusy() == FALSE)
+            {
+#if TRACE_ENABLE
+                traceDump();
+#else
+                bluetoothPrintf("Tracing is not built in (NDEBUG)\n");
+#endif
+                bluetoothPrintf("Waiting for command...\n");
+            }
+            break;
+        }
+        case 'k':
+        {
+            /* 주행 중에도 된다. 값은 오버레이 RAM 에 바로 써지고 다음 주기부터 쓰인다 */
+            g_calMode = TRUE;
+            bluetoothPrintf("cal> ");
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+}
+
 void main0(void)
 {
     systemInit();
+    autoparkInit();
     myPrintf("System Initialized.\n");
     bluetoothPrintf("System Initialized.\n");
+    bluetoothPrintf("Waiting for command...\n");
+
+    uint32 lastTick = stm0GetTickCount();
     while (1)
     {
-        bluetoothPrintf("Waiting for command...\n");
-        char command = bluetoothRecvByteBlocked();
-        bluetoothPrintf("Command: %c\n", command);
-        switch(command)
+        /* 명령은 매 루프 확인하므로 's' 는 다음 주기 전에 반영된다 */
+        if (g_calMode)
         {
-            case 'p':
+            char line[32];
+            if (bluetoothPollLine(line, sizeof(line)))
             {
-                autoparkExecute();
-                break;
+                handleCalLine(line);
             }
-            case 't':
-            {
-                autoparkTune();
-                break;
-            }
-            default:
+        }
+        else
+        {
+            char command = bluetoothRecvByteNonBlocked();
+            if (command != (char)-1)
             {
-                break;
+                handleCommand(command);
             }
         }
+
+        /* CONTROL_PERIOD_US 마다 한 번 자동 주차 상태 머신 실행 */
+        uint32 tick = stm0GetTickCount();
+        if (tick != lastTick)
+        {
+            lastTick = tick;
+            autoparkStep();
+        }
     }
 }
@@ -0,0 +1,29 @@
+#include "main1.h"
+#include "systeminit.h"
+#include "ultrasonic.h"
+
+/* CPU1: 초음파 측정. 트리거 슬롯과 echo 캡처 인터럽트도 이 코어에서 처리하고
+ * 측정값은 mailbox 로 CPU0 에 넘긴다 */
+
+void main1Init(void)
+{
+    /* GTM 은 CPU0 의 systemInit() (motorInit) 에서 켜진다 */
+    while (systemIsReady() == FALSE)
+    {
+    }
+    ultrasonicInit();
+}
+
+void main1Step(void)
+{
+    ultrasonicPoll();
+}
+
+void main1(void)
+{
+    main1Init();
+    while (1)
+    {
+        main1Step();
+    }
+}
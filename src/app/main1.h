@@ -0,0 +1,8 @@
+#ifndef ASW_APP_MAIN1_H_
+#define ASW_APP_MAIN1_H_
+
+void main1(void);
+void main1Init(void);
+void main1Step(void);
+
+#endif /* ASW_APP_MAIN1_H_ */
@@ -0,0 +1,29 @@
+#include "main2.h"
+#include "bluetooth.h"
+#include "log.h"
+#include "uart.h"
+
+/* CPU2: 블루투스 UART 와 디버그 UART (ASCLIN0) 의 송신. 명령은 RX 인터럽트에서 mailbox 로 CPU0 에 넘기고,
+ * CPU0 이 mailbox 에 쌓은 텔레메트리, myPrintf() 텍스트와 LOG_PRINTF() 기록은 이 루프에서 내보낸다.
+ * 로그의 포맷과 줄 끝 변환은 여기서 하므로 CPU0 은 기록만 넣고 돌아간다 */
+
+void main2Init(void)
+{
+    bluetoothInit();
+}
+
+void main2Step(void)
+{
+    bluetoothPump();
+    uartPump();
+    logPump();
+}
+
+void main2(void)
+{
+    main2Init();
+    while (1)
+    {
+        main2Step();
+    }
+}
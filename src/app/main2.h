@@ -0,0 +1,8 @@
+#ifndef ASW_APP_MAIN2_H_
+#define ASW_APP_MAIN2_H_
+
+void main2(void);
+void main2Init(void);
+void main2Step(void);
+
+#endif /* ASW_APP_MAIN2_H_ */
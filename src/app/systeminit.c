@@ -1,17 +1,31 @@
 #include "systeminit.h"
 
 #include "asclin0.h"
-#include "asclin1.h"
-#include "bluetooth.h"
 #include "motor.h"
+#include "odometry.h"
+#include "param_store.h"
+#include "profile.h"
+#include "stm0.h"
+#include "telemetry.h"
 #include "uart.h"
-#include "ultrasonic.h"
 
+static volatile boolean g_systemReady = FALSE;
 
+/* CPU0 에서 호출. 블루투스 (CPU2) 와 초음파 (CPU1) 는 각 코어의 mainN() 에서 초기화 */
 void systemInit(){
-    bluetoothInit();
     motorInit();
     asclin0InitUart();
     uartInit();
-    ultrasonicInit();
+    stm0InitTick(CONTROL_PERIOD_US);
+    odometryInit(CONTROL_PERIOD_US);
+    telemetryInit();
+    paramStoreInit();
+    profileInit();
+    g_systemReady = TRUE;
+}
+
+/* GTM 등 공용 모듈이 켜졌는지. 다른 코어가 초기화 전에 기다린다 */
+boolean systemIsReady(void)
+{
+    return g_systemReady;
 }
@@ -1,7 +1,11 @@
 #ifndef ASW_APP_SYSTEMINIT_H_
 #define ASW_APP_SYSTEMINIT_H_
 
+#include "Ifx_Types.h"
+
+#define CONTROL_PERIOD_US 10000 /* 주기 태스크 (autoparkStep) 주기 */
 
 void systemInit(void);
+boolean systemIsReady(void);
 
 #endif /* ASW_APP_SYSTEMINIT_H_ */
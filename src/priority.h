@@ -10,6 +10,9 @@
 #define ISR_PRIORITY_ERU_INT0 14
 
 #define ISR_PRIORITY_ULTRASONIC 13
+#define ISR_PRIORITY_GTM_TIM_IN0 10
+#define ISR_PRIORITY_GTM_TIM_IN1 11
+#define ISR_PRIORITY_GTM_TIM_IN2 12
 #define ISR_PRIORITY_ULTRASONIC_TRIGGER 30
 
 #define ISR_PRIORITY_GPT1T3_TIMER 20
@@ -1,34 +1,287 @@
+import json
+import struct
+import sys
+from pathlib import Path
+
 import pandas as pd
 import matplotlib.pyplot as plt
-log_file_path = 'log.csv' 
-
-column_names = ['Error', 'Derivative', 'MV']
-
-try:
-    df = pd.read_csv(log_file_path, header=None, names=column_names)
-except FileNotFoundError:
-    print(f"Log file '{log_file_path}' not found.")
-    exit()
-time_axis = df.index
-fig, axs = plt.subplots(3, 1, figsize=(15, 12), sharex=True)
-
-fig.suptitle('PID Controller Log Analysis', fontsize=16)
-
-axs[0].plot(time_axis, df['Error'], label='Error', color='blue')
-axs[0].axhline(0, color='r', linestyle='--', linewidth=1) 
-axs[0].set_ylabel('Error')
-axs[0].legend()
-axs[0].grid(True)
-
-axs[1].plot(time_axis, df['Derivative'], label='Derivative', color='orange')
-axs[1].set_ylabel('Derivative')
-axs[1].legend()
-axs[1].grid(True)
-
-axs[2].plot(time_axis, df['MV'], label='MV (Output)', color='purple')
-axs[2].set_ylabel('MV (Output)')
-axs[2].legend()
-axs[2].grid(True)
-
-plt.tight_layout(rect=[0, 0.03, 1, 0.95]) 
-plt.show()
+
+# Binary telemetry (src/BSW/Service/telemetry.h):
+#   | 0xA5 0x5A | type | length | seq (LE16) | payload[length] | crc (LE16) |
+# crc is CRC-16/CCITT-FALSE over type..payload. Text from bluetoothPrintf may
+# sit between frames and is skipped.
+SYNC = b'\xa5\x5a'
+TYPE_PD = 0x01
+PD_FORMAT = '<Ihhhhhhh'      # pd_sendTrace() in src/ASW/autopark/pd_control.c
+PD_FIELDS = ['Time', 'Raw', 'Filtered', 'Error', 'Derivative', 'MV', 'DutyLeft', 'DutyRight']
+
+# recorderDump() in src/BSW/Service/recorder.c: a header frame (index 0xFFFF,
+# entry count, dropped count), then the 16-byte entries with their index.
+# save_record() writes them as the file tools/sil/autopark_replay reads.
+TYPE_RECORD = 0x02
+RECORD_HEADER_INDEX = 0xFFFF
+RECORD_ENTRY_SIZE = 16
+RECORD_MAGIC = b'APRC'
+RECORD_VERSION = 1
+
+# traceDump() in src/BSW/Service/trace.c: per core a header frame (core, index
+# 0xFFFF, records written, records sent, 64-bit STM0 time of the dump), then
+# the 8-byte records of src/BSW/Service/trace.h oldest first, 7 per frame.
+# save_trace() writes them as Chrome/Perfetto trace JSON, one track per core.
+TYPE_TRACE = 0x03
+TRACE_HEADER_INDEX = 0xFFFF
+TRACE_RECORD_FORMAT = '<IBBH'    # STM0 time (10 ns, low 32 bits), type, id, arg
+TRACE_RECORD_SIZE = 8
+TRACE_ENTER, TRACE_EXIT, TRACE_ISR, TRACE_STATE, TRACE_SAMPLE = 1, 2, 3, 4, 5
+TRACE_SAMPLE_NONE = 0xFFFF
+TRACE_FUTURE_MAX = 100000000     # 1 s
+TRACE_SCOPES = ['autoparkStep', 'bluetoothPump']
+TRACE_ISRS = ['STM0 tick', 'ultrasonic slot', 'echo capture', 'ASCLIN1 RX']
+TRACE_STATES = ['IDLE', 'FIND_SPACE', 'FIND_SPACE_STOP', 'MANEUVER', 'AUTOTUNE',   # AutoparkState
+                'SPEED_FORWARD', 'SPEED_FORWARD_STOP', 'SPEED_REVERSE', 'SPEED_REVERSE_STOP']
+TRACE_SENSORS = ['left', 'right', 'rear']                                          # UltraDir
+
+
+def crc16_ccitt(data, crc=0xFFFF):
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def decode_frames(data):
+    """Returns (frames, crc_errors); frames are (type, seq, payload) in stream order."""
+    frames = []
+    crc_errors = 0
+    i = 0
+    while True:
+        i = data.find(SYNC, i)
+        if i < 0 or i + 6 > len(data):
+            break
+        length = data[i + 3]
+        end = i + 6 + length + 2
+        if end > len(data):
+            break
+        body = data[i + 2:end - 2]
+        if crc16_ccitt(body) != struct.unpack_from('<H', data, end - 2)[0]:
+            crc_errors += 1
+            i += 1              # false sync inside text or a corrupted frame
+            continue
+        seq = struct.unpack_from('<H', data, i + 4)[0]
+        frames.append((data[i + 2], seq, data[i + 6:end - 2]))
+        i = end
+    return frames, crc_errors
+
+
+def count_dropped(seqs):
+    dropped = 0
+    for prev, cur in zip(seqs, seqs[1:]):
+        dropped += (cur - prev - 1) & 0xFFFF
+    return dropped
+
+
+def load_binary(path):
+    frames, crc_errors = decode_frames(Path(path).read_bytes())
+    seqs = [seq for _, seq, _ in frames]
+    rows = [struct.unpack(PD_FORMAT, payload) for ftype, _, payload in frames
+            if ftype == TYPE_PD and len(payload) == struct.calcsize(PD_FORMAT)]
+    print(f"{len(frames)} frames, {count_dropped(seqs)} dropped (seq gaps), {crc_errors} CRC errors")
+
+    df = pd.DataFrame(rows, columns=PD_FIELDS)
+    if not df.empty:
+        # time_us wraps after about 71 minutes
+        df['Time'] = (df['Time'].diff().fillna(0) % (1 << 32)).cumsum() / 1e6
+    return df
+
+
+def save_record(path, out_path):
+    frames, crc_errors = decode_frames(Path(path).read_bytes())
+    header = None
+    entries = {}
+    for ftype, _, payload in frames:
+        if ftype != TYPE_RECORD:
+            continue
+        index = struct.unpack_from('<H', payload)[0]
+        if index == RECORD_HEADER_INDEX:
+            header = struct.unpack_from('<II', payload, 2)
+            entries = {}            # a later dump replaces an earlier one
+            continue
+        for k in range((len(payload) - 2) // RECORD_ENTRY_SIZE):
+            start = 2 + k * RECORD_ENTRY_SIZE
+            entries[index + k] = payload[start:start + RECORD_ENTRY_SIZE]
+
+    if header is None:
+        print(f"no recording in '{path}' ({crc_errors} CRC errors)")
+        return False
+    count, dropped = header
+    missing = [i for i in range(count) if i not in entries]
+    if missing:
+        print(f"{len(missing)} of {count} entries lost in transfer (first {missing[0]}), dump again")
+        return False
+
+    body = b''.join(entries[i] for i in range(count))
+    Path(out_path).write_bytes(RECORD_MAGIC + struct.pack('<HHII', RECORD_VERSION, RECORD_ENTRY_SIZE,
+                                                          count, dropped) + body)
+    print(f"{count} entries ({dropped} dropped on the target) written to {out_path}")
+    return True
+
+
+def trace_name(names, index):
+    return names[index] if index < len(names) else str(index)
+
+
+def trace_events(core, now, records):
+    """Chrome trace events of one core's records; ts in us since STM0 start."""
+    events = []
+    open_scopes = set()
+    for time, rtype, rid, arg in records:
+        # records are younger than the 42.9 s wrap, so unwrap against the dump time; another
+        # core may still have written one just after the dump read the time
+        age = (now - time) & 0xFFFFFFFF
+        if age >= (1 << 32) - TRACE_FUTURE_MAX:
+            age -= 1 << 32
+        ts = (now - age) / 100.0
+        base = {'pid': 0, 'tid': core, 'ts': ts}
+        if rtype == TRACE_ENTER:
+            open_scopes.add(rid)
+            events.append(dict(base, ph='B', name=trace_name(TRACE_SCOPES, rid)))
+        elif rtype == TRACE_EXIT:
+            if rid in open_scopes:          # the ring may start inside a scope
+                events.append(dict(base, ph='E', name=trace_name(TRACE_SCOPES, rid), args={'arg': arg}))
+        elif rtype == TRACE_ISR:
+            events.append(dict(base, ph='i', s='t', name=trace_name(TRACE_ISRS, rid), args={'arg': arg}))
+        elif rtype == TRACE_STATE:
+            events.append(dict(base, ph='i', s='p', name=trace_name(TRACE_STATES, rid),
+                               args={'from': trace_name(TRACE_STATES, arg)}))
+            events.append(dict(base, ph='C', name='autopark state', args={'state': rid}))
+        elif rtype == TRACE_SAMPLE:
+            if arg == TRACE_SAMPLE_NONE:
+                events.append(dict(base, ph='i', s='t', name='no echo ' + trace_name(TRACE_SENSORS, rid)))
+            else:
+                events.append(dict(base, ph='C', name='echo ' + trace_name(TRACE_SENSORS, rid), args={'us': arg}))
+    return events
+
+
+def save_trace(path, out_path):
+    frames, crc_errors = decode_frames(Path(path).read_bytes())
+    dumps = {}
+    for ftype, _, payload in frames:
+        if ftype != TYPE_TRACE:
+            continue
+        core, index = struct.unpack_from('<BH', payload)
+        if index == TRACE_HEADER_INDEX:
+            written, count, now_lo, now_hi = struct.unpack_from('<IIII', payload, 3)
+            dumps[core] = (written, count, now_lo | (now_hi << 32), {})    # a later dump replaces an earlier one
+            continue
+        if core not in dumps:
+            continue
+        records = dumps[core][3]
+        for k in range((len(payload) - 3) // TRACE_RECORD_SIZE):
+            records[index + k] = struct.unpack_from(TRACE_RECORD_FORMAT, payload, 3 + k * TRACE_RECORD_SIZE)
+
+    if not dumps:
+        print(f"no trace in '{path}' ({crc_errors} CRC errors)")
+        return False
+
+    events = [{'pid': 0, 'ph': 'M', 'name': 'process_name', 'args': {'name': 'TC375'}}]
+    for core in sorted(dumps):
+        written, count, now, records = dumps[core]
+        missing = [i for i in range(count) if i not in records]
+        if missing:
+            print(f"CPU{core}: {len(missing)} of {count} records lost in transfer (first {missing[0]}), dump again")
+            return False
+        events.append({'pid': 0, 'tid': core, 'ph': 'M', 'name': 'thread_name', 'args': {'name': f'CPU{core}'}})
+        events += trace_events(core, now, [records[i] for i in range(count)])
+        print(f"CPU{core}: {count} records ({written - count} overwritten on the target)")
+
+    Path(out_path).write_text(json.dumps({'traceEvents': events, 'displayTimeUnit': 'ms'}))
+    print(f"{len(events)} events written to {out_path}")
+    return True
+
+
+def load_csv(path):
+    return pd.read_csv(path, header=None, names=['Error', 'Derivative', 'MV'])
+
+
+def plot(df):
+    binary = 'Time' in df.columns
+    time_axis = df['Time'] if binary else df.index
+    rows = 5 if binary else 3
+    fig, axs = plt.subplots(rows, 1, figsize=(15, 4 * rows), sharex=True)
+
+    fig.suptitle('PID Controller Log Analysis', fontsize=16)
+
+    axs[0].plot(time_axis, df['Error'], label='Error', color='blue')
+    axs[0].axhline(0, color='r', linestyle='--', linewidth=1)
+    axs[0].set_ylabel('Error')
+    axs[0].legend()
+    axs[0].grid(True)
+
+    axs[1].plot(time_axis, df['Derivative'], label='Derivative', color='orange')
+    axs[1].set_ylabel('Derivative')
+    axs[1].legend()
+    axs[1].grid(True)
+
+    axs[2].plot(time_axis, df['MV'], label='MV (Output)', color='purple')
+    axs[2].set_ylabel('MV (Output)')
+    axs[2].legend()
+    axs[2].grid(True)
+
+    if binary:
+        axs[3].plot(time_axis, df['Raw'], label='Raw', color='gray')
+        axs[3].plot(time_axis, df['Filtered'], label='Filtered', color='green')
+        axs[3].set_ylabel('Echo [us]')
+        axs[3].legend()
+        axs[3].grid(True)
+
+        axs[4].plot(time_axis, df['DutyLeft'], label='Left', color='teal')
+        axs[4].plot(time_axis, df['DutyRight'], label='Right', color='brown')
+        axs[4].set_ylabel('Duty')
+        axs[4].set_xlabel('Time [s]')
+        axs[4].legend()
+        axs[4].grid(True)
+
+    plt.tight_layout(rect=[0, 0.03, 1, 0.95])
+    plt.show()
+
+
+def main():
+    # raw capture of the Bluetooth link (log.bin) or the old CSV text log;
+    # pid_log.py CAPTURE --record OUT extracts a recorder dump instead of plotting,
+    # pid_log.py CAPTURE --trace OUT.json converts an event trace dump
+    args = sys.argv[1:]
+    extract = None
+    for option, save in (('--record', save_record), ('--trace', save_trace)):
+        if option in args:
+            i = args.index(option)
+            if i + 1 >= len(args):
+                print("usage: pid_log.py [CAPTURE] [--record OUT | --trace OUT.json]")
+                sys.exit(2)
+            extract = (save, args[i + 1])
+            del args[i:i + 2]
+    if args:
+        log_file_path = args[0]
+    else:
+        log_file_path = 'log.bin' if Path('log.bin').exists() else 'log.csv'
+
+    if extract is not None:
+        save, out_path = extract
+        try:
+            sys.exit(0 if save(log_file_path, out_path) else 1)
+        except FileNotFoundError:
+            print(f"Log file '{log_file_path}' not found.")
+            sys.exit(1)
+
+    try:
+        df = load_csv(log_file_path) if log_file_path.endswith('.csv') else load_binary(log_file_path)
+    except FileNotFoundError:
+        print(f"Log file '{log_file_path}' not found.")
+        sys.exit(1)
+
+    plot(df)
+
+
+if __name__ == '__main__':
+    main()
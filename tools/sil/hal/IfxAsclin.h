@@ -0,0 +1,13 @@
+/*
+ * IfxAsclin.h (SIL)
+ *
+ *  Empty stand-in. The MCAL drivers that use this module are replaced by the
+ *  simulator (see sil_hal.c).
+ */
+
+#ifndef SIL_IFXASCLIN_H_
+#define SIL_IFXASCLIN_H_
+
+#include "Ifx_Types.h"
+
+#endif /* SIL_IFXASCLIN_H_ */
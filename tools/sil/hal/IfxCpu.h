@@ -0,0 +1,25 @@
+/*
+ * IfxCpu.h (SIL)
+ *
+ *  Simulated interrupts are dispatched from silAdvance(); while the firmware
+ *  has them disabled, dispatch is held back until a later time step.
+ */
+
+#ifndef SIL_IFXCPU_H_
+#define SIL_IFXCPU_H_
+
+#include "Ifx_Types.h"
+
+typedef enum
+{
+    IfxCpu_ResourceCpu_0,
+    IfxCpu_ResourceCpu_1,
+    IfxCpu_ResourceCpu_2
+} IfxCpu_ResourceCpu;
+
+boolean IfxCpu_disableInterrupts(void);
+void IfxCpu_restoreInterrupts(boolean enabled);
+
+#define __dsync() __sync_synchronize()
+
+#endif /* SIL_IFXCPU_H_ */
@@ -0,0 +1,13 @@
+/*
+ * IfxGpt12.h (SIL)
+ *
+ *  Empty stand-in. The MCAL drivers that use this module are replaced by the
+ *  simulator (see sil_hal.c).
+ */
+
+#ifndef SIL_IFXGPT12_H_
+#define SIL_IFXGPT12_H_
+
+#include "Ifx_Types.h"
+
+#endif /* SIL_IFXGPT12_H_ */
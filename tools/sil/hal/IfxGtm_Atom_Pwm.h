@@ -0,0 +1,13 @@
+/*
+ * IfxGtm_Atom_Pwm.h (SIL)
+ *
+ *  Empty stand-in. The MCAL drivers that use this module are replaced by the
+ *  simulator (see sil_hal.c).
+ */
+
+#ifndef SIL_IFXGTM_ATOM_PWM_H_
+#define SIL_IFXGTM_ATOM_PWM_H_
+
+#include "Ifx_Types.h"
+
+#endif /* SIL_IFXGTM_ATOM_PWM_H_ */
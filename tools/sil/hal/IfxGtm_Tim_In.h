@@ -0,0 +1,29 @@
+/*
+ * IfxGtm_Tim_In.h (SIL)
+ *
+ *  Only the TIM input pin map entries BSW refers to. The capture itself is
+ *  modelled in sil_hal.c, which reports each finished echo pulse to the
+ *  gtm_tim_in stand-in in sil_mcal.c.
+ */
+
+#ifndef SIL_IFXGTM_TIM_IN_H_
+#define SIL_IFXGTM_TIM_IN_H_
+
+#include "IfxPort.h"
+
+typedef struct
+{
+    uint32 tim;
+    uint32 channel;
+    struct
+    {
+        Ifx_P *port;
+        uint8 pinIndex;
+    } pin;
+} IfxGtm_Tim_TinMap;
+
+extern IfxGtm_Tim_TinMap IfxGtm_TIM0_3_P02_3_IN;
+extern IfxGtm_Tim_TinMap IfxGtm_TIM0_4_P02_4_IN;
+extern IfxGtm_Tim_TinMap IfxGtm_TIM2_6_P15_3_IN;
+
+#endif /* SIL_IFXGTM_TIM_IN_H_ */
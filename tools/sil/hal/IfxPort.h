@@ -0,0 +1,111 @@
+/*
+ * IfxPort.h (SIL)
+ *
+ *  Port SFRs are plain structs in host memory. Output bits written directly by
+ *  the BSW (motor brake/direction) are sampled by the vehicle model; pin
+ *  accesses through the API below are routed to the simulator.
+ */
+
+#ifndef SIL_IFXPORT_H_
+#define SIL_IFXPORT_H_
+
+#include "Ifx_Types.h"
+
+typedef union
+{
+    uint32 U;
+    struct
+    {
+        unsigned int : 3;
+        unsigned int PC0 : 5;
+        unsigned int : 3;
+        unsigned int PC1 : 5;
+        unsigned int : 3;
+        unsigned int PC2 : 5;
+        unsigned int : 3;
+        unsigned int PC3 : 5;
+    } B;
+} Ifx_P_IOCR0;
+
+typedef union
+{
+    uint32 U;
+    struct
+    {
+        unsigned int : 3;
+        unsigned int PC4 : 5;
+        unsigned int : 3;
+        unsigned int PC5 : 5;
+        unsigned int : 3;
+        unsigned int PC6 : 5;
+        unsigned int : 3;
+        unsigned int PC7 : 5;
+    } B;
+} Ifx_P_IOCR4;
+
+typedef union
+{
+    uint32 U;
+    struct
+    {
+        unsigned int P0 : 1;
+        unsigned int P1 : 1;
+        unsigned int P2 : 1;
+        unsigned int P3 : 1;
+        unsigned int P4 : 1;
+        unsigned int P5 : 1;
+        unsigned int P6 : 1;
+        unsigned int P7 : 1;
+        unsigned int P8 : 1;
+        unsigned int P9 : 1;
+        unsigned int P10 : 1;
+        unsigned int P11 : 1;
+        unsigned int P12 : 1;
+        unsigned int P13 : 1;
+        unsigned int P14 : 1;
+        unsigned int P15 : 1;
+        unsigned int : 16;
+    } B;
+} Ifx_P_PINS;
+
+typedef struct
+{
+    Ifx_P_PINS  OUT;
+    Ifx_P_IOCR0 IOCR0;
+    Ifx_P_IOCR4 IOCR4;
+    Ifx_P_PINS  IN;
+} Ifx_P;
+
+#define SIL_PORT_NUM 41
+
+extern Ifx_P g_silPort[SIL_PORT_NUM];
+
+#define MODULE_P00 (g_silPort[0])
+#define MODULE_P02 (g_silPort[2])
+#define MODULE_P10 (g_silPort[10])
+#define MODULE_P14 (g_silPort[14])
+#define MODULE_P15 (g_silPort[15])
+#define MODULE_P33 (g_silPort[33])
+
+typedef enum
+{
+    IfxPort_Mode_inputNoPullDevice     = 0x00U,
+    IfxPort_Mode_inputPullDown         = 0x08U,
+    IfxPort_Mode_inputPullUp           = 0x10U,
+    IfxPort_Mode_outputPushPullGeneral = 0x80U,
+    IfxPort_Mode_outputOpenDrainGeneral = 0xC0U
+} IfxPort_Mode;
+
+typedef enum
+{
+    IfxPort_State_notChanged = (0 << 16) | (0 << 0),
+    IfxPort_State_high       = (0 << 16) | (1U << 0),
+    IfxPort_State_low        = (1U << 16) | (0 << 0),
+    IfxPort_State_toggled    = (1U << 16) | (1U << 0)
+} IfxPort_State;
+
+void    IfxPort_setPinMode(Ifx_P *port, uint8 pinIndex, IfxPort_Mode mode);
+void    IfxPort_setPinState(Ifx_P *port, uint8 pinIndex, IfxPort_State action);
+boolean IfxPort_getPinState(Ifx_P *port, uint8 pinIndex);
+
+#endif /* SIL_IFXPORT_H_ */
@@ -0,0 +1,19 @@
+/*
+ * IfxScuCcu.h (SIL)
+ *
+ *  The clock tree of the target: every CPU at 300 MHz.
+ */
+
+#ifndef SIL_IFXSCUCCU_H_
+#define SIL_IFXSCUCCU_H_
+
+#include "Ifx_Types.h"
+#include "IfxCpu.h"
+
+static inline float32 IfxScuCcu_getCpuFrequency(const IfxCpu_ResourceCpu cpu)
+{
+    (void)cpu;
+    return 300000000.0f;
+}
+
+#endif /* SIL_IFXSCUCCU_H_ */
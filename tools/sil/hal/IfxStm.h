@@ -0,0 +1,27 @@
+/*
+ * IfxStm.h (SIL)
+ *
+ *  MODULE_STM0 is an accessor: every TIM0/CAP read advances simulated time by
+ *  one poll quantum, so the firmware's busy-wait loops make progress. CAP holds
+ *  the upper word latched by the preceding TIM0 read, as on silicon.
+ */
+
+#ifndef SIL_IFXSTM_H_
+#define SIL_IFXSTM_H_
+
+#include "Ifx_Types.h"
+
+typedef struct
+{
+    struct { uint32 U; } TIM0;
+    struct { uint32 U; } CAP;
+} Ifx_STM;
+
+Ifx_STM *silStm0Access(void);
+
+#define MODULE_STM0 (*silStm0Access())
+
+/* a macro, so that IfxStm_getFrequency(&MODULE_STM0) does not read the timer and advance time */
+#define IfxStm_getFrequency(stm) (100000000.0f)
+
+#endif /* SIL_IFXSTM_H_ */
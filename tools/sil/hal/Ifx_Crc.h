@@ -0,0 +1,54 @@
+/*
+ * Ifx_Crc.h (SIL)
+ *
+ *  Same types and table layout as the iLLD SysSe/Math CRC; the iLLD source
+ *  casts pointers to uint32, so sil_crc.c carries a host-safe copy of the
+ *  functions the firmware uses.
+ */
+
+#ifndef SIL_IFX_CRC_H_
+#define SIL_IFX_CRC_H_
+
+#include "Ifx_Types.h"
+
+typedef struct
+{
+    sint32 order;
+    uint32 polynom;
+    sint32 refin;
+    uint32 crchighbit;
+    uint32 crcmask;
+} Ifc_Crc_Table;
+
+typedef struct
+{
+    Ifc_Crc_Table data;
+    uint8 crctab[256];
+} Ifc_Crc_Table8;
+
+typedef struct
+{
+    Ifc_Crc_Table data;
+    uint16 crctab[256];
+} Ifc_Crc_Table16;
+
+typedef struct
+{
+    Ifc_Crc_Table data;
+    uint32 crctab[256];
+} Ifc_Crc_Table32;
+
+typedef struct
+{
+    uint32 crcxor;
+    sint32 refout;
+    uint32 crcinit_direct;
+    uint32 crcinit_nondirect;
+    const Ifc_Crc_Table *table;
+} Ifc_Crc;
+
+boolean Ifx_Crc_init(Ifc_Crc *driver, const Ifc_Crc_Table *table, sint32 direct, sint32 refout, uint32 crcinit, uint32 crcxor);
+boolean Ifx_Crc_createTable(Ifc_Crc_Table *table, sint32 order, uint32 polynom, sint32 refin);
+uint32 Ifx_Crc_tableFast(Ifc_Crc *driver, uint8 *p, uint32 len);
+
+#endif /* SIL_IFX_CRC_H_ */
@@ -0,0 +1,40 @@
+/*
+ * Ifx_Types.h (SIL)
+ *
+ *  Host stand-in for the iLLD base types. Only what the ASW/BSW sources use.
+ */
+
+#ifndef SIL_IFX_TYPES_H_
+#define SIL_IFX_TYPES_H_
+
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdint.h>
+
+typedef uint8_t  uint8;
+typedef uint16_t uint16;
+typedef uint32_t uint32;
+typedef uint64_t uint64;
+typedef int8_t   sint8;
+typedef int16_t  sint16;
+typedef int32_t  sint32;
+typedef int64_t  sint64;
+typedef float    float32;
+typedef double   float64;
+typedef uint8    boolean;
+
+#ifndef TRUE
+#define TRUE  1
+#endif
+#ifndef FALSE
+#define FALSE 0
+#endif
+
+#define NULL_PTR ((void *)0)
+
+#define IFX_PI (3.1415926535897932384626433832795f)
+
+#define IFX_ALIGN(n)                              __attribute__((aligned(n)))
+#define IFX_INTERRUPT(isr, vectabNum, priority)   void isr(void)
+
+#endif /* SIL_IFX_TYPES_H_ */
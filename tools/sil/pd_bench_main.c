@@ -0,0 +1,57 @@
+/*
+ * pd_bench_main.c
+ *
+ *  Host side of the float vs. Q16 PD benchmark (ASW/autopark/pd_bench.c).
+ *  pd_control.c is built with NDEBUG here so the debug prints are not timed.
+ *  Compare fixed_checksum with the [b] entry of autoparkTune() on the target:
+ *  the Q16 path uses integer arithmetic only and must match bit for bit.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_CLOCK_UNIT "tsc"
+#else
+#define BENCH_CLOCK_UNIT "ns"
+#endif
+
+#include "pd_bench.h"
+
+static uint64 benchClock(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64)ts.tv_sec * 1000000000u + (uint64)ts.tv_nsec;
+#endif
+}
+
+int main(int argc, char **argv)
+{
+    uint32 steps = (argc > 1) ? (uint32)strtoul(argv[1], NULL, 0) : PD_BENCH_STEPS;
+    PdBenchResult warm;
+    PdBenchResult res;
+
+    if (steps == 0)
+    {
+        fprintf(stderr, "usage: %s [steps]\n", argv[0]);
+        return 2;
+    }
+
+    pdBenchRun(steps, benchClock, &warm);   /* caches and branch predictors */
+    pdBenchRun(steps, benchClock, &res);
+
+    printf("steps %u\n", (unsigned)res.steps);
+    printf("float %.1f %s/step checksum %08x\n", (double)res.floatTicks / res.steps,
+           BENCH_CLOCK_UNIT, (unsigned)res.floatChecksum);
+    printf("q16   %.1f %s/step checksum %08x\n", (double)res.fixedTicks / res.steps,
+           BENCH_CLOCK_UNIT, (unsigned)res.fixedChecksum);
+
+    return (warm.fixedChecksum == res.fixedChecksum) ? 0 : 1;
+}
@@ -0,0 +1,68 @@
+/*
+ * pd_check_main.c
+ *
+ *  Host check of the PD target seed (pd_init() / pd_seed() in
+ *  ASW/autopark/pd_control.c). Starts several runs back to back at different
+ *  wall distances with Kp = 0.05, as autoparkStart() would, and fails if a
+ *  run does not take its target from its own samples: a car that starts on
+ *  its target must steer 0, not toward the previous run's wall.
+ */
+
+#include <stdio.h>
+
+#include "pd_control.h"
+
+#define PD_CHECK_KP 0.05f
+#define PD_CHECK_SEED_MAX 16        /* samples fed before giving up on the seed */
+
+/* echo widths (10 ns) of the runs, about 15, 18, 12 and 15 cm */
+static const int g_runWalls[] = { 87500, 105000, 70000, 87500 };
+
+/* noise around the wall, the median is the wall itself */
+static const int g_seedNoise[] = { 300, -200, 0, 100, -300 };
+
+/* steering on the first tick of the search, the estimator fresh from one echo */
+static int steerAt(int echo)
+{
+    OdometryPose pose = { 0 };
+    WallEstimator est;
+
+    wallEstInit(&est, &pose);
+    wallEstUpdate(&est, ULT_LEFT, echo);
+    return pd_steerByEstimate(&est, LEVEL_LEFT);
+}
+
+int main(void)
+{
+    int runs = (int)(sizeof(g_runWalls) / sizeof(g_runWalls[0]));
+    int failed = 0;
+
+    pd_setGain(0, PD_CHECK_KP);
+
+    for (int run = 0; run < runs; run++)
+    {
+        int wall = g_runWalls[run];
+        int fed = 0;
+        boolean seeded = FALSE;
+
+        pd_init(LEVEL_LEFT);
+        while (seeded == FALSE && fed < PD_CHECK_SEED_MAX)
+        {
+            int noise = g_seedNoise[fed % (int)(sizeof(g_seedNoise) / sizeof(g_seedNoise[0]))];
+
+            seeded = pd_seed(LEVEL_LEFT, wall + noise);
+            fed++;
+        }
+
+        int mv = steerAt(wall);
+
+        printf("run %d wall %d seeded %s after %d samples mv %d\n", run, wall, seeded ? "yes" : "no", fed, mv);
+        if (seeded == FALSE || mv != 0)
+        {
+            failed++;
+        }
+    }
+
+    printf("# %d runs, %d failed\n", runs, failed);
+    return (failed == 0) ? 0 : 1;
+}
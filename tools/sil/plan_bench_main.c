@@ -0,0 +1,74 @@
+/*
+ * plan_bench_main.c
+ *
+ *  Host side of the parking path planner benchmark (ASW/autopark/plan_bench.c).
+ *  Every case of the grid is planned once per pass; the worst single
+ *  planPark() call is reported in ns. Host preemption only makes a pass
+ *  slower, so the smallest per-pass worst case is the stable figure and the
+ *  largest is what the OS added on top. The [b] entry of autoparkTune() runs
+ *  the same grid on the target and prints CPU cycles.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "plan_bench.h"
+
+static uint64 benchClock(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64)ts.tv_sec * 1000000000u + (uint64)ts.tv_nsec;
+}
+
+int main(int argc, char **argv)
+{
+    int passes = (argc > 1) ? atoi(argv[1]) : 20;
+    PlanBenchResult res;
+    uint64 stableWorst = ~(uint64)0;
+    uint64 maxWorst = 0;
+    uint32 stableCase = 0;
+    uint32 checksum;
+    int mode, gapStart, gapLength, gapDepth, wallOffset, radius;
+
+    if (passes <= 0)
+    {
+        fprintf(stderr, "usage: %s [passes]\n", argv[0]);
+        return 2;
+    }
+
+    planBenchRun(benchClock, &res);     /* caches and branch predictors */
+    checksum = res.checksum;
+
+    for (int p = 0; p < passes; p++)
+    {
+        planBenchRun(benchClock, &res);
+        if (res.checksum != checksum)
+        {
+            fprintf(stderr, "checksum changed between passes\n");
+            return 1;
+        }
+        if (res.worstTicks < stableWorst)
+        {
+            stableWorst = res.worstTicks;
+            stableCase = res.worstCase;
+        }
+        if (res.worstTicks > maxWorst)
+        {
+            maxWorst = res.worstTicks;
+        }
+    }
+
+    planBenchDescribe(stableCase, &mode, &gapStart, &gapLength, &gapDepth, &wallOffset, &radius);
+    printf("plans %u per pass, %u ok, longest path %u points\n", (unsigned)res.plans, (unsigned)res.ok,
+           (unsigned)res.maxPoints);
+    printf("mean  %.0f ns/plan\n", (double)res.totalTicks / res.plans);
+    printf("worst %llu ns (max over %d passes %llu ns) checksum %08x\n", (unsigned long long)stableWorst, passes,
+           (unsigned long long)maxWorst, (unsigned)checksum);
+    printf("worst case: %s gap %d..%d mm depth %d mm wall %d mm radius %d mm\n",
+           mode ? "parallel" : "perpendicular", gapStart, gapStart + gapLength, gapDepth, wallOffset, radius);
+
+    return 0;
+}
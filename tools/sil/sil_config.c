@@ -0,0 +1,152 @@
+#include "sil_config.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*********************************************************************************************************************/
+/*--------------------------------------------Private Variables/Constants--------------------------------------------*/
+/*********************************************************************************************************************/
+
+typedef struct
+{
+    const char *name;
+    size_t offset;
+    double defaultValue;
+    const char *desc;
+} SilParam;
+
+#define SIL_PARAM(field, name, def, desc) { name, offsetof(SilConfig, field), def, desc }
+
+static const SilParam SIL_PARAMS[] = {
+    SIL_PARAM(track,          "track",           0.150,    "wheel track [m]"),
+    SIL_PARAM(length,         "length",          0.250,    "vehicle length [m]"),
+    SIL_PARAM(width,          "width",           0.180,    "vehicle width [m]"),
+    SIL_PARAM(wheelVmax,      "wheel_vmax",      0.500,    "wheel speed at duty 1000 [m/s]"),
+    SIL_PARAM(dutyDeadband,   "duty_deadband",   60.0,     "duty below which a wheel stalls"),
+    SIL_PARAM(motorTau,       "motor_tau",       0.050,    "wheel speed time constant [s]"),
+    SIL_PARAM(brakeTau,       "brake_tau",       0.020,    "braking time constant [s]"),
+    SIL_PARAM(encScale,       "enc_scale",       1.0,      "wheel circumference error seen by the encoders"),
+
+    SIL_PARAM(usLatency,      "us_latency",      450e-6,   "trigger to echo delay [s]"),
+    SIL_PARAM(usNoise,        "us_noise",        0.003,    "range noise sigma [m]"),
+    SIL_PARAM(usDropout,      "us_dropout",      0.0,      "probability of a missing echo"),
+    SIL_PARAM(usOutlier,      "us_outlier",      0.0,      "probability of a spurious echo at a random range"),
+    SIL_PARAM(usMaxRange,     "us_max_range",    4.0,      "maximum range [m]"),
+    SIL_PARAM(usCone,         "us_cone",         15.0,     "beam angle [deg]"),
+    SIL_PARAM(usSideX,        "us_side_x",       0.0,      "side sensor offset from centre [m]"),
+    SIL_PARAM(soundSpeed,     "sound_speed",     343.0,    "speed of sound [m/s]"),
+
+    SIL_PARAM(wallClearance,  "wall_clearance",  0.150,    "start distance car side to wall [m]"),
+    SIL_PARAM(wallStart,      "wall_start",      -0.5,     "x where the wall begins [m]"),
+    SIL_PARAM(wallLength,     "wall_length",     4.0,      "total wall length [m]"),
+    SIL_PARAM(gapStart,       "gap_start",       1.0,      "x where the bay begins [m]"),
+    SIL_PARAM(gapWidth,       "gap_width",       0.400,    "bay width along the wall [m]"),
+    SIL_PARAM(gapDepth,       "gap_depth",       0.400,    "bay depth behind the wall [m]"),
+
+    SIL_PARAM(jitterY,        "jitter_y",        0.020,    "start lateral jitter, uniform +- [m]"),
+    SIL_PARAM(jitterHeading,  "jitter_heading",  2.0,      "start heading jitter, uniform +- [deg]"),
+    SIL_PARAM(jitterGap,      "jitter_gap",      0.050,    "bay position jitter, uniform +- [m]"),
+
+    SIL_PARAM(parkMargin,     "park_margin",     0.050,    "allowed protrusion out of the bay [m]"),
+    SIL_PARAM(parkHeading,    "park_heading",    -90.0,    "expected final heading [deg]"),
+    SIL_PARAM(parkHeadingTol, "park_heading_tol", 20.0,    "allowed heading error [deg]"),
+
+    SIL_PARAM(timeLimit,      "time_limit",      60.0,     "simulated time limit per episode [s]"),
+    SIL_PARAM(pollQuantum,    "poll_quantum",    10e-6,    "simulated time per STM0 read [s]"),
+    SIL_PARAM(physicsDt,      "physics_dt",      1e-3,     "vehicle integration step [s]"),
+    SIL_PARAM(uartBaud,       "uart_baud",       115200.0, "ASCLIN baud rate"),
+};
+
+#define SIL_PARAM_NUM ((int)(sizeof(SIL_PARAMS) / sizeof(SIL_PARAMS[0])))
+
+SilConfig g_silConfig;
+
+/*********************************************************************************************************************/
+/*--------------------------------------------Function Implementations-----------------------------------------------*/
+/*********************************************************************************************************************/
+
+static double *paramRef(SilConfig *cfg, const SilParam *p)
+{
+    return (double *)((char *)cfg + p->offset);
+}
+
+void silConfigInit(SilConfig *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    for (int i = 0; i < SIL_PARAM_NUM; i++)
+    {
+        *paramRef(cfg, &SIL_PARAMS[i]) = SIL_PARAMS[i].defaultValue;
+    }
+}
+
+int silConfigSet(SilConfig *cfg, const char *name, const char *value)
+{
+    for (int i = 0; i < SIL_PARAM_NUM; i++)
+    {
+        if (strcmp(SIL_PARAMS[i].name, name) == 0)
+        {
+            *paramRef(cfg, &SIL_PARAMS[i]) = atof(value);
+            return 0;
+        }
+    }
+    fprintf(stderr, "unknown parameter: %s\n", name);
+    return -1;
+}
+
+/* "name = value" per line, "wall x1 y1 x2 y2" adds an obstacle segment, '#' starts a comment */
+int silConfigLoad(SilConfig *cfg, const char *path)
+{
+    char line[256];
+    int lineNo = 0;
+    FILE *f = fopen(path, "r");
+
+    if (f == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), f) != NULL)
+    {
+        char name[64], value[64];
+        SilSegment s;
+
+        lineNo++;
+        char *hash = strchr(line, '#');
+        if (hash != NULL) *hash = '\0';
+
+        if (sscanf(line, " wall %lf %lf %lf %lf", &s.x1, &s.y1, &s.x2, &s.y2) == 4)
+        {
+            if (cfg->extraWallNum >= SIL_MAX_EXTRA_WALLS)
+            {
+                fprintf(stderr, "%s:%d: too many walls\n", path, lineNo);
+                fclose(f);
+                return -1;
+            }
+            cfg->extraWalls[cfg->extraWallNum++] = s;
+        }
+        else if (sscanf(line, " %63[a-z_0-9] = %63s", name, value) == 2)
+        {
+            if (silConfigSet(cfg, name, value) != 0)
+            {
+                fprintf(stderr, "%s:%d: bad line\n", path, lineNo);
+                fclose(f);
+                return -1;
+            }
+        }
+    }
+
+    fclose(f);
+    return 0;
+}
+
+void silConfigPrint(const SilConfig *cfg)
+{
+    for (int i = 0; i < SIL_PARAM_NUM; i++)
+    {
+        printf("  %-18s %-10g %s\n", SIL_PARAMS[i].name,
+               *paramRef((SilConfig *)cfg, &SIL_PARAMS[i]), SIL_PARAMS[i].desc);
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ * sil_config.h
+ *
+ *  Tunable vehicle, sensor and world parameters of the software-in-the-loop
+ *  model. All lengths in metres, times in seconds, angles in degrees.
+ */
+
+#ifndef SIL_CONFIG_H_
+#define SIL_CONFIG_H_
+
+#define SIL_MAX_EXTRA_WALLS 32
+
+typedef struct
+{
+    double x1, y1, x2, y2;
+} SilSegment;
+
+typedef struct
+{
+    /* vehicle */
+    double track;               /* distance between the wheel contact points */
+    double length;
+    double width;
+    double wheelVmax;           /* wheel speed at 100 % duty */
+    double dutyDeadband;        /* duty below which the wheel does not move */
+    double motorTau;            /* first order lag of the wheel speed */
+    double brakeTau;
+    double encScale;            /* true wheel circumference over the one the firmware assumes */
+
+    /* ultrasonic */
+    double usLatency;           /* trigger to echo rising edge */
+    double usNoise;             /* 1 sigma range noise */
+    double usDropout;           /* probability that a ping gets no echo */
+    double usOutlier;           /* probability that a ping returns a random range (crosstalk, multipath) */
+    double usMaxRange;
+    double usCone;              /* full beam angle */
+    double usSideX;             /* longitudinal offset of the side sensors */
+    double soundSpeed;
+
+    /* world: wall on the left with one bay */
+    double wallClearance;       /* start gap between the left side of the car and the wall */
+    double wallStart;
+    double wallLength;
+    double gapStart;
+    double gapWidth;
+    double gapDepth;
+
+    /* per episode randomisation */
+    double jitterY;
+    double jitterHeading;
+    double jitterGap;
+
+    /* pass criteria */
+    double parkMargin;          /* allowed protrusion of the footprint out of the bay */
+    double parkHeading;         /* expected final heading, -90 perpendicular (nose out), 0 parallel */
+    double parkHeadingTol;
+
+    /* run */
+    double timeLimit;
+    double pollQuantum;         /* simulated time consumed by one STM0 read */
+    double physicsDt;
+    double uartBaud;
+
+    SilSegment extraWalls[SIL_MAX_EXTRA_WALLS];
+    int extraWallNum;
+} SilConfig;
+
+extern SilConfig g_silConfig;
+
+void silConfigInit(SilConfig *cfg);
+int silConfigSet(SilConfig *cfg, const char *name, const char *value);
+int silConfigLoad(SilConfig *cfg, const char *path);
+void silConfigPrint(const SilConfig *cfg);
+
+#endif /* SIL_CONFIG_H_ */
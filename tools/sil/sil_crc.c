@@ -0,0 +1,123 @@
+/*
+ * sil_crc.c
+ *
+ *  Host build of the iLLD table CRC (SysSe/Math/Ifx_Crc.c) for the calls the
+ *  firmware makes: createTable, init and the direct table algorithm.
+ */
+
+#include "Ifx_Crc.h"
+
+/*********************************************************************************************************************/
+/*--------------------------------------------Function Implementations-----------------------------------------------*/
+/*********************************************************************************************************************/
+
+static uint32 reflect(uint32 crc, sint32 bitnum)
+{
+    uint32 out = 0;
+
+    for (sint32 i = 0; i < bitnum; i++)
+    {
+        if (crc & (1u << i))
+        {
+            out |= 1u << (bitnum - 1 - i);
+        }
+    }
+    return out;
+}
+
+static uint32 tableEntry(const Ifc_Crc_Table *table, uint32 index)
+{
+    if (table->order <= 8)
+    {
+        return ((const Ifc_Crc_Table8 *)table)->crctab[index];
+    }
+    if (table->order <= 16)
+    {
+        return ((const Ifc_Crc_Table16 *)table)->crctab[index];
+    }
+    return ((const Ifc_Crc_Table32 *)table)->crctab[index];
+}
+
+boolean Ifx_Crc_createTable(Ifc_Crc_Table *table, sint32 order, uint32 polynom, sint32 refin)
+{
+    if (order < 8 || order > 32 || (order % 8) != 0)
+    {
+        return FALSE;
+    }
+
+    table->order = order;
+    table->polynom = polynom;
+    table->refin = refin;
+    table->crchighbit = 1u << (order - 1);
+    table->crcmask = (((1u << (order - 1)) - 1) << 1) | 1;
+
+    for (uint32 i = 0; i < 256; i++)
+    {
+        uint32 crc = refin ? reflect(i, 8) : i;
+
+        crc <<= order - 8;
+        for (int j = 0; j < 8; j++)
+        {
+            uint32 bit = crc & table->crchighbit;
+            crc <<= 1;
+            if (bit)
+            {
+                crc ^= polynom;
+            }
+        }
+        if (refin)
+        {
+            crc = reflect(crc, order);
+        }
+        crc &= table->crcmask;
+
+        if (order <= 8) ((Ifc_Crc_Table8 *)table)->crctab[i] = (uint8)crc;
+        else if (order <= 16) ((Ifc_Crc_Table16 *)table)->crctab[i] = (uint16)crc;
+        else ((Ifc_Crc_Table32 *)table)->crctab[i] = crc;
+    }
+    return TRUE;
+}
+
+/* only the direct form (crcinit given without augmented zero bits) is used */
+boolean Ifx_Crc_init(Ifc_Crc *driver, const Ifc_Crc_Table *table, sint32 direct, sint32 refout, uint32 crcinit, uint32 crcxor)
+{
+    if (!direct || crcinit != (crcinit & table->crcmask) || crcxor != (crcxor & table->crcmask))
+    {
+        return FALSE;
+    }
+
+    driver->table = table;
+    driver->crcxor = crcxor;
+    driver->refout = refout;
+    driver->crcinit_direct = crcinit;
+    driver->crcinit_nondirect = 0;
+    return TRUE;
+}
+
+uint32 Ifx_Crc_tableFast(Ifc_Crc *driver, uint8 *p, uint32 len)
+{
+    const Ifc_Crc_Table *table = driver->table;
+    uint32 crc = driver->crcinit_direct;
+
+    if (table->refin)
+    {
+        crc = reflect(crc, table->order);
+        while (len--)
+        {
+            crc = (crc >> 8) ^ tableEntry(table, (crc & 0xff) ^ *p++);
+        }
+    }
+    else
+    {
+        while (len--)
+        {
+            crc = (crc << 8) ^ tableEntry(table, ((crc >> (table->order - 8)) & 0xff) ^ *p++);
+        }
+    }
+
+    if (driver->refout ^ table->refin)
+    {
+        crc = reflect(crc, table->order);
+    }
+    return (crc ^ driver->crcxor) & table->crcmask;
+}
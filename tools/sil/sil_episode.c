@@ -0,0 +1,327 @@
+/*
+ * sil_episode.c
+ *
+ *  Episode runner shared by autopark_sil and autopark_sweep.
+ */
+
+#include "sil_episode.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "autopark.h"
+#include "main1.h"
+#include "main2.h"
+#include "systeminit.h"
+
+#include "recorder.h"
+#include "trace.h"
+
+#include "sil_hal.h"
+#include "sil_record.h"
+#include "sil_world.h"
+
+/*********************************************************************************************************************/
+/*-------------------------------------------------Type Definitions--------------------------------------------------*/
+/*********************************************************************************************************************/
+
+typedef struct
+{
+    pid_t pid;
+    int fd;
+    int index;
+} SilWorker;
+
+/*********************************************************************************************************************/
+/*--------------------------------------------Private Variables/Constants--------------------------------------------*/
+/*********************************************************************************************************************/
+
+static const SilTunables *g_patches;    /* still to apply in this episode */
+static uint64 g_patchTick;
+
+static const char *RESULT_NAMES[SIL_RESULT_NUM] = {
+    "parked", "outside_bay", "heading", "collision", "timeout", "crash"
+};
+
+/*********************************************************************************************************************/
+/*--------------------------------------------Function Implementations-----------------------------------------------*/
+/*********************************************************************************************************************/
+
+/* the 'e' command at the end of the run: the dump goes through the Bluetooth mailbox and CPU2
+ * like on the target, and the bytes on the wire are captured to path */
+static void dumpTrace(const char *path)
+{
+#if TRACE_ENABLE
+    FILE *f = fopen(path, "wb");
+
+    if (f == NULL)
+    {
+        perror(path);
+        return;
+    }
+    silUartCapture(SIL_UART_BLUETOOTH, f);
+    traceDump();
+    for (uint64 end = silNow() + silSecondsToTicks(0.2); silNow() < end; )
+    {
+        silAdvance(silSecondsToTicks(10e-6));   /* CPU2 sends the last mailbox load */
+    }
+    silUartCapture(SIL_UART_BLUETOOTH, NULL);
+    fclose(f);
+#else
+    fprintf(stderr, "%s: tracing is not built in\n", path);
+#endif
+}
+
+static double wrapAngle(double a)
+{
+    while (a > M_PI) a -= 2.0 * M_PI;
+    while (a < -M_PI) a += 2.0 * M_PI;
+    return a;
+}
+
+static double jitter(double amplitude)
+{
+    return (2.0 * silRandomUniform() - 1.0) * amplitude;
+}
+
+static void evaluate(const SilConfig *cfg, const SilWorld *world, SilResult *res)
+{
+    const SilPose *p = &silVehicle()->pose;
+    double corners[4][2];
+    double m = cfg->parkMargin;
+
+    res->x = p->x;
+    res->y = p->y;
+    res->headingDeg = p->theta * 180.0 / M_PI;
+    res->travelled = silVehicle()->travelled;
+    res->bayError = hypot(p->x - 0.5 * (world->bayX0 + world->bayX1), p->y - 0.5 * (world->bayY0 + world->bayY1));
+    res->headingError = fabs(wrapAngle(p->theta - cfg->parkHeading * M_PI / 180.0)) * 180.0 / M_PI;
+
+    silFootprint(cfg, p, corners);
+    for (int i = 0; i < 4; i++)
+    {
+        if (corners[i][0] < world->bayX0 - m || corners[i][0] > world->bayX1 + m ||
+            corners[i][1] < world->bayY0 - m || corners[i][1] > world->bayY1 + m)
+        {
+            res->code = SIL_RESULT_OUTSIDE_BAY;
+            return;
+        }
+    }
+
+    /* perpendicular reverse parking ends with the nose pointing out of the bay (-90) */
+    if (res->headingError > cfg->parkHeadingTol)
+    {
+        res->code = SIL_RESULT_HEADING;
+        return;
+    }
+
+    res->code = SIL_RESULT_PARKED;
+}
+
+static void otherCores(void)
+{
+    main1Step();
+    main2Step();
+
+    /* calibration patch mid-run: only the overlay working page changes, nothing is reinitialised */
+    if (g_patches != NULL && silNow() >= g_patchTick)
+    {
+        for (int i = 0; i < g_patches->count; i++)
+        {
+            autoparkSetParam(g_patches->names[i], (float32)g_patches->values[i]);
+        }
+        g_patches = NULL;
+    }
+}
+
+static void runEpisode(const SilConfig *cfg, const SilEpisode *ep, SilResult *res)
+{
+    static SilWorld world;
+    SilPose start;
+    volatile uint64 t0 = 0;
+    int abort;
+
+    silRandomSeed(ep->seed);
+    start.x = 0.0;
+    start.y = jitter(cfg->jitterY);
+    start.theta = jitter(cfg->jitterHeading) * M_PI / 180.0;
+    silWorldBuild(&world, cfg, jitter(cfg->jitterGap));
+    silHalReset(cfg, &world, &start);
+
+    memset(res, 0, sizeof(*res));
+
+    abort = setjmp(g_silAbortJmp);
+    if (abort == SIL_ABORT_NONE)
+    {
+        systemInit();
+        autoparkInit();
+        main1Init();
+        main2Init();
+        silHalSetBackground(otherCores);
+        for (int i = 0; ep->tunables != NULL && i < ep->tunables->count; i++)
+        {
+            autoparkSetParam(ep->tunables->names[i], (float32)ep->tunables->values[i]);
+        }
+        if (ep->tuneInput != NULL)
+        {
+            silUartFeed(SIL_UART_BLUETOOTH, ep->tuneInput);
+            autoparkTune();
+            silHalPlaceVehicle(&start);
+        }
+
+        t0 = silNow();
+        if (ep->abortAt >= 0.0)
+        {
+            silUartFeedAt(SIL_UART_BLUETOOTH, "s", t0 + silSecondsToTicks(ep->abortAt));
+        }
+        if (ep->patches != NULL && ep->patches->count > 0)
+        {
+            g_patches = ep->patches;
+            g_patchTick = t0 + silSecondsToTicks(ep->patchAt);
+        }
+        autoparkExecute();
+        res->maneuverTime = (double)(silNow() - t0) / SIL_TICKS_PER_SEC;
+
+        /* let the car come to rest before judging the pose */
+        silAdvance(silSecondsToTicks(0.3));
+        evaluate(cfg, &world, res);
+        res->stopLatency = silStopLatency();
+        if (ep->tracePath != NULL)
+        {
+            dumpTrace(ep->tracePath);
+        }
+    }
+    else
+    {
+        res->maneuverTime = (double)(silNow() - t0) / SIL_TICKS_PER_SEC;
+        evaluate(cfg, &world, res);
+        res->code = (abort == SIL_ABORT_COLLISION) ? SIL_RESULT_COLLISION : SIL_RESULT_TIMEOUT;
+        res->stopLatency = silStopLatency();
+    }
+
+#if PROFILE_ENABLE
+    profileGetStats(res->profile);
+#endif
+    if (ep->recordPath != NULL)
+    {
+        silRecordSave(ep->recordPath, recorderGetEntries(), recorderGetCount(), recorderGetDropCount());
+    }
+}
+
+static void spawn(SilWorker *w, const SilConfig *cfg, const SilEpisode *ep, int index)
+{
+    int fds[2];
+
+    if (pipe(fds) != 0)
+    {
+        perror("pipe");
+        exit(2);
+    }
+
+    w->pid = fork();
+    if (w->pid < 0)
+    {
+        perror("fork");
+        exit(2);
+    }
+    if (w->pid == 0)
+    {
+        SilResult res;
+        close(fds[0]);
+        runEpisode(cfg, ep, &res);
+        fflush(stdout);
+        fflush(stderr);
+        if (write(fds[1], &res, sizeof(res)) != (ssize_t)sizeof(res))
+        {
+            _exit(3);
+        }
+        _exit(0);
+    }
+
+    close(fds[1]);
+    w->fd = fds[0];
+    w->index = index;
+}
+
+static void collect(SilWorker *w, SilResult *res)
+{
+    if (read(w->fd, res, sizeof(*res)) != (ssize_t)sizeof(*res))
+    {
+        memset(res, 0, sizeof(*res));
+        res->code = SIL_RESULT_CRASH;
+    }
+    close(w->fd);
+}
+
+const char *silResultName(int code)
+{
+    return RESULT_NAMES[code];
+}
+
+/* name is one of the autoparkSetParam() names */
+int silTunableExists(const char *name)
+{
+    const char *known;
+
+    for (uint32 i = 0; (known = autoparkGetParamName(i)) != NULL; i++)
+    {
+        if (strcmp(known, name) == 0)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* value is inside the range autoparkSetParam() accepts for name; prints the range if not */
+int silTunableInRange(const char *name, double value)
+{
+    float32 min, max;
+
+    if (!autoparkGetParamRange(name, &min, &max))
+    {
+        return 0;
+    }
+    if ((float32)value >= min && (float32)value <= max)
+    {
+        return 1;
+    }
+    fprintf(stderr, "tunable '%s' = %g is outside %g..%g\n", name, value, (double)min, (double)max);
+    return 0;
+}
+
+/* Runs count episodes, at most jobs at a time; results[i] belongs to episodes[i] */
+void silRunEpisodes(const SilConfig *cfg, const SilEpisode *episodes, int count, long jobs,
+                    SilResult *results)
+{
+    SilWorker *workers = calloc((size_t)jobs, sizeof(SilWorker));
+    int next = 0, active = 0;
+
+    fflush(stdout);
+    while (next < count || active > 0)
+    {
+        while (active < jobs && next < count)
+        {
+            spawn(&workers[active++], cfg, &episodes[next], next);
+            next++;
+        }
+
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        for (int i = 0; i < active; i++)
+        {
+            if (workers[i].pid == pid)
+            {
+                collect(&workers[i], &results[workers[i].index]);
+                workers[i] = workers[--active];
+                break;
+            }
+        }
+    }
+
+    free(workers);
+}
@@ -0,0 +1,73 @@
+/*
+ * sil_episode.h
+ *
+ *  One autopark episode against the simulated world, and a pool that runs
+ *  many of them in forked processes, one per host core. Forking gives every
+ *  episode the firmware's power-on file-scope state. sil_main.c runs episodes
+ *  of one configuration; sil_sweep.c runs the same seeds for many parameter
+ *  sets.
+ */
+
+#ifndef SIL_EPISODE_H_
+#define SIL_EPISODE_H_
+
+#include "Ifx_Types.h"
+
+#include "profile.h"
+
+#include "sil_config.h"
+
+#define SIL_TUNABLES_MAX 16
+
+typedef enum
+{
+    SIL_RESULT_PARKED,
+    SIL_RESULT_OUTSIDE_BAY,
+    SIL_RESULT_HEADING,
+    SIL_RESULT_COLLISION,
+    SIL_RESULT_TIMEOUT,
+    SIL_RESULT_CRASH,
+    SIL_RESULT_NUM
+} SilResultCode;
+
+typedef struct
+{
+    int code;
+    double x, y, headingDeg;
+    double maneuverTime;
+    double travelled;
+    double stopLatency;
+    double bayError;        /* car centre to bay centre [m] */
+    double headingError;    /* |heading - park_heading| [deg] */
+#if PROFILE_ENABLE
+    ProfileStats profile[PROFILE_SCOPE_NUM];    /* the firmware's profile table at the end */
+#endif
+} SilResult;
+
+/* firmware tunables set with autoparkSetParam() before the episode starts */
+typedef struct
+{
+    int count;
+    const char *names[SIL_TUNABLES_MAX];
+    double values[SIL_TUNABLES_MAX];
+} SilTunables;
+
+typedef struct
+{
+    uint64 seed;
+    const char *tuneInput;          /* typed into autoparkTune() first, NULL for none */
+    double abortAt;                 /* stop command this many seconds in, < 0 for none */
+    const SilTunables *tunables;    /* NULL for the firmware defaults */
+    const SilTunables *patches;     /* set while the car moves, like the 'k' command, NULL for none */
+    double patchAt;                 /* seconds into the run for patches */
+    const char *recordPath;         /* save the firmware's recording (recorder.h) here, NULL for none */
+    const char *tracePath;          /* capture the trace dump (trace.h, 'e' command) here, NULL for none */
+} SilEpisode;
+
+const char *silResultName(int code);
+int silTunableExists(const char *name);
+int silTunableInRange(const char *name, double value);
+void silRunEpisodes(const SilConfig *cfg, const SilEpisode *episodes, int count, long jobs,
+                    SilResult *results);
+
+#endif /* SIL_EPISODE_H_ */
@@ -0,0 +1,565 @@
+#include "sil_hal.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "IfxCpu.h"
+#include "IfxPort.h"
+#include "IfxStm.h"
+#include "asclin0.h"
+#include "asclin1.h"
+#include "gtm_atom_pwm.h"
+#include "ultrasonic.h"
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------Macros-------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#define SIL_RX_BUFFER_SIZE 4096
+#define SIL_ECHO_TIMEOUT   0.038    /* HC-SR04 holds ECHO high for 38 ms without a target */
+#define SIL_DEG            (M_PI / 180.0)
+#define SIL_TYPE_IDLE      1.0      /* motors idle this long before the next scripted line is typed */
+
+/*********************************************************************************************************************/
+/*-------------------------------------------------Type Definitions--------------------------------------------------*/
+/*********************************************************************************************************************/
+
+typedef struct
+{
+    double x, y, dir;   /* mount point and beam direction in the vehicle frame */
+} SilSensorMount;
+
+typedef struct
+{
+    uint64 rise;
+    uint64 fall;
+    int captured;       /* falling edge already reported to the TIM capture */
+} SilEcho;
+
+typedef struct
+{
+    char rx[SIL_RX_BUFFER_SIZE];
+    int rxHead;
+    int rxTail;
+    uint64 txBusyUntil;
+    const char *script;     /* typed one line at a time, see typeScript() */
+    uint64 typedAt;
+    const char *pending;    /* delivered once simulated time reaches pendingAt */
+    uint64 pendingAt;
+    FILE *capture;          /* transmitted bytes are also written here, NULL for none */
+} SilUartState;
+
+/*********************************************************************************************************************/
+/*-------------------------------------------------Global variables--------------------------------------------------*/
+/*********************************************************************************************************************/
+
+Ifx_P g_silPort[SIL_PORT_NUM];
+jmp_buf g_silAbortJmp;
+
+extern const UltPin ULT_PINS[ULT_SENSORS_NUM];  /* ultrasonic.c, pins to model */
+
+/*********************************************************************************************************************/
+/*--------------------------------------------Private Variables/Constants--------------------------------------------*/
+/*********************************************************************************************************************/
+
+static const SilConfig *g_cfg;
+static const SilWorld *g_world;
+
+static Ifx_STM g_stm0;
+static uint64 g_now;
+static uint64 g_physicsTime;
+static uint64 g_pollTicks;
+static uint64 g_physicsTicks;
+static uint64 g_limit;
+
+static SilVehicle g_vehicle;
+static uint32 g_duty[2];
+
+static SilSensorMount g_mount[ULT_SENSORS_NUM];
+static SilEcho g_echo[ULT_SENSORS_NUM];
+
+static SilUartState g_uart[SIL_UART_NUM];
+static int g_echoOutput;
+
+static uint64 g_rng;
+
+static uint64 g_stopCmdTime;
+static uint64 g_stoppedTime;
+
+static boolean g_irqEnabled;
+static int g_inIsr;
+static uint64 g_isrClock;       /* STM0 reads inside a dispatch, see silStm0Access() */
+
+static uint64 g_lastMotion;
+static void (*g_background)(void);
+
+/*********************************************************************************************************************/
+/*--------------------------------------------Function Implementations-----------------------------------------------*/
+/*********************************************************************************************************************/
+
+uint64 silSecondsToTicks(double seconds)
+{
+    return (uint64)(seconds * (double)SIL_TICKS_PER_SEC + 0.5);
+}
+
+/* splitmix64, so that every episode is reproducible from its seed */
+static uint64 nextRandom(void)
+{
+    uint64 z = (g_rng += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+double silRandomUniform(void)
+{
+    return (double)(nextRandom() >> 11) / 9007199254740992.0;
+}
+
+double silRandomGauss(void)
+{
+    double u1 = silRandomUniform();
+    double u2 = silRandomUniform();
+    if (u1 < 1e-300) u1 = 1e-300;
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+void silRandomSeed(uint64 seed)
+{
+    g_rng = seed;
+}
+
+void silHalReset(const SilConfig *cfg, const SilWorld *world, const SilPose *start)
+{
+    g_cfg = cfg;
+    g_world = world;
+
+    memset(g_silPort, 0, sizeof(g_silPort));
+    memset(&g_stm0, 0, sizeof(g_stm0));
+    memset(g_duty, 0, sizeof(g_duty));
+    memset(g_echo, 0, sizeof(g_echo));
+    memset(g_uart, 0, sizeof(g_uart));
+
+    g_now = 0;
+    g_physicsTime = 0;
+    g_stopCmdTime = 0;
+    g_stoppedTime = 0;
+    g_irqEnabled = TRUE;
+    g_inIsr = 0;
+    g_lastMotion = 0;
+    g_background = NULL;
+    g_pollTicks = silSecondsToTicks(cfg->pollQuantum);
+    g_physicsTicks = silSecondsToTicks(cfg->physicsDt);
+    g_limit = silSecondsToTicks(cfg->timeLimit);
+    if (g_pollTicks == 0) g_pollTicks = 1;
+    if (g_physicsTicks == 0) g_physicsTicks = 1;
+
+    silDflashReset();
+
+    /* brakes are released at reset, the car stands still because duty is 0 */
+    silVehicleReset(&g_vehicle, start);
+
+    g_mount[ULT_LEFT] = (SilSensorMount){ cfg->usSideX, cfg->width / 2.0, M_PI / 2.0 };
+    g_mount[ULT_RIGHT] = (SilSensorMount){ cfg->usSideX, -cfg->width / 2.0, -M_PI / 2.0 };
+    g_mount[ULT_REAR] = (SilSensorMount){ -cfg->length / 2.0, 0.0, M_PI };
+}
+
+void silHalSetEcho(int enable)
+{
+    g_echoOutput = enable;
+}
+
+uint64 silNow(void)
+{
+    return g_now;
+}
+
+/* put the car back on the start pose, e.g. after tuning runs moved it, and restart the time limit.
+   Carrying the car does not turn the wheels, so the encoder paths are kept */
+void silHalPlaceVehicle(const SilPose *pose)
+{
+    double pathLeft = g_vehicle.pathLeft;
+    double pathRight = g_vehicle.pathRight;
+
+    silVehicleReset(&g_vehicle, pose);
+    g_vehicle.pathLeft = pathLeft;
+    g_vehicle.pathRight = pathRight;
+    g_limit = g_now + silSecondsToTicks(g_cfg->timeLimit);
+}
+
+/* the CPU1/CPU2 main loops, run once per time step like an interrupt */
+void silHalSetBackground(void (*step)(void))
+{
+    g_background = step;
+}
+
+const SilVehicle *silVehicle(void)
+{
+    return &g_vehicle;
+}
+
+/* motor.c wiring: A = left (DIR P10.1, BRAKE P02.7), B = right (DIR P10.2, BRAKE P02.6) */
+static void stepPhysics(void)
+{
+    SilWheelCmd left = { (int)g_duty[0], MODULE_P10.OUT.B.P1, MODULE_P02.OUT.B.P7 };
+    SilWheelCmd right = { (int)g_duty[1], MODULE_P10.OUT.B.P2, MODULE_P02.OUT.B.P6 };
+
+    if (g_stopCmdTime != 0 && g_stoppedTime == 0 && left.brake && right.brake)
+    {
+        g_stoppedTime = g_physicsTime;
+    }
+    if ((left.duty != 0 && !left.brake) || (right.duty != 0 && !right.brake))
+    {
+        g_lastMotion = g_physicsTime;
+    }
+
+    silVehicleStep(&g_vehicle, g_cfg, g_world, &left, &right, g_cfg->physicsDt);
+}
+
+/* time from the delivery of a Bluetooth 's' to both brakes engaged, -1 if it did not happen */
+double silStopLatency(void)
+{
+    if (g_stopCmdTime == 0 || g_stoppedTime == 0)
+    {
+        return -1.0;
+    }
+    if (g_stoppedTime < g_stopCmdTime)
+    {
+        return 0.0;     /* braked within the physics step the byte arrived in */
+    }
+    return (double)(g_stoppedTime - g_stopCmdTime) / SIL_TICKS_PER_SEC;
+}
+
+boolean IfxCpu_disableInterrupts(void)
+{
+    boolean enabled = g_irqEnabled;
+    g_irqEnabled = FALSE;
+    return enabled;
+}
+
+void IfxCpu_restoreInterrupts(boolean enabled)
+{
+    g_irqEnabled = enabled;
+}
+
+static void pushRx(SilUartState *u, char c)
+{
+    int next = (u->rxHead + 1) % SIL_RX_BUFFER_SIZE;
+    if (next != u->rxTail)
+    {
+        u->rx[u->rxHead] = c;
+        u->rxHead = next;
+    }
+}
+
+/* ';' and '\n' in scripts become the carriage return a terminal sends */
+static char scriptChar(char c)
+{
+    return (c == ';' || c == '\n') ? '\r' : c;
+}
+
+/* A scripted line is typed once the motors have been idle for SIL_TYPE_IDLE
+ * and the previous line has been read, like a user answering a prompt. Bytes
+ * typed ahead would be swallowed by the command polls during a run. */
+static void typeScript(SilUartState *u)
+{
+    uint64 idle = silSecondsToTicks(SIL_TYPE_IDLE);
+    char c;
+
+    if (u->script == NULL || *u->script == '\0' || u->rxHead != u->rxTail ||
+        g_now < g_lastMotion + idle || g_now < u->typedAt + idle)
+    {
+        return;
+    }
+    do
+    {
+        c = scriptChar(*u->script++);
+        pushRx(u, c);
+    } while (c != '\r' && *u->script);
+    u->typedAt = g_now;
+}
+
+static void deliverPending(SilUart uart)
+{
+    SilUartState *u = &g_uart[uart];
+
+    if (u->pending != NULL && g_now >= u->pendingAt)
+    {
+        for (const char *p = u->pending; *p; p++)
+        {
+            pushRx(u, scriptChar(*p));
+            if (uart == SIL_UART_BLUETOOTH && *p == 's' && g_stopCmdTime == 0)
+            {
+                g_stopCmdTime = g_now;
+            }
+        }
+        u->pending = NULL;
+    }
+    typeScript(u);
+}
+
+/* STM0 compare 1 first (higher priority), then the GTM TIM channel on each
+ * echo pin, which interrupts once the pulse has ended with 1 us resolution,
+ * then the ASCLIN0 TX and ASCLIN1 RX interrupts and the CPU1/CPU2 loops. All of it runs in
+ * zero simulated time; STM0 reads only move a local clock (g_isrClock). */
+static void dispatchInterrupts(void)
+{
+    for (int i = 0; i < SIL_UART_NUM; i++)
+    {
+        deliverPending((SilUart)i);
+    }
+    if (!g_irqEnabled || g_inIsr)
+    {
+        return;
+    }
+
+    g_inIsr = 1;
+    g_isrClock = g_now;
+    silStm0Dispatch();
+    for (int i = 0; i < ULT_SENSORS_NUM; i++)
+    {
+        SilEcho *e = &g_echo[i];
+        if (e->fall != 0 && !e->captured && g_now >= e->fall)
+        {
+            uint64 width = (e->fall - e->rise) / 100 * 100;
+            e->captured = 1;
+            silTimInCapture(ULT_PINS[i].echo.port, ULT_PINS[i].echo.pinIndex, (uint32)width);
+        }
+    }
+    asclin0TxIsrHandler();
+    if (g_uart[SIL_UART_BLUETOOTH].rxHead != g_uart[SIL_UART_BLUETOOTH].rxTail)
+    {
+        asclin1RxIsrHandler();
+    }
+    if (g_background != NULL)
+    {
+        g_background();
+    }
+    g_inIsr = 0;
+}
+
+void silAdvance(uint64 ticks)
+{
+    g_now += ticks;
+
+    while (g_now - g_physicsTime >= g_physicsTicks)
+    {
+        g_physicsTime += g_physicsTicks;
+        stepPhysics();
+    }
+    dispatchInterrupts();
+
+    if (g_vehicle.collided)
+    {
+        longjmp(g_silAbortJmp, SIL_ABORT_COLLISION);
+    }
+    if (g_now >= g_limit)
+    {
+        longjmp(g_silAbortJmp, SIL_ABORT_TIMEOUT);
+    }
+}
+
+/*********************************************************************************************************************/
+/*--------------------------------------------------STM0 time base---------------------------------------------------*/
+/*********************************************************************************************************************/
+
+/* Inside a dispatch (interrupts, other cores) time is not advanced, so that
+ * code does not slow CPU0 down; busy-waits there still see the clock move. */
+Ifx_STM *silStm0Access(void)
+{
+    uint64 now;
+
+    /* CAP latches the upper word of the value the previous TIM0 read returned */
+    g_stm0.CAP.U = (uint32)((g_inIsr ? g_isrClock : g_now) >> 32);
+    if (g_inIsr)
+    {
+        g_isrClock += g_pollTicks;
+        now = g_isrClock;
+    }
+    else
+    {
+        silAdvance(g_pollTicks);
+        now = g_now;
+    }
+    g_stm0.TIM0.U = (uint32)now;
+    return &g_stm0;
+}
+
+/*********************************************************************************************************************/
+/*-----------------------------------------------Port pins / ultrasonic----------------------------------------------*/
+/*********************************************************************************************************************/
+
+static double rangeOf(UltraDir dir)
+{
+    const SilPose *p = &g_vehicle.pose;
+    const SilSensorMount *m = &g_mount[dir];
+    double c = cos(p->theta);
+    double s = sin(p->theta);
+    double x = p->x + m->x * c - m->y * s;
+    double y = p->y + m->x * s + m->y * c;
+    double half = g_cfg->usCone * SIL_DEG / 2.0;
+    double best = g_cfg->usMaxRange;
+
+    /* three rays approximate the beam cone, the nearest reflector wins */
+    for (int i = -1; i <= 1; i++)
+    {
+        double r = silWorldRaycast(g_world, x, y, p->theta + m->dir + i * half, g_cfg->usMaxRange);
+        if (r < best) best = r;
+    }
+    return best;
+}
+
+static void fireSensor(UltraDir dir)
+{
+    SilEcho *e = &g_echo[dir];
+
+    e->captured = 0;
+    if (silRandomUniform() < g_cfg->usDropout)
+    {
+        e->rise = e->fall = 0;
+        return;
+    }
+
+    double range = rangeOf(dir);
+    double width;
+    if (silRandomUniform() < g_cfg->usOutlier)
+    {
+        range = 0.02 + silRandomUniform() * (g_cfg->usMaxRange - 0.02);
+    }
+    if (range >= g_cfg->usMaxRange)
+    {
+        width = SIL_ECHO_TIMEOUT;
+    }
+    else
+    {
+        range += g_cfg->usNoise * silRandomGauss();
+        if (range < 0.02) range = 0.02;
+        width = 2.0 * range / g_cfg->soundSpeed;
+    }
+
+    e->rise = g_now + silSecondsToTicks(g_cfg->usLatency);
+    e->fall = e->rise + silSecondsToTicks(width);
+}
+
+static int findSensor(Ifx_P *port, uint8 pinIndex, int echo)
+{
+    for (int i = 0; i < ULT_SENSORS_NUM; i++)
+    {
+        const GpioPin *pin = echo ? &ULT_PINS[i].echo : &ULT_PINS[i].trigger;
+        if (pin->port == port && pin->pinIndex == pinIndex)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void IfxPort_setPinMode(Ifx_P *port, uint8 pinIndex, IfxPort_Mode mode)
+{
+    (void)port;
+    (void)pinIndex;
+    (void)mode;
+}
+
+void IfxPort_setPinState(Ifx_P *port, uint8 pinIndex, IfxPort_State action)
+{
+    uint32 mask = 1u << pinIndex;
+    uint32 before = port->OUT.U & mask;
+
+    if (action == IfxPort_State_high) port->OUT.U |= mask;
+    else if (action == IfxPort_State_low) port->OUT.U &= ~mask;
+    else if (action == IfxPort_State_toggled) port->OUT.U ^= mask;
+
+    /* HC-SR04 starts its burst on the falling edge of TRIG */
+    if (before && !(port->OUT.U & mask))
+    {
+        int sensor = findSensor(port, pinIndex, 0);
+        if (sensor >= 0)
+        {
+            fireSensor((UltraDir)sensor);
+        }
+    }
+}
+
+boolean IfxPort_getPinState(Ifx_P *port, uint8 pinIndex)
+{
+    int sensor = findSensor(port, pinIndex, 1);
+    if (sensor >= 0)
+    {
+        const SilEcho *e = &g_echo[sensor];
+        return (g_now >= e->rise && g_now < e->fall) ? TRUE : FALSE;
+    }
+    return (port->OUT.U >> pinIndex) & 1u;
+}
+
+/*********************************************************************************************************************/
+/*----------------------------------------------------UART / PWM-----------------------------------------------------*/
+/*********************************************************************************************************************/
+
+/* one byte occupies the line for 10 bit times; the caller spins until the previous byte is out */
+int silUartTxReady(SilUart uart)
+{
+    return g_now >= g_uart[uart].txBusyUntil;
+}
+
+void silUartTx(SilUart uart, unsigned char ch)
+{
+    SilUartState *u = &g_uart[uart];
+
+    while (g_now < u->txBusyUntil && !g_inIsr)
+    {
+        silAdvance(g_pollTicks);
+    }
+    u->txBusyUntil = g_now + silSecondsToTicks(10.0 / g_cfg->uartBaud);
+
+    if (g_echoOutput)
+    {
+        fputc(ch, uart == SIL_UART_BLUETOOTH ? stdout : stderr);
+    }
+    if (u->capture != NULL)
+    {
+        fputc(ch, u->capture);
+    }
+}
+
+/* until the next silHalReset() */
+void silUartCapture(SilUart uart, FILE *file)
+{
+    g_uart[uart].capture = file;
+}
+
+/* polling the receiver is a busy-wait like any other, except from an interrupt */
+int silUartRx(SilUart uart, unsigned char *ch)
+{
+    SilUartState *u = &g_uart[uart];
+
+    if (!g_inIsr)
+    {
+        silAdvance(g_pollTicks);
+    }
+    if (u->rxHead == u->rxTail)
+    {
+        return 0;
+    }
+    *ch = (unsigned char)u->rx[u->rxTail];
+    u->rxTail = (u->rxTail + 1) % SIL_RX_BUFFER_SIZE;
+    return 1;
+}
+
+void silUartFeed(SilUart uart, const char *script)
+{
+    g_uart[uart].script = script;
+}
+
+void silUartFeedAt(SilUart uart, const char *data, uint64 at)
+{
+    g_uart[uart].pending = data;
+    g_uart[uart].pendingAt = at;
+}
+
+/* a compare value beyond the period keeps the output active for the whole period */
+void silPwmSetDuty(int channel, uint32 duty)
+{
+    g_duty[channel] = (duty > PWM_PERIOD) ? PWM_PERIOD : duty;
+}
@@ -0,0 +1,73 @@
+/*
+ * sil_hal.h
+ *
+ *  Simulated time base and peripherals behind the fake iLLD headers in hal/.
+ *  Simulated time only moves when CPU0 polls STM0 or waits on the UART, so an
+ *  episode runs as fast as the host can execute the polling loops. Interrupts
+ *  and the CPU1/CPU2 loops are run between CPU0's time steps.
+ */
+
+#ifndef SIL_HAL_H_
+#define SIL_HAL_H_
+
+#include <setjmp.h>
+#include <stdio.h>
+
+#include "Ifx_Types.h"
+#include "IfxPort.h"
+#include "sil_config.h"
+#include "sil_vehicle.h"
+#include "sil_world.h"
+
+#define SIL_TICKS_PER_SEC 100000000ULL  /* STM0 runs at 100 MHz */
+
+typedef enum
+{
+    SIL_ABORT_NONE,
+    SIL_ABORT_TIMEOUT,
+    SIL_ABORT_COLLISION
+} SilAbort;
+
+typedef enum
+{
+    SIL_UART_DEBUG,     /* ASCLIN0, myPrintf and LOG_PRINTF */
+    SIL_UART_BLUETOOTH, /* ASCLIN1, bluetoothPrintf */
+    SIL_UART_NUM
+} SilUart;
+
+extern jmp_buf g_silAbortJmp;
+
+void silHalReset(const SilConfig *cfg, const SilWorld *world, const SilPose *start);
+void silHalSetEcho(int enable);
+
+uint64 silNow(void);
+void silAdvance(uint64 ticks);
+uint64 silSecondsToTicks(double seconds);
+
+void silHalPlaceVehicle(const SilPose *pose);
+void silHalSetBackground(void (*step)(void));
+const SilVehicle *silVehicle(void);
+
+void silRandomSeed(uint64 seed);
+double silRandomUniform(void);
+double silRandomGauss(void);
+
+/* MCAL side, used by sil_mcal.c */
+void silUartTx(SilUart uart, unsigned char ch);
+int silUartTxReady(SilUart uart);
+int silUartRx(SilUart uart, unsigned char *ch);
+void silUartFeed(SilUart uart, const char *script);
+void silUartFeedAt(SilUart uart, const char *data, uint64 at);
+void silUartCapture(SilUart uart, FILE *file);
+double silStopLatency(void);
+void silPwmSetDuty(int channel, uint32 duty);
+
+/* DFLASH stand-in in sil_mcal.c; silHalReset() reloads it, from the file if one is set */
+void silDflashSetFile(const char *path);
+void silDflashReset(void);
+
+/* sil_mcal.c side, the simulator raises these interrupts */
+void silStm0Dispatch(void);
+void silTimInCapture(Ifx_P *port, uint8 pinIndex, uint32 pulse10Ns);
+
+#endif /* SIL_HAL_H_ */
@@ -0,0 +1,294 @@
+/*
+ * sil_main.c
+ *
+ *  Runs autoparkExecute() episodes against the simulated car and wall layout
+ *  and reports pass/fail and the final pose of each. Every episode runs in its
+ *  own forked process, so the firmware's file-scope state starts from power-on
+ *  values and episodes spread over all host cores.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define PROFILE_CLOCK_UNIT "tsc"
+#else
+#define PROFILE_CLOCK_UNIT "ns"
+#endif
+
+#include "sil_config.h"
+#include "sil_episode.h"
+#include "sil_hal.h"
+
+/*********************************************************************************************************************/
+/*--------------------------------------------Function Implementations-----------------------------------------------*/
+/*********************************************************************************************************************/
+
+static double wallClock(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+#if PROFILE_ENABLE
+static void profileMerge(ProfileStats *into, const ProfileStats *from)
+{
+    if (from->count == 0)
+    {
+        return;
+    }
+    if (into->count == 0 || from->minCycles < into->minCycles)
+    {
+        into->minCycles = from->minCycles;
+    }
+    if (from->maxCycles > into->maxCycles)
+    {
+        into->maxCycles = from->maxCycles;
+    }
+    into->count += from->count;
+    into->cycles += from->cycles;
+    for (int i = 0; i < PROFILE_HIST_BINS; i++)
+    {
+        into->histogram[i] += from->histogram[i];
+    }
+}
+
+/* the firmware's profile table summed over all episodes, as comment lines after the CSV */
+static void printProfile(const SilResult *results, int episodes)
+{
+    printf("# profile over %d episodes, host " PROFILE_CLOCK_UNIT " per call\n", episodes);
+    printf("# scope,count,min,mean,max,histogram (bin i: under 2^(%d+i), the last bin the rest)\n",
+           PROFILE_HIST_MIN_LOG2);
+    for (int s = 0; s < PROFILE_SCOPE_NUM; s++)
+    {
+        ProfileStats total = { 0 };
+
+        for (int i = 0; i < episodes; i++)
+        {
+            profileMerge(&total, &results[i].profile[s]);
+        }
+        if (total.count == 0)
+        {
+            continue;
+        }
+        printf("# %s,%u,%u,%llu,%u,", profileGetName((ProfileScope)s), (unsigned)total.count,
+               (unsigned)total.minCycles, (unsigned long long)(total.cycles / total.count),
+               (unsigned)total.maxCycles);
+        for (int i = 0; i < PROFILE_HIST_BINS; i++)
+        {
+            printf(i == 0 ? "%u" : " %u", (unsigned)total.histogram[i]);
+        }
+        printf("\n");
+    }
+}
+#endif
+
+static void usage(const char *argv0)
+{
+    printf("usage: %s [options]\n"
+           "  -n N          number of episodes (default 1)\n"
+           "  -s SEED       base seed, episode i uses SEED + i (default 1)\n"
+           "  -j N          parallel episodes (default: online cores)\n"
+           "  -c FILE       load parameters / extra walls from FILE\n"
+           "  -p NAME=VAL   override one parameter\n"
+           "  -t NAME=VAL   set a firmware tunable (autoparkSetParam()), e.g. kd=0.5\n"
+           "  -k SECONDS:NAME=VAL  patch a tunable SECONDS into the run, as the 'k' command\n"
+           "                does over Bluetooth; repeat for more names at the same time\n"
+           "  -i INPUT      run autoparkTune() first with INPUT typed over Bluetooth\n"
+           "                (';' is Enter), e.g. \"1;250000;y;c;\"\n"
+           "  -x SECONDS    send the Bluetooth stop command SECONDS into the run\n"
+           "  -r FILE       save the firmware's recording of the run for autopark_replay,\n"
+           "                FILE.N for episode N when there are several\n"
+           "  -e FILE       after a run that ends normally, dump the event trace over\n"
+           "                Bluetooth (the 'e' command) and capture it to FILE(.N) for\n"
+           "                pid_log.py --trace\n"
+           "  -f FILE       data flash image: every episode boots from FILE and parameter\n"
+           "                saves go back to it, implies -j 1\n"
+           "  -P            print the firmware's per-scope profile (profile.h) summed over\n"
+           "                all episodes, in host " PROFILE_CLOCK_UNIT " per call\n"
+           "  -v            echo UART output (bluetooth on stdout, debug on stderr), implies -j 1\n"
+           "  -l            list parameters and exit\n", argv0);
+}
+
+int main(int argc, char **argv)
+{
+    int episodes = 1;
+    uint64 baseSeed = 1;
+    long jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    int verbose = 0;
+    int profile = 0;
+    const char *flashFile = NULL;
+    const char *recordFile = NULL;
+    const char *traceFile = NULL;
+    const char *tuneInput = NULL;
+    double abortAt = -1.0;
+    SilTunables tunables = { 0 };
+    SilTunables patches = { 0 };
+    double patchAt = 0.0;
+    int opt;
+
+    silConfigInit(&g_silConfig);
+
+    while ((opt = getopt(argc, argv, "n:s:j:c:p:t:k:i:x:f:r:e:Pvlh")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            episodes = atoi(optarg);
+            break;
+        case 's':
+            baseSeed = strtoull(optarg, NULL, 0);
+            break;
+        case 'j':
+            jobs = atol(optarg);
+            break;
+        case 'c':
+            if (silConfigLoad(&g_silConfig, optarg) != 0) return 2;
+            break;
+        case 'p':
+        {
+            char *eq = strchr(optarg, '=');
+            if (eq == NULL) { usage(argv[0]); return 2; }
+            *eq = '\0';
+            if (silConfigSet(&g_silConfig, optarg, eq + 1) != 0) return 2;
+            break;
+        }
+        case 't':
+        {
+            char *eq = strchr(optarg, '=');
+            if (eq == NULL || tunables.count == SIL_TUNABLES_MAX) { usage(argv[0]); return 2; }
+            *eq = '\0';
+            if (!silTunableExists(optarg))
+            {
+                fprintf(stderr, "unknown tunable '%s'\n", optarg);
+                return 2;
+            }
+            tunables.names[tunables.count] = optarg;
+            tunables.values[tunables.count] = atof(eq + 1);
+            if (!silTunableInRange(optarg, tunables.values[tunables.count++])) return 2;
+            break;
+        }
+        case 'k':
+        {
+            char *colon = strchr(optarg, ':');
+            char *eq = (colon != NULL) ? strchr(colon, '=') : NULL;
+            if (eq == NULL || patches.count == SIL_TUNABLES_MAX) { usage(argv[0]); return 2; }
+            *colon = '\0';
+            *eq = '\0';
+            if (!silTunableExists(colon + 1))
+            {
+                fprintf(stderr, "unknown tunable '%s'\n", colon + 1);
+                return 2;
+            }
+            patchAt = atof(optarg);
+            patches.names[patches.count] = colon + 1;
+            patches.values[patches.count] = atof(eq + 1);
+            if (!silTunableInRange(colon + 1, patches.values[patches.count++])) return 2;
+            break;
+        }
+        case 'i':
+            tuneInput = optarg;
+            break;
+        case 'x':
+            abortAt = atof(optarg);
+            break;
+        case 'f':
+            flashFile = optarg;
+            break;
+        case 'r':
+            recordFile = optarg;
+            break;
+        case 'e':
+            traceFile = optarg;
+            break;
+        case 'P':
+            profile = 1;
+            break;
+        case 'v':
+            verbose = 1;
+            break;
+        case 'l':
+            silConfigPrint(&g_silConfig);
+            return 0;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if (verbose)
+    {
+        jobs = 1;
+        silHalSetEcho(1);
+    }
+    if (flashFile != NULL)
+    {
+        /* one episode at a time, so each boots from what the previous one saved */
+        jobs = 1;
+        silDflashSetFile(flashFile);
+    }
+    if (jobs < 1) jobs = 1;
+    if (episodes < 1) episodes = 1;
+
+    SilEpisode *runs = calloc((size_t)episodes, sizeof(SilEpisode));
+    SilResult *results = calloc((size_t)episodes, sizeof(SilResult));
+    for (int i = 0; i < episodes; i++)
+    {
+        runs[i].seed = baseSeed + (uint64)i;
+        runs[i].tuneInput = tuneInput;
+        runs[i].abortAt = abortAt;
+        runs[i].tunables = &tunables;
+        runs[i].patches = &patches;
+        runs[i].patchAt = patchAt;
+        if (recordFile != NULL)
+        {
+            char *path = malloc(strlen(recordFile) + 16);
+            sprintf(path, episodes > 1 ? "%s.%d" : "%s", recordFile, i);
+            runs[i].recordPath = path;
+        }
+        if (traceFile != NULL)
+        {
+            char *path = malloc(strlen(traceFile) + 16);
+            sprintf(path, episodes > 1 ? "%s.%d" : "%s", traceFile, i);
+            runs[i].tracePath = path;
+        }
+    }
+
+    double t0 = wallClock();
+    silRunEpisodes(&g_silConfig, runs, episodes, jobs, results);
+    double elapsed = wallClock() - t0;
+    int passed = 0;
+
+    printf("episode,seed,result,x,y,heading_deg,maneuver_s,travelled_m,stop_ms\n");
+    for (int i = 0; i < episodes; i++)
+    {
+        const SilResult *r = &results[i];
+        printf("%d,%llu,%s,%.3f,%.3f,%.1f,%.3f,%.3f,%.2f\n", i, (unsigned long long)runs[i].seed,
+               silResultName(r->code), r->x, r->y, r->headingDeg, r->maneuverTime, r->travelled,
+               r->stopLatency < 0.0 ? -1.0 : r->stopLatency * 1000.0);
+        if (r->code == SIL_RESULT_PARKED) passed++;
+    }
+    printf("# %d/%d parked (%.1f %%), %.2f s wall, %.0f episodes/min, %ld jobs\n",
+           passed, episodes, 100.0 * passed / episodes, elapsed, episodes / elapsed * 60.0, jobs);
+#if PROFILE_ENABLE
+    if (profile)
+    {
+        printProfile(results, episodes);
+    }
+#else
+    (void)profile;
+#endif
+
+    for (int i = 0; i < episodes; i++)
+    {
+        free((char *)runs[i].recordPath);
+        free((char *)runs[i].tracePath);
+    }
+    free(runs);
+    free(results);
+    return passed == episodes ? 0 : 1;
+}
@@ -0,0 +1,425 @@
+/*
+ * sil_mcal.c
+ *
+ *  Host replacements for BSW/MCAL. The BSW services call these exactly as on
+ *  target; register level work is reduced to the behaviour the model needs.
+ */
+
+#include "asclin0.h"
+#include "asclin1.h"
+#include "bluetooth.h"
+#include "dflash.h"
+#include "gpt12_incr_enc.h"
+#include "gtm_atom_pwm.h"
+#include "gtm_tim_in.h"
+#include "odometry.h"
+#include "overlay.h"
+#include "perf_counter.h"
+#include "stm0.h"
+
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "sil_hal.h"
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------ASCLIN0------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+static unsigned char g_asclin0Tx[ASCLIN0_TX_BUFFER_SIZE];
+static uint32 g_asclin0TxHead;
+static uint32 g_asclin0TxTail;
+
+void asclin0InitUart(void)
+{
+    g_asclin0TxHead = 0;
+    g_asclin0TxTail = 0;
+}
+
+uint32 asclin0Write(const unsigned char *data, uint32 length)
+{
+    if (length > ASCLIN0_TX_BUFFER_SIZE - (g_asclin0TxHead - g_asclin0TxTail))
+    {
+        return 0;
+    }
+    for (uint32 i = 0; i < length; i++)
+    {
+        g_asclin0Tx[(g_asclin0TxHead + i) & (ASCLIN0_TX_BUFFER_SIZE - 1)] = data[i];
+    }
+    g_asclin0TxHead += length;
+    return length;
+}
+
+uint32 asclin0GetTxSpace(void)
+{
+    return ASCLIN0_TX_BUFFER_SIZE - (g_asclin0TxHead - g_asclin0TxTail);
+}
+
+void asclin0OutUart(const unsigned char chr)
+{
+    while (asclin0Write(&chr, 1) == 0)
+    {
+        silAdvance(silSecondsToTicks(g_silConfig.pollQuantum));
+    }
+}
+
+/* raised by the simulator between time steps; one byte whenever the line is free */
+void asclin0TxIsrHandler(void)
+{
+    if (g_asclin0TxTail != g_asclin0TxHead && silUartTxReady(SIL_UART_DEBUG))
+    {
+        silUartTx(SIL_UART_DEBUG, g_asclin0Tx[g_asclin0TxTail & (ASCLIN0_TX_BUFFER_SIZE - 1)]);
+        g_asclin0TxTail++;
+    }
+}
+
+/* the simulated receive buffer stands in for the RX ring, so the RX interrupt has nothing to do */
+int asclin0PollUart(unsigned char *chr)
+{
+    return silUartRx(SIL_UART_DEBUG, chr);
+}
+
+unsigned char asclin0InUart(void)
+{
+    unsigned char ch;
+
+    while (silUartRx(SIL_UART_DEBUG, &ch) == 0);
+
+    return ch;
+}
+
+char asclin0InUartNonBlock(void)
+{
+    unsigned char ch = 0;
+    int res = asclin0PollUart(&ch);
+
+    return res == 1 ? ch : -1;
+}
+
+uint32 asclin0GetRxDropCount(void)
+{
+    return 0;
+}
+
+void asclin0RxIsrHandler(void)
+{
+}
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------ASCLIN1------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+void asclin1InitUart(void)
+{
+}
+
+void asclin1OutUart(const unsigned char chr)
+{
+    silUartTx(SIL_UART_BLUETOOTH, chr);
+}
+
+int asclin1TxReady(void)
+{
+    return silUartTxReady(SIL_UART_BLUETOOTH);
+}
+
+int asclin1PollUart(unsigned char *chr)
+{
+    return silUartRx(SIL_UART_BLUETOOTH, chr);
+}
+
+unsigned char asclin1InUart(void)
+{
+    unsigned char ch;
+
+    while (silUartRx(SIL_UART_BLUETOOTH, &ch) == 0);
+
+    return ch;
+}
+
+/* raised by the simulator while received bytes are waiting */
+void asclin1RxIsrHandler(void)
+{
+    unsigned char ch;
+
+    while (silUartRx(SIL_UART_BLUETOOTH, &ch) != 0)
+    {
+        bluetoothIsr((char)ch);
+    }
+}
+
+/*********************************************************************************************************************/
+/*-------------------------------------------------GPT12 IncrEnc-----------------------------------------------------*/
+/*********************************************************************************************************************/
+
+/* counts follow the rolled distance of each wheel; enc_scale models a wrong wheel diameter */
+static sint32 g_encCount[ENC_WHEELS_NUM];
+
+static sint32 encCount(double path)
+{
+    double turns = path * g_silConfig.encScale / (ODOMETRY_WHEEL_DIAMETER_MM * 1e-3 * M_PI);
+    return (sint32)floor(turns * ENC_COUNTS_PER_REV);
+}
+
+void gpt12IncrEncInit(uint32 periodUs)
+{
+    (void)periodUs;
+    gpt12IncrEncUpdate();
+}
+
+void gpt12IncrEncUpdate(void)
+{
+    const SilVehicle *v = silVehicle();
+
+    g_encCount[ENC_LEFT] = encCount(v->pathLeft);
+    g_encCount[ENC_RIGHT] = encCount(v->pathRight);
+}
+
+sint32 gpt12IncrEncGetCount(EncWheel wheel)
+{
+    return g_encCount[wheel];
+}
+
+/*********************************************************************************************************************/
+/*---------------------------------------------------GTM ATOM PWM----------------------------------------------------*/
+/*********************************************************************************************************************/
+
+void gtmAtomPwmInit(void)
+{
+    silPwmSetDuty(0, 0);
+    silPwmSetDuty(1, 0);
+}
+
+void gtmAtomPwmSetDutyCycle(uint32 dutyCycle)
+{
+    (void)dutyCycle;    /* LED channel, not modelled */
+}
+
+void gtmAtomPwmASetDutyCycle(uint32 dutyCycle)
+{
+    silPwmSetDuty(0, dutyCycle);
+}
+
+void gtmAtomPwmBSetDutyCycle(uint32 dutyCycle)
+{
+    silPwmSetDuty(1, dutyCycle);
+}
+
+void gtmAtomPwmSetDutyCycleAB(uint32 dutyCycleA, uint32 dutyCycleB)
+{
+    silPwmSetDuty(0, dutyCycleA);
+    silPwmSetDuty(1, dutyCycleB);
+}
+
+/*********************************************************************************************************************/
+/*--------------------------------------------------STM0 compare tick------------------------------------------------*/
+/*********************************************************************************************************************/
+
+static uint64 g_tickPeriod = 1;
+
+void stm0InitTick(uint32 periodUs)
+{
+    g_tickPeriod = (uint64)periodUs * (SIL_TICKS_PER_SEC / 1000000);
+}
+
+/* polling the tick counter is a busy-wait like any other, so it advances time */
+uint32 stm0GetTickCount(void)
+{
+    silAdvance(silSecondsToTicks(g_silConfig.pollQuantum));
+    return (uint32)(silNow() / g_tickPeriod);
+}
+
+void stm0IsrHandler(void)
+{
+}
+
+static uint64 g_timerPeriod = 1;
+static uint64 g_timerNext;
+static Stm0Callback g_timerCallback;
+
+void stm0InitTimer(uint32 periodUs, Stm0Callback callback)
+{
+    g_timerPeriod = (uint64)periodUs * (SIL_TICKS_PER_SEC / 1000000);
+    g_timerNext = silNow() + g_timerPeriod;
+    g_timerCallback = callback;
+}
+
+/* compare 1 interrupt, called by the simulator between time steps */
+void silStm0Dispatch(void)
+{
+    if (g_timerCallback != NULL && silNow() >= g_timerNext)
+    {
+        g_timerNext += g_timerPeriod;
+        g_timerCallback();
+    }
+}
+
+void stm0TimerIsrHandler(void)
+{
+}
+
+/*********************************************************************************************************************/
+/*---------------------------------------------------GTM TIM capture-------------------------------------------------*/
+/*********************************************************************************************************************/
+
+IfxGtm_Tim_TinMap IfxGtm_TIM0_3_P02_3_IN = { 0, 3, { &MODULE_P02, 3 } };
+IfxGtm_Tim_TinMap IfxGtm_TIM0_4_P02_4_IN = { 0, 4, { &MODULE_P02, 4 } };
+IfxGtm_Tim_TinMap IfxGtm_TIM2_6_P15_3_IN = { 2, 6, { &MODULE_P15, 3 } };
+
+static IfxGtm_Tim_TinMap *g_timInPin[GTM_TIM_IN_NUM];
+static GtmTimInCallback g_timInCallback[GTM_TIM_IN_NUM];
+
+void gtmTimInInit(uint32 slot, IfxGtm_Tim_TinMap *pin, GtmTimInCallback callback)
+{
+    g_timInPin[slot] = pin;
+    g_timInCallback[slot] = callback;
+}
+
+/* plays the part of the capture interrupt of whichever slot watches the pin */
+void silTimInCapture(Ifx_P *port, uint8 pinIndex, uint32 pulse10Ns)
+{
+    for (uint32 slot = 0; slot < GTM_TIM_IN_NUM; slot++)
+    {
+        IfxGtm_Tim_TinMap *pin = g_timInPin[slot];
+        if (pin != NULL && pin->pin.port == port && pin->pin.pinIndex == pinIndex && g_timInCallback[slot] != NULL)
+        {
+            g_timInCallback[slot](slot, pulse10Ns);
+        }
+    }
+}
+
+void gtmTimIn0IsrHandler(void)
+{
+}
+
+void gtmTimIn1IsrHandler(void)
+{
+}
+
+void gtmTimIn2IsrHandler(void)
+{
+}
+
+/*********************************************************************************************************************/
+/*-------------------------------------------------------DFLASH------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+static uint8 g_dflash[DFLASH_SIZE];
+static const char *g_dflashPath = NULL;
+
+/* with a file, every episode boots from its contents and erases/writes go straight back to it */
+void silDflashSetFile(const char *path)
+{
+    g_dflashPath = path;
+}
+
+/* power-on contents: the file, erased past its end, or a fully erased bank without one */
+void silDflashReset(void)
+{
+    memset(g_dflash, 0, sizeof(g_dflash));
+    if (g_dflashPath != NULL)
+    {
+        FILE *f = fopen(g_dflashPath, "rb");
+        if (f != NULL)
+        {
+            size_t n = fread(g_dflash, 1, sizeof(g_dflash), f);
+            (void)n;
+            fclose(f);
+        }
+    }
+}
+
+static boolean dflashSync(uint32 offset, uint32 length)
+{
+    if (g_dflashPath == NULL)
+    {
+        return TRUE;
+    }
+
+    int fd = open(g_dflashPath, O_WRONLY | O_CREAT, 0644);
+    boolean ok = fd >= 0 && pwrite(fd, &g_dflash[offset], length, offset) == (ssize_t)length;
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    if (!ok)
+    {
+        perror(g_dflashPath);
+    }
+    return ok;
+}
+
+void dflashRead(uint32 offset, void *data, uint32 length)
+{
+    memcpy(data, &g_dflash[offset], length);
+}
+
+boolean dflashEraseSector(uint32 offset)
+{
+    if ((offset % DFLASH_SECTOR_SIZE) != 0 || offset >= DFLASH_SIZE)
+    {
+        return FALSE;
+    }
+    memset(&g_dflash[offset], 0, DFLASH_SECTOR_SIZE);
+    return dflashSync(offset, DFLASH_SECTOR_SIZE);
+}
+
+/* like the flash cells, programming can only set bits that are still erased (0) */
+boolean dflashWrite(uint32 offset, const void *data, uint32 length)
+{
+    const uint8 *bytes = data;
+
+    if ((offset % DFLASH_PAGE_SIZE) != 0 || (length % DFLASH_PAGE_SIZE) != 0 || offset + length > DFLASH_SIZE)
+    {
+        return FALSE;
+    }
+    for (uint32 i = 0; i < length; i++)
+    {
+        g_dflash[offset + i] |= bytes[i];
+    }
+    return dflashSync(offset, length);
+}
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------OVERLAY------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+/* no address redirection on the host: the firmware simply reads the working page */
+const volatile void *overlayMapPage(uint16 block, const volatile void *flashPage, void *ramPage, uint32 size)
+{
+    (void)block;
+    memcpy(ramPage, (const void *)flashPage, size);
+    return ramPage;
+}
+
+/*********************************************************************************************************************/
+/*---------------------------------------------------PERF COUNTERS---------------------------------------------------*/
+/*********************************************************************************************************************/
+
+void perfCounterInit(void)
+{
+}
+
+/* host time in place of CCNT: the TSC, or nanoseconds where there is none. The host has no
+ * instruction or cache event counters, so those stay 0 */
+void perfCounterRead(PerfSample *sample)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    sample->cycles = (uint32)__rdtsc();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    sample->cycles = (uint32)((uint64)ts.tv_sec * 1000000000u + (uint64)ts.tv_nsec);
+#endif
+    sample->instructions = 0;
+    memset(sample->events, 0, sizeof(sample->events));
+}
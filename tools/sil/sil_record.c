@@ -0,0 +1,95 @@
+/*
+ * sil_record.c
+ *
+ *  Reading and writing recording files, see sil_record.h.
+ */
+
+#include "sil_record.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*********************************************************************************************************************/
+/*-------------------------------------------------Type Definitions--------------------------------------------------*/
+/*********************************************************************************************************************/
+
+typedef struct
+{
+    char magic[4];
+    uint16 version;
+    uint16 entrySize;
+    uint32 count;
+    uint32 dropped;
+} SilRecordHeader;
+
+/*********************************************************************************************************************/
+/*--------------------------------------------Function Implementations-----------------------------------------------*/
+/*********************************************************************************************************************/
+
+/* the host is little-endian like the target, so headers and entries are written as they are in memory */
+int silRecordSave(const char *path, const RecordEntry *entries, uint32 count, uint32 dropped)
+{
+    SilRecordHeader header;
+    FILE *f = fopen(path, "wb");
+
+    if (f == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+    memcpy(header.magic, SIL_RECORD_MAGIC, sizeof(header.magic));
+    header.version = SIL_RECORD_VERSION;
+    header.entrySize = sizeof(RecordEntry);
+    header.count = count;
+    header.dropped = dropped;
+
+    int ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+             fwrite(entries, sizeof(RecordEntry), count, f) == count;
+    if (fclose(f) != 0 || !ok)
+    {
+        fprintf(stderr, "%s: write failed\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+/* returns a malloc'ed array of *count entries, NULL with a message on error */
+RecordEntry *silRecordLoad(const char *path, uint32 *count, uint32 *dropped)
+{
+    SilRecordHeader header;
+    RecordEntry *entries = NULL;
+    FILE *f = fopen(path, "rb");
+
+    if (f == NULL)
+    {
+        perror(path);
+        return NULL;
+    }
+    if (fread(&header, sizeof(header), 1, f) != 1 || memcmp(header.magic, SIL_RECORD_MAGIC, 4) != 0 ||
+        header.version != SIL_RECORD_VERSION || header.entrySize != sizeof(RecordEntry))
+    {
+        fprintf(stderr, "%s: not a version %d recording\n", path, SIL_RECORD_VERSION);
+        fclose(f);
+        return NULL;
+    }
+
+    entries = malloc((size_t)(header.count > 0 ? header.count : 1) * sizeof(RecordEntry));
+    if (entries == NULL || fread(entries, sizeof(RecordEntry), header.count, f) != header.count)
+    {
+        fprintf(stderr, "%s: truncated, %u entries expected\n", path, (unsigned)header.count);
+        free(entries);
+        fclose(f);
+        return NULL;
+    }
+    fclose(f);
+
+    *count = header.count;
+    *dropped = header.dropped;
+    return entries;
+}
+
+uint64 silRecordTime(const RecordEntry *entry)
+{
+    return ((uint64)entry->timeHi << 32) | entry->timeLo;
+}
@@ -0,0 +1,27 @@
+/*
+ * sil_record.h
+ *
+ *  Recording files (recorder.h) on the host. autopark_sil -r writes them
+ *  straight from the firmware's buffer, tools/pid-analyzer/pid_log.py
+ *  --record from a target dump, and autopark_replay reads them.
+ *
+ *  | "APRC" | version (LE16) | entry size (LE16) | count (LE32) | dropped (LE32) | entries |
+ *
+ *  Entries are RecordEntry, little-endian, as in the firmware buffer.
+ */
+
+#ifndef SIL_RECORD_H_
+#define SIL_RECORD_H_
+
+#include "Ifx_Types.h"
+
+#include "recorder.h"
+
+#define SIL_RECORD_MAGIC "APRC"
+#define SIL_RECORD_VERSION 1
+
+int silRecordSave(const char *path, const RecordEntry *entries, uint32 count, uint32 dropped);
+RecordEntry *silRecordLoad(const char *path, uint32 *count, uint32 *dropped);
+uint64 silRecordTime(const RecordEntry *entry);
+
+#endif /* SIL_RECORD_H_ */
@@ -0,0 +1,606 @@
+/*
+ * sil_replay.c
+ *
+ *  Runs a recording (recorder.h) back through the autopark state machine,
+ *  pd_control.c and the rest of ASW/autopark, and checks every motor command
+ *  against the recorded one. The ultrasonic, motor, encoder, STM0 and UART
+ *  drivers are replaced by the recording itself: each autoparkStep() sees the
+ *  samples the target popped in that tick, the encoder counts its odometry
+ *  integrated, and getTime10Ns() returns the tick's recorded time. Live
+ *  calibration changes and the stop command are replayed where they happened.
+ *
+ *  On the same toolchain the replay is bit-exact. A target recording goes
+ *  through the host libm, so a last-bit difference in cosf()/sqrtf() can move
+ *  a duty by one count; the first diverging tick is reported either way.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "IfxCpu.h"
+
+#include "asclin0.h"
+#include "asclin1.h"
+#include "autopark.h"
+#include "bluetooth.h"
+#include "dflash.h"
+#include "gpt12_incr_enc.h"
+#include "log.h"
+#include "motor.h"
+#include "odometry.h"
+#include "overlay.h"
+#include "param_store.h"
+#include "perf_counter.h"
+#include "stm0.h"
+#include "systeminit.h"
+#include "telemetry.h"
+#include "uart.h"
+#include "ultrasonic.h"
+
+#include "sil_episode.h"
+#include "sil_record.h"
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------Macros-------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#define REPLAY_QUEUE_SIZE 64            /* per sensor, more than the target mailbox holds */
+#define REPLAY_REPORT_MAX 10            /* mismatches printed in full */
+
+/*********************************************************************************************************************/
+/*-------------------------------------------------Type Definitions--------------------------------------------------*/
+/*********************************************************************************************************************/
+
+typedef struct
+{
+    UltSample samples[REPLAY_QUEUE_SIZE];
+    uint32 head;
+    uint32 tail;
+} ReplayQueue;
+
+/*********************************************************************************************************************/
+/*--------------------------------------------Private Variables/Constants--------------------------------------------*/
+/*********************************************************************************************************************/
+
+static uint64 g_now;                    /* getTime10Ns() for the current segment */
+static uint64 g_start;                  /* time of the first entry */
+static uint32 g_tick;                   /* autoparkStep() calls so far */
+static Ifx_STM g_stm0;
+static sint32 g_encCount[ENC_WHEELS_NUM];
+static ReplayQueue g_ultQueue[ULT_SENSORS_NUM];
+static int g_verbose;
+
+/* recorded motor commands of the current segment, in order */
+static const RecordEntry *g_expected[RECORDER_ENTRIES];
+static uint32 g_expectedCount;
+static uint32 g_expectedNext;
+
+static uint32 g_commands;
+static uint32 g_mismatches;
+static uint32 g_firstMismatchTick;
+static FILE *g_csv;
+
+static SilTunables g_overrides;
+
+/*********************************************************************************************************************/
+/*--------------------------------------------Function Implementations-----------------------------------------------*/
+/*********************************************************************************************************************/
+
+static double seconds(uint64 time)
+{
+    return (double)(time - g_start) * 1e-8;
+}
+
+static void mismatch(const char *what, const RecordEntry *expected, int dutyA, int dutyB, uint8 bits)
+{
+    if (g_mismatches++ == 0)
+    {
+        g_firstMismatchTick = g_tick;
+    }
+    if (g_mismatches > REPLAY_REPORT_MAX)
+    {
+        return;
+    }
+    printf("tick %u (%.2f s, state %d): %s", (unsigned)g_tick, seconds(g_now), (int)autoparkGetState(), what);
+    if (expected != NULL)
+    {
+        printf(", recorded A %d B %d bits %d", (int)expected->a, (int)expected->b, expected->channel);
+    }
+    if (bits != 0xFF)
+    {
+        printf(", replayed A %d B %d bits %d", dutyA, dutyB, bits);
+    }
+    printf("\n");
+}
+
+/* every motor command of the replayed firmware ends up here */
+static void replayMotor(int dutyA, int dirA, int dutyB, int dirB, boolean brake)
+{
+    uint8 bits = (uint8)((dirA ? RECORD_MOTOR_DIR_A : 0) | (dirB ? RECORD_MOTOR_DIR_B : 0) |
+                         (brake ? RECORD_MOTOR_BRAKE : 0));
+    const RecordEntry *e = (g_expectedNext < g_expectedCount) ? g_expected[g_expectedNext++] : NULL;
+
+    g_commands++;
+    if (g_csv != NULL)
+    {
+        fprintf(g_csv, "%u,%.3f,%d,", (unsigned)g_tick, seconds(g_now), (int)autoparkGetState());
+        if (e != NULL)
+        {
+            fprintf(g_csv, "%d,%d,%d,", (int)e->a, (int)e->b, e->channel);
+        }
+        else
+        {
+            fprintf(g_csv, ",,,");
+        }
+        fprintf(g_csv, "%d,%d,%d\n", dutyA, dutyB, bits);
+    }
+
+    if (e == NULL)
+    {
+        mismatch("extra command", NULL, dutyA, dutyB, bits);
+    }
+    else if (e->a != dutyA || e->b != dutyB || e->channel != bits)
+    {
+        mismatch("different command", e, dutyA, dutyB, bits);
+    }
+}
+
+static void pushSample(const RecordEntry *e)
+{
+    ReplayQueue *q;
+
+    if (e->channel >= ULT_SENSORS_NUM)
+    {
+        return;
+    }
+    q = &g_ultQueue[e->channel];
+    if (q->head - q->tail == REPLAY_QUEUE_SIZE)
+    {
+        return;
+    }
+    q->samples[q->head % REPLAY_QUEUE_SIZE].distance = e->a;
+    q->samples[q->head % REPLAY_QUEUE_SIZE].time = silRecordTime(e);
+    q->head++;
+}
+
+static float32 entryFloat(sint32 bits)
+{
+    float32 value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static int tunableExists(const char *name)
+{
+    const char *known;
+
+    for (uint32 i = 0; (known = autoparkGetParamName(i)) != NULL; i++)
+    {
+        if (strcmp(known, name) == 0)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int overridden(const char *name)
+{
+    for (int i = 0; i < g_overrides.count; i++)
+    {
+        if (strcmp(g_overrides.names[i], name) == 0)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* a segment is a TICK or start COMMAND entry and the inputs and outputs recorded after it */
+static int segmentEnds(const RecordEntry *e)
+{
+    return e->type == RECORD_TICK || e->type == RECORD_PARAM || e->type == RECORD_POSE ||
+           (e->type == RECORD_COMMAND && e->channel != 's');
+}
+
+static uint32 replaySegment(const RecordEntry *entries, uint32 index, uint32 count)
+{
+    const RecordEntry *head = &entries[index];
+    boolean stop = FALSE;
+    uint32 end = index + 1;
+
+    g_expectedCount = 0;
+    g_expectedNext = 0;
+    for (; end < count && !segmentEnds(&entries[end]); end++)
+    {
+        const RecordEntry *e = &entries[end];
+        switch (e->type)
+        {
+        case RECORD_ULTRA:
+            pushSample(e);
+            break;
+        case RECORD_ENCODER:
+            g_encCount[ENC_LEFT] += e->a;
+            g_encCount[ENC_RIGHT] += e->b;
+            break;
+        case RECORD_MOTOR:
+            g_expected[g_expectedCount++] = e;
+            break;
+        case RECORD_COMMAND:
+            stop = TRUE;
+            break;
+        default:
+            break;
+        }
+    }
+
+    g_now = silRecordTime(head);
+    if (head->type == RECORD_TICK)
+    {
+        g_tick++;
+        if (head->channel != (uint8)autoparkGetState())
+        {
+            char what[48];
+            snprintf(what, sizeof(what), "state %d recorded", head->channel);
+            mismatch(what, NULL, 0, 0, 0xFF);
+        }
+        autoparkStep();
+    }
+    else if (head->channel == 'p')
+    {
+        autoparkStart();
+    }
+
+    /* an abort from inside the step already happened in the replay too */
+    if (stop && autoparkGetState() != AUTOPARK_IDLE)
+    {
+        autoparkAbort();
+    }
+    while (g_expectedNext < g_expectedCount)
+    {
+        mismatch("missing command", g_expected[g_expectedNext++], 0, 0, 0xFF);
+    }
+    if (g_verbose)
+    {
+        bluetoothPump();
+        uartPump();
+        logPump();
+    }
+    return end;
+}
+
+static void replay(const RecordEntry *entries, uint32 count)
+{
+    float32 pose[4] = { 0 };
+
+    for (int i = 0; i < g_overrides.count; i++)
+    {
+        autoparkSetParam(g_overrides.names[i], (float32)g_overrides.values[i]);
+    }
+
+    for (uint32 i = 0; i < count;)
+    {
+        const RecordEntry *e = &entries[i];
+
+        if (e->type == RECORD_PARAM)
+        {
+            const char *name = autoparkGetParamName(e->channel);
+            if (name != NULL && !overridden(name))
+            {
+                autoparkSetParam(name, entryFloat(e->a));
+            }
+            i++;
+        }
+        else if (e->type == RECORD_POSE)
+        {
+            pose[(e->channel & 1) * 2] = entryFloat(e->a);
+            pose[(e->channel & 1) * 2 + 1] = entryFloat(e->b);
+            if (e->channel == 1)
+            {
+                OdometryPose start = { pose[0], pose[1], pose[2], pose[3] };
+                odometrySetPose(&start);
+            }
+            i++;
+        }
+        else if (e->type == RECORD_TICK || e->type == RECORD_COMMAND)
+        {
+            i = replaySegment(entries, i, count);
+        }
+        else
+        {
+            i++;        /* inputs before the first segment */
+        }
+    }
+}
+
+static double wallClock(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+static void usage(const char *argv0)
+{
+    printf("usage: %s [options] RECORDING\n"
+           "  -t NAME=VAL   replay with a different tunable (recorded changes to it are ignored)\n"
+           "  -o FILE       write every motor command as CSV, recorded next to replayed\n"
+           "  -v            echo the firmware's UART output (bluetooth on stdout, debug on stderr)\n",
+           argv0);
+}
+
+int main(int argc, char **argv)
+{
+    const char *csvPath = NULL;
+    uint32 count, dropped;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "t:o:vh")) != -1)
+    {
+        switch (opt)
+        {
+        case 't':
+        {
+            char *eq = strchr(optarg, '=');
+            if (eq == NULL || g_overrides.count == SIL_TUNABLES_MAX) { usage(argv[0]); return 2; }
+            *eq = '\0';
+            if (!tunableExists(optarg))
+            {
+                fprintf(stderr, "unknown tunable '%s'\n", optarg);
+                return 2;
+            }
+            g_overrides.names[g_overrides.count] = optarg;
+            g_overrides.values[g_overrides.count++] = atof(eq + 1);
+            break;
+        }
+        case 'o':
+            csvPath = optarg;
+            break;
+        case 'v':
+            g_verbose = 1;
+            break;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (optind != argc - 1)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    RecordEntry *entries = silRecordLoad(argv[optind], &count, &dropped);
+    if (entries == NULL)
+    {
+        return 2;
+    }
+    if (count == 0)
+    {
+        fprintf(stderr, "%s: empty recording\n", argv[optind]);
+        return 2;
+    }
+    if (dropped > 0)
+    {
+        /* the last tick lost some of its entries, so it cannot be compared */
+        printf("# recording is %u entries short, the replay stops at its last complete tick\n", (unsigned)dropped);
+        while (count > 0 && entries[count - 1].type != RECORD_TICK)
+        {
+            count--;
+        }
+        if (count > 0)
+        {
+            count--;
+        }
+    }
+    if (csvPath != NULL)
+    {
+        g_csv = fopen(csvPath, "w");
+        if (g_csv == NULL)
+        {
+            perror(csvPath);
+            return 2;
+        }
+        fprintf(g_csv, "tick,time_s,state,rec_a,rec_b,rec_bits,replay_a,replay_b,replay_bits\n");
+    }
+
+    g_start = silRecordTime(&entries[0]);
+    g_now = g_start;
+    odometryInit(CONTROL_PERIOD_US);
+    telemetryInit();
+    paramStoreInit();
+    autoparkInit();
+
+    double t0 = wallClock();
+    replay(entries, count);
+    double elapsed = wallClock() - t0;
+
+    if (g_mismatches > REPLAY_REPORT_MAX)
+    {
+        printf("... %u more\n", (unsigned)(g_mismatches - REPLAY_REPORT_MAX));
+    }
+    printf("# %u entries, %u ticks (%.2f s), %u motor commands, %u mismatches", (unsigned)count,
+           (unsigned)g_tick, seconds(g_now), (unsigned)g_commands, (unsigned)g_mismatches);
+    if (g_mismatches > 0)
+    {
+        printf(" from tick %u", (unsigned)g_firstMismatchTick);
+    }
+    printf(", %.2f us per tick\n", g_tick > 0 ? elapsed * 1e6 / g_tick : 0.0);
+
+    if (g_csv != NULL)
+    {
+        fclose(g_csv);
+    }
+    free(entries);
+    return g_mismatches == 0 ? 0 : 1;
+}
+
+/*********************************************************************************************************************/
+/*----------------------------------------Drivers served from the recording------------------------------------------*/
+/*********************************************************************************************************************/
+
+Ifx_STM *silStm0Access(void)
+{
+    g_stm0.TIM0.U = (uint32)g_now;
+    g_stm0.CAP.U = (uint32)(g_now >> 32);
+    return &g_stm0;
+}
+
+uint32 stm0GetTickCount(void)
+{
+    return g_tick;
+}
+
+void gpt12IncrEncInit(uint32 periodUs)
+{
+    (void)periodUs;
+}
+
+void gpt12IncrEncUpdate(void)
+{
+}
+
+sint32 gpt12IncrEncGetCount(EncWheel wheel)
+{
+    return g_encCount[wheel];
+}
+
+boolean ultrasonicPop(UltraDir dir, UltSample *sample)
+{
+    ReplayQueue *q = &g_ultQueue[dir];
+
+    if (q->head == q->tail)
+    {
+        return FALSE;
+    }
+    *sample = q->samples[q->tail++ % REPLAY_QUEUE_SIZE];
+    return TRUE;
+}
+
+boolean ultrasonicGetLatest(UltraDir dir, UltSample *sample)
+{
+    boolean found = FALSE;
+
+    while (ultrasonicPop(dir, sample))
+    {
+        found = TRUE;
+    }
+    return found;
+}
+
+int getDistanceByUltra(UltraDir dir)
+{
+    UltSample sample;
+
+    return ultrasonicPop(dir, &sample) ? sample.distance : -1;
+}
+
+void motorMovPwm(int dutyA, int dirA, int dutyB, int dirB)
+{
+    replayMotor(dutyA, dirA, dutyB, dirB, FALSE);
+}
+
+void motorMoveForward(int duty)
+{
+    replayMotor(duty, 1, duty, 1, FALSE);
+}
+
+void motorMoveReverse(int duty)
+{
+    replayMotor(duty, 0, duty, 0, FALSE);
+}
+
+void motorStop(void)
+{
+    replayMotor(0, 0, 0, 0, TRUE);
+}
+
+/* nothing is stored: parameters come from the recording */
+void dflashRead(uint32 offset, void *data, uint32 length)
+{
+    (void)offset;
+    memset(data, 0, length);
+}
+
+boolean dflashEraseSector(uint32 offset)
+{
+    (void)offset;
+    return FALSE;
+}
+
+boolean dflashWrite(uint32 offset, const void *data, uint32 length)
+{
+    (void)offset;
+    (void)data;
+    (void)length;
+    return FALSE;
+}
+
+const volatile void *overlayMapPage(uint16 block, const volatile void *flashPage, void *ramPage, uint32 size)
+{
+    (void)block;
+    memcpy(ramPage, (const void *)flashPage, size);
+    return ramPage;
+}
+
+/* one thread, no interrupts to hold back */
+boolean IfxCpu_disableInterrupts(void)
+{
+    return TRUE;
+}
+
+void IfxCpu_restoreInterrupts(boolean enabled)
+{
+    (void)enabled;
+}
+
+/* the replay measures nothing */
+void perfCounterInit(void)
+{
+}
+
+void perfCounterRead(PerfSample *sample)
+{
+    memset(sample, 0, sizeof(*sample));
+}
+
+void asclin0InitUart(void)
+{
+}
+
+uint32 asclin0Write(const unsigned char *data, uint32 length)
+{
+    if (g_verbose)
+    {
+        fwrite(data, 1, length, stderr);
+    }
+    return length;
+}
+
+uint32 asclin0GetTxSpace(void)
+{
+    return ASCLIN0_TX_BUFFER_SIZE;
+}
+
+int asclin0PollUart(unsigned char *chr)
+{
+    (void)chr;
+    return 0;
+}
+
+void asclin1InitUart(void)
+{
+}
+
+void asclin1OutUart(const unsigned char chr)
+{
+    putchar(chr);
+}
+
+int asclin1TxReady(void)
+{
+    return 1;
+}
@@ -0,0 +1,543 @@
+/*
+ * sil_sweep.c
+ *
+ *  Searches the firmware tunables (autoparkSetParam() names) against the
+ *  simulated world, either over a grid or with Nelder-Mead, and prints the
+ *  parameter sets ranked by parking rate, then distance from the bay centre,
+ *  then manoeuvre time. Every set runs the same seeds, so sets are compared on
+ *  identical start poses and sensor noise. All episodes of a batch go through
+ *  one pool of forked workers, so a grid keeps every host core busy; a
+ *  Nelder-Mead step is one set, so use at least as many episodes per set as
+ *  there are cores.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "sil_config.h"
+#include "sil_episode.h"
+
+#include "autopark.h"
+
+/*********************************************************************************************************************/
+/*------------------------------------------------------Macros-------------------------------------------------------*/
+/*********************************************************************************************************************/
+
+#define SWEEP_VALUES_MAX 64
+
+/* Nelder-Mead cost: each percent of failed episodes outweighs 100 mm of bay error;
+ * one second of manoeuvre time counts like 1 mm */
+#define SWEEP_FAIL_COST 10000.0
+#define SWEEP_TIME_COST 1.0
+
+/*********************************************************************************************************************/
+/*-------------------------------------------------Type Definitions--------------------------------------------------*/
+/*********************************************************************************************************************/
+
+typedef struct
+{
+    const char *name;
+    double values[SWEEP_VALUES_MAX];    /* grid values; values[0] / [count - 1] bound Nelder-Mead */
+    int count;
+} SweepAxis;
+
+typedef struct
+{
+    double values[SIL_TUNABLES_MAX];    /* one per axis */
+    double parked;                      /* fraction of episodes */
+    double bayMm;                       /* mean over parked episodes, NAN if none */
+    double headingDeg;
+    double maneuverS;
+    double cost;
+} SweepSet;
+
+/*********************************************************************************************************************/
+/*--------------------------------------------Private Variables/Constants--------------------------------------------*/
+/*********************************************************************************************************************/
+
+static SweepAxis g_axes[SIL_TUNABLES_MAX];
+static int g_axisNum = 0;
+static SilTunables g_fixed = { 0 };
+
+static int g_episodes = 32;
+static uint64 g_baseSeed = 1;
+static long g_jobs = 1;
+static const char *g_tuneInput = NULL;
+
+static SweepSet *g_sets = NULL;         /* every set evaluated so far */
+static int g_setNum = 0;
+static int g_setCap = 0;
+static long g_episodesRun = 0;
+
+/*********************************************************************************************************************/
+/*--------------------------------------------Function Implementations-----------------------------------------------*/
+/*********************************************************************************************************************/
+
+static double wallClock(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+/* NAME=LO:HI:STEPS or NAME=V1,V2,... */
+static int parseAxis(char *arg)
+{
+    char *eq = strchr(arg, '=');
+    SweepAxis *axis = &g_axes[g_axisNum];
+
+    if (eq == NULL || g_axisNum + g_fixed.count >= SIL_TUNABLES_MAX)
+    {
+        return -1;
+    }
+    *eq = '\0';
+    if (!silTunableExists(arg))
+    {
+        fprintf(stderr, "unknown tunable '%s'\n", arg);
+        return -1;
+    }
+    axis->name = arg;
+    axis->count = 0;
+
+    double lo, hi;
+    int steps;
+    if (strchr(eq + 1, ':') != NULL)
+    {
+        if (sscanf(eq + 1, "%lf:%lf:%d", &lo, &hi, &steps) < 2)
+        {
+            return -1;
+        }
+        if (strchr(strchr(eq + 1, ':') + 1, ':') == NULL)
+        {
+            steps = 2;
+        }
+        if (steps < 1 || steps > SWEEP_VALUES_MAX)
+        {
+            return -1;
+        }
+        for (int i = 0; i < steps; i++)
+        {
+            axis->values[axis->count++] = (steps == 1) ? lo : lo + (hi - lo) * i / (steps - 1);
+        }
+    }
+    else
+    {
+        for (char *tok = strtok(eq + 1, ","); tok != NULL && axis->count < SWEEP_VALUES_MAX; tok = strtok(NULL, ","))
+        {
+            axis->values[axis->count++] = atof(tok);
+        }
+    }
+
+    if (axis->count == 0)
+    {
+        return -1;
+    }
+    for (int i = 0; i < axis->count; i++)
+    {
+        if (!silTunableInRange(arg, axis->values[i]))
+        {
+            return -1;
+        }
+    }
+    g_axisNum++;
+    return 0;
+}
+
+static SweepSet *newSet(void)
+{
+    if (g_setNum == g_setCap)
+    {
+        g_setCap = (g_setCap == 0) ? 256 : g_setCap * 2;
+        g_sets = realloc(g_sets, (size_t)g_setCap * sizeof(SweepSet));
+    }
+    memset(&g_sets[g_setNum], 0, sizeof(SweepSet));
+    return &g_sets[g_setNum++];
+}
+
+/* Runs g_episodes seeds for each of sets[0..count-1] in one worker pool and fills in the scores */
+static void evaluate(const SilConfig *cfg, SweepSet *sets, int count)
+{
+    int total = count * g_episodes;
+    SilTunables *tunables = calloc((size_t)count, sizeof(SilTunables));
+    SilEpisode *runs = calloc((size_t)total, sizeof(SilEpisode));
+    SilResult *results = calloc((size_t)total, sizeof(SilResult));
+
+    for (int s = 0; s < count; s++)
+    {
+        tunables[s] = g_fixed;
+        for (int a = 0; a < g_axisNum; a++)
+        {
+            tunables[s].names[tunables[s].count] = g_axes[a].name;
+            tunables[s].values[tunables[s].count++] = sets[s].values[a];
+        }
+        for (int e = 0; e < g_episodes; e++)
+        {
+            SilEpisode *run = &runs[s * g_episodes + e];
+            run->seed = g_baseSeed + (uint64)e;
+            run->tuneInput = g_tuneInput;
+            run->abortAt = -1.0;
+            run->tunables = &tunables[s];
+        }
+    }
+
+    silRunEpisodes(cfg, runs, total, g_jobs, results);
+    g_episodesRun += total;
+
+    for (int s = 0; s < count; s++)
+    {
+        SweepSet *set = &sets[s];
+        int parked = 0;
+        double bay = 0.0, heading = 0.0, time = 0.0;
+
+        for (int e = 0; e < g_episodes; e++)
+        {
+            const SilResult *r = &results[s * g_episodes + e];
+            if (r->code == SIL_RESULT_PARKED)
+            {
+                parked++;
+                bay += r->bayError * 1000.0;
+                heading += r->headingError;
+                time += r->maneuverTime;
+            }
+        }
+        set->parked = (double)parked / g_episodes;
+        set->bayMm = parked ? bay / parked : NAN;
+        set->headingDeg = parked ? heading / parked : NAN;
+        set->maneuverS = parked ? time / parked : NAN;
+        set->cost = SWEEP_FAIL_COST * (1.0 - set->parked) +
+                    (parked ? set->bayMm + SWEEP_TIME_COST * set->maneuverS : 0.0);
+    }
+
+    free(tunables);
+    free(runs);
+    free(results);
+}
+
+static void runGrid(const SilConfig *cfg)
+{
+    int total = 1;
+    for (int a = 0; a < g_axisNum; a++)
+    {
+        total *= g_axes[a].count;
+    }
+
+    int first = g_setNum;
+    for (int i = 0; i < total; i++)
+    {
+        SweepSet *set = newSet();
+        int k = i;
+        for (int a = g_axisNum - 1; a >= 0; a--)
+        {
+            set->values[a] = g_axes[a].values[k % g_axes[a].count];
+            k /= g_axes[a].count;
+        }
+    }
+    evaluate(cfg, &g_sets[first], total);
+}
+
+/*------------------------------------------------- Nelder-Mead ------------------------------------------------*/
+
+/* Points live in the unit box; u = 0 / 1 is the first / last value given for the axis */
+static double axisValue(int a, double u)
+{
+    const SweepAxis *axis = &g_axes[a];
+    double lo = axis->values[0];
+    double hi = axis->values[axis->count - 1];
+
+    u = (u < 0.0) ? 0.0 : ((u > 1.0) ? 1.0 : u);
+    return lo + (hi - lo) * u;
+}
+
+/* Evaluates count points at once and returns their costs */
+static void nmEvaluate(const SilConfig *cfg, double points[][SIL_TUNABLES_MAX], int count, double *costs)
+{
+    int first = g_setNum;
+
+    for (int i = 0; i < count; i++)
+    {
+        SweepSet *set = newSet();
+        for (int a = 0; a < g_axisNum; a++)
+        {
+            set->values[a] = axisValue(a, points[i][a]);
+        }
+    }
+    evaluate(cfg, &g_sets[first], count);
+    for (int i = 0; i < count; i++)
+    {
+        costs[i] = g_sets[first + i].cost;
+    }
+}
+
+static void nmPoint(double *out, const double *centroid, const double *worst, double t)
+{
+    for (int a = 0; a < g_axisNum; a++)
+    {
+        double u = centroid[a] + t * (worst[a] - centroid[a]);
+        out[a] = (u < 0.0) ? 0.0 : ((u > 1.0) ? 1.0 : u);
+    }
+}
+
+static void runNelderMead(const SilConfig *cfg, int iterations)
+{
+    int n = g_axisNum;
+    double simplex[SIL_TUNABLES_MAX + 1][SIL_TUNABLES_MAX];
+    double costs[SIL_TUNABLES_MAX + 1];
+    double trial[2][SIL_TUNABLES_MAX];
+    double trialCost[2];
+
+    /* start in the middle of the box, one vertex a quarter of the range along each axis */
+    for (int v = 0; v <= n; v++)
+    {
+        for (int a = 0; a < n; a++)
+        {
+            simplex[v][a] = 0.5 + ((v == a + 1) ? 0.25 : 0.0);
+        }
+    }
+    nmEvaluate(cfg, simplex, n + 1, costs);
+
+    for (int it = 0; it < iterations; it++)
+    {
+        /* order the vertices by cost */
+        for (int i = 1; i <= n; i++)
+        {
+            for (int j = i; j > 0 && costs[j] < costs[j - 1]; j--)
+            {
+                double c = costs[j];
+                costs[j] = costs[j - 1];
+                costs[j - 1] = c;
+                for (int a = 0; a < n; a++)
+                {
+                    double u = simplex[j][a];
+                    simplex[j][a] = simplex[j - 1][a];
+                    simplex[j - 1][a] = u;
+                }
+            }
+        }
+
+        double centroid[SIL_TUNABLES_MAX] = { 0 };
+        for (int v = 0; v < n; v++)
+        {
+            for (int a = 0; a < n; a++)
+            {
+                centroid[a] += simplex[v][a] / n;
+            }
+        }
+
+        /* reflect */
+        nmPoint(trial[0], centroid, simplex[n], -1.0);
+        nmEvaluate(cfg, &trial[0], 1, &trialCost[0]);
+
+        if (trialCost[0] < costs[0])
+        {
+            /* expand */
+            nmPoint(trial[1], centroid, simplex[n], -2.0);
+            nmEvaluate(cfg, &trial[1], 1, &trialCost[1]);
+            int pick = (trialCost[1] < trialCost[0]) ? 1 : 0;
+            memcpy(simplex[n], trial[pick], sizeof(simplex[n]));
+            costs[n] = trialCost[pick];
+        }
+        else if (trialCost[0] < costs[n - 1])
+        {
+            memcpy(simplex[n], trial[0], sizeof(simplex[n]));
+            costs[n] = trialCost[0];
+        }
+        else
+        {
+            /* contract towards the better of the worst vertex and its reflection */
+            boolean outside = trialCost[0] < costs[n];
+            nmPoint(trial[1], centroid, simplex[n], outside ? -0.5 : 0.5);
+            nmEvaluate(cfg, &trial[1], 1, &trialCost[1]);
+            if (trialCost[1] < (outside ? trialCost[0] : costs[n]))
+            {
+                memcpy(simplex[n], trial[1], sizeof(simplex[n]));
+                costs[n] = trialCost[1];
+            }
+            else
+            {
+                /* shrink towards the best vertex, all new vertices in one batch */
+                for (int v = 1; v <= n; v++)
+                {
+                    for (int a = 0; a < n; a++)
+                    {
+                        simplex[v][a] = simplex[0][a] + 0.5 * (simplex[v][a] - simplex[0][a]);
+                    }
+                }
+                nmEvaluate(cfg, &simplex[1], n, &costs[1]);
+            }
+        }
+        fprintf(stderr, "# iteration %d: best cost %.1f\n", it + 1, costs[0]);
+    }
+}
+
+/*----------------------------------------------------- Report -------------------------------------------------*/
+
+/* parking rate first, then distance from the bay centre, then manoeuvre time */
+static int compareSets(const void *pa, const void *pb)
+{
+    const SweepSet *a = pa;
+    const SweepSet *b = pb;
+
+    if (a->parked != b->parked) return (a->parked > b->parked) ? -1 : 1;
+    if (a->parked == 0.0) return 0;
+    if (a->bayMm != b->bayMm) return (a->bayMm < b->bayMm) ? -1 : 1;
+    if (a->maneuverS != b->maneuverS) return (a->maneuverS < b->maneuverS) ? -1 : 1;
+    return 0;
+}
+
+static void printRanking(int top)
+{
+    qsort(g_sets, (size_t)g_setNum, sizeof(SweepSet), compareSets);
+
+    printf("rank");
+    for (int a = 0; a < g_axisNum; a++)
+    {
+        printf(",%s", g_axes[a].name);
+    }
+    printf(",parked_pct,bay_mm,heading_deg,maneuver_s\n");
+
+    for (int i = 0; i < g_setNum && i < top; i++)
+    {
+        const SweepSet *set = &g_sets[i];
+        printf("%d", i + 1);
+        for (int a = 0; a < g_axisNum; a++)
+        {
+            printf(",%g", set->values[a]);
+        }
+        printf(",%.1f,%.1f,%.1f,%.2f\n", set->parked * 100.0, set->bayMm, set->headingDeg, set->maneuverS);
+    }
+
+    if (g_setNum > 0)
+    {
+        printf("# best:");
+        for (int i = 0; i < g_fixed.count; i++)
+        {
+            printf(" -t %s=%g", g_fixed.names[i], g_fixed.values[i]);
+        }
+        for (int a = 0; a < g_axisNum; a++)
+        {
+            printf(" -t %s=%g", g_axes[a].name, g_sets[0].values[a]);
+        }
+        printf("\n");
+    }
+}
+
+static void usage(const char *argv0)
+{
+    printf("usage: %s [options] -a NAME=LO:HI:STEPS ...\n"
+           "  -a NAME=LO:HI:STEPS  axis over a firmware tunable, STEPS values from LO to HI\n"
+           "  -a NAME=V1,V2,...    axis with explicit values\n"
+           "  -m ITER              Nelder-Mead for ITER iterations inside each axis' first..last value\n"
+           "                       instead of the grid\n"
+           "  -t NAME=VAL          tunable fixed for every set\n"
+           "  -n N                 episodes per set (default 32), the same seeds for every set\n"
+           "  -s SEED              base seed (default 1)\n"
+           "  -j N                 parallel episodes (default: online cores)\n"
+           "  -c FILE              load world parameters / extra walls from FILE\n"
+           "  -p NAME=VAL          override one world parameter\n"
+           "  -i INPUT             tuning session typed before every episode, as for autopark_sil\n"
+           "  -k N                 print the best N sets (default 20)\n"
+           "  -l                   list the tunables and exit\n", argv0);
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = 0;
+    int top = 20;
+    int opt;
+
+    g_jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    silConfigInit(&g_silConfig);
+
+    while ((opt = getopt(argc, argv, "a:m:t:n:s:j:c:p:i:k:lh")) != -1)
+    {
+        switch (opt)
+        {
+        case 'a':
+            if (parseAxis(optarg) != 0) { usage(argv[0]); return 2; }
+            break;
+        case 'm':
+            iterations = atoi(optarg);
+            break;
+        case 't':
+        {
+            char *eq = strchr(optarg, '=');
+            if (eq == NULL || g_axisNum + g_fixed.count >= SIL_TUNABLES_MAX) { usage(argv[0]); return 2; }
+            *eq = '\0';
+            if (!silTunableExists(optarg))
+            {
+                fprintf(stderr, "unknown tunable '%s'\n", optarg);
+                return 2;
+            }
+            g_fixed.names[g_fixed.count] = optarg;
+            g_fixed.values[g_fixed.count] = atof(eq + 1);
+            if (!silTunableInRange(optarg, g_fixed.values[g_fixed.count++])) return 2;
+            break;
+        }
+        case 'n':
+            g_episodes = atoi(optarg);
+            break;
+        case 's':
+            g_baseSeed = strtoull(optarg, NULL, 0);
+            break;
+        case 'j':
+            g_jobs = atol(optarg);
+            break;
+        case 'c':
+            if (silConfigLoad(&g_silConfig, optarg) != 0) return 2;
+            break;
+        case 'p':
+        {
+            char *eq = strchr(optarg, '=');
+            if (eq == NULL) { usage(argv[0]); return 2; }
+            *eq = '\0';
+            if (silConfigSet(&g_silConfig, optarg, eq + 1) != 0) return 2;
+            break;
+        }
+        case 'i':
+            g_tuneInput = optarg;
+            break;
+        case 'k':
+            top = atoi(optarg);
+            break;
+        case 'l':
+            for (uint32 i = 0; autoparkGetParamName(i) != NULL; i++)
+            {
+                printf("  %s\n", autoparkGetParamName(i));
+            }
+            return 0;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if (g_axisNum == 0)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+    if (g_jobs < 1) g_jobs = 1;
+    if (g_episodes < 1) g_episodes = 1;
+
+    double t0 = wallClock();
+    if (iterations > 0)
+    {
+        runNelderMead(&g_silConfig, iterations);
+    }
+    else
+    {
+        runGrid(&g_silConfig);
+    }
+    double elapsed = wallClock() - t0;
+
+    printRanking(top);
+    printf("# %d sets x %d episodes, %.2f s wall, %.0f episodes/min, %ld jobs\n",
+           g_setNum, g_episodes, elapsed, g_episodesRun / elapsed * 60.0, g_jobs);
+
+    free(g_sets);
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include "sil_vehicle.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "gtm_atom_pwm.h"
+
+/*********************************************************************************************************************/
+/*--------------------------------------------Function Implementations-----------------------------------------------*/
+/*********************************************************************************************************************/
+
+static double wheelTarget(const SilConfig *cfg, const SilWheelCmd *cmd)
+{
+    double duty = cmd->duty;
+
+    if (cmd->brake)
+    {
+        return 0.0;
+    }
+    if (duty > PWM_PERIOD)
+    {
+        duty = PWM_PERIOD;
+    }
+    if (duty <= cfg->dutyDeadband)
+    {
+        return 0.0;
+    }
+
+    double v = cfg->wheelVmax * (duty - cfg->dutyDeadband) / (PWM_PERIOD - cfg->dutyDeadband);
+    return cmd->forward ? v : -v;
+}
+
+static double wheelLag(double v, double target, double tau, double dt)
+{
+    if (tau <= 0.0)
+    {
+        return target;
+    }
+    return v + (target - v) * (1.0 - exp(-dt / tau));
+}
+
+void silVehicleReset(SilVehicle *v, const SilPose *start)
+{
+    memset(v, 0, sizeof(*v));
+    v->pose = *start;
+}
+
+void silVehicleStep(SilVehicle *v, const SilConfig *cfg, const SilWorld *w,
+                    const SilWheelCmd *left, const SilWheelCmd *right, double dt)
+{
+    if (v->collided)
+    {
+        return;
+    }
+
+    double tl = wheelTarget(cfg, left);
+    double tr = wheelTarget(cfg, right);
+    v->vLeft = wheelLag(v->vLeft, tl, left->brake ? cfg->brakeTau : cfg->motorTau, dt);
+    v->vRight = wheelLag(v->vRight, tr, right->brake ? cfg->brakeTau : cfg->motorTau, dt);
+
+    double lin = (v->vLeft + v->vRight) / 2.0;
+    double ang = (v->vRight - v->vLeft) / cfg->track;
+    double mid = v->pose.theta + ang * dt / 2.0;
+
+    SilPose next = v->pose;
+    next.x += lin * cos(mid) * dt;
+    next.y += lin * sin(mid) * dt;
+    next.theta += ang * dt;
+
+    double corners[4][2];
+    silFootprint(cfg, &next, corners);
+    if (silWorldCollides(w, corners))
+    {
+        v->collided = 1;
+        v->vLeft = 0.0;
+        v->vRight = 0.0;
+        return;
+    }
+
+    v->pose = next;
+    v->travelled += fabs(lin) * dt;
+    v->pathLeft += v->vLeft * dt;
+    v->pathRight += v->vRight * dt;
+}
@@ -0,0 +1,36 @@
+/*
+ * sil_vehicle.h
+ *
+ *  Differential drive kinematics with a first order wheel speed lag.
+ *  Wheel A of motor.c is the left wheel, wheel B the right one.
+ */
+
+#ifndef SIL_VEHICLE_H_
+#define SIL_VEHICLE_H_
+
+#include "sil_config.h"
+#include "sil_world.h"
+
+typedef struct
+{
+    int duty;       /* 0 .. PWM_PERIOD */
+    int forward;    /* direction pin */
+    int brake;      /* brake pin */
+} SilWheelCmd;
+
+typedef struct
+{
+    SilPose pose;
+    double vLeft;
+    double vRight;
+    double travelled;   /* path length of the centre point */
+    double pathLeft;    /* signed distance rolled by each wheel, read by the encoder model */
+    double pathRight;
+    int collided;
+} SilVehicle;
+
+void silVehicleReset(SilVehicle *v, const SilPose *start);
+void silVehicleStep(SilVehicle *v, const SilConfig *cfg, const SilWorld *w,
+                    const SilWheelCmd *left, const SilWheelCmd *right, double dt);
+
+#endif /* SIL_VEHICLE_H_ */
@@ -0,0 +1,119 @@
+#include "sil_world.h"
+
+#include <math.h>
+
+/*********************************************************************************************************************/
+/*--------------------------------------------Function Implementations-----------------------------------------------*/
+/*********************************************************************************************************************/
+
+static void addWall(SilWorld *w, double x1, double y1, double x2, double y2)
+{
+    if (w->wallNum < SIL_MAX_WALLS)
+    {
+        w->walls[w->wallNum++] = (SilSegment){ x1, y1, x2, y2 };
+    }
+}
+
+/* Car starts at the origin heading +x. The wall runs along y = wallY with a
+ * rectangular bay cut into it; the bay is closed by two side walls and a back wall. */
+void silWorldBuild(SilWorld *w, const SilConfig *cfg, double gapShift)
+{
+    double wallY = cfg->width / 2.0 + cfg->wallClearance;
+    double x0 = cfg->wallStart;
+    double x3 = cfg->wallStart + cfg->wallLength;
+    double g0 = cfg->gapStart + gapShift;
+    double g1 = g0 + cfg->gapWidth;
+    double backY = wallY + cfg->gapDepth;
+
+    w->wallNum = 0;
+    addWall(w, x0, wallY, g0, wallY);
+    addWall(w, g0, wallY, g0, backY);
+    addWall(w, g0, backY, g1, backY);
+    addWall(w, g1, backY, g1, wallY);
+    addWall(w, g1, wallY, x3, wallY);
+
+    for (int i = 0; i < cfg->extraWallNum; i++)
+    {
+        const SilSegment *s = &cfg->extraWalls[i];
+        addWall(w, s->x1, s->y1, s->x2, s->y2);
+    }
+
+    w->bayX0 = g0;
+    w->bayX1 = g1;
+    w->bayY0 = wallY;
+    w->bayY1 = backY;
+}
+
+/* distance along the ray to the nearest wall, or maxRange if nothing is hit */
+double silWorldRaycast(const SilWorld *w, double x, double y, double dir, double maxRange)
+{
+    double dx = cos(dir);
+    double dy = sin(dir);
+    double best = maxRange;
+
+    for (int i = 0; i < w->wallNum; i++)
+    {
+        const SilSegment *s = &w->walls[i];
+        double ex = s->x2 - s->x1;
+        double ey = s->y2 - s->y1;
+        double den = dx * ey - dy * ex;
+        if (fabs(den) < 1e-12)
+        {
+            continue;
+        }
+        double qx = s->x1 - x;
+        double qy = s->y1 - y;
+        double t = (qx * ey - qy * ex) / den;   /* along the ray */
+        double u = (qx * dy - qy * dx) / den;   /* along the segment */
+        if (t >= 0.0 && u >= 0.0 && u <= 1.0 && t < best)
+        {
+            best = t;
+        }
+    }
+    return best;
+}
+
+void silFootprint(const SilConfig *cfg, const SilPose *p, double corners[4][2])
+{
+    static const double sx[4] = { 1, 1, -1, -1 };
+    static const double sy[4] = { 1, -1, -1, 1 };
+    double c = cos(p->theta);
+    double s = sin(p->theta);
+
+    for (int i = 0; i < 4; i++)
+    {
+        double lx = sx[i] * cfg->length / 2.0;
+        double ly = sy[i] * cfg->width / 2.0;
+        corners[i][0] = p->x + lx * c - ly * s;
+        corners[i][1] = p->y + lx * s + ly * c;
+    }
+}
+
+static int segmentsIntersect(double ax, double ay, double bx, double by,
+                             double cx, double cy, double dx, double dy)
+{
+    double d1 = (dx - cx) * (ay - cy) - (dy - cy) * (ax - cx);
+    double d2 = (dx - cx) * (by - cy) - (dy - cy) * (bx - cx);
+    double d3 = (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+    double d4 = (bx - ax) * (dy - ay) - (by - ay) * (dx - ax);
+    return ((d1 > 0) != (d2 > 0)) && ((d3 > 0) != (d4 > 0));
+}
+
+/* walls are thin, so an edge crossing is the only way to touch one */
+int silWorldCollides(const SilWorld *w, const double corners[4][2])
+{
+    for (int i = 0; i < w->wallNum; i++)
+    {
+        const SilSegment *s = &w->walls[i];
+        for (int e = 0; e < 4; e++)
+        {
+            const double *a = corners[e];
+            const double *b = corners[(e + 1) % 4];
+            if (segmentsIntersect(a[0], a[1], b[0], b[1], s->x1, s->y1, s->x2, s->y2))
+            {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
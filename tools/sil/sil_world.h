@@ -0,0 +1,34 @@
+/*
+ * sil_world.h
+ *
+ *  2D wall layout and the geometric queries the vehicle and sensor models need.
+ *  World frame: x along the wall, y to the left of the start heading.
+ */
+
+#ifndef SIL_WORLD_H_
+#define SIL_WORLD_H_
+
+#include "sil_config.h"
+
+#define SIL_MAX_WALLS (8 + SIL_MAX_EXTRA_WALLS)
+
+typedef struct
+{
+    double x, y, theta;
+} SilPose;
+
+typedef struct
+{
+    SilSegment walls[SIL_MAX_WALLS];
+    int wallNum;
+
+    /* parking bay: x in [bayX0, bayX1], y in [bayY0, bayY1], target heading -90 deg */
+    double bayX0, bayX1, bayY0, bayY1;
+} SilWorld;
+
+void silWorldBuild(SilWorld *w, const SilConfig *cfg, double gapShift);
+double silWorldRaycast(const SilWorld *w, double x, double y, double dir, double maxRange);
+void silFootprint(const SilConfig *cfg, const SilPose *p, double corners[4][2]);
+int silWorldCollides(const SilWorld *w, const double corners[4][2]);
+
+#endif /* SIL_WORLD_H_ */